@@ -0,0 +1,134 @@
+#include <maths/fixed.h>
+#include <maths/vec2x.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr float benchDt = 0.02f;
+    constexpr float benchMaxSpeed = 3.0f;
+
+    struct FloatBody
+    {
+        core::Vec2f position;
+        core::Vec2f velocity;
+        core::degree_t rotation = core::degree_t(0.0f);
+        core::degree_t angularVelocity = core::degree_t(0.0f);
+    };
+
+    struct FixedBody
+    {
+        core::Vec2x position;
+        core::Vec2x velocity;
+        core::FixedDegree rotation;
+        core::FixedDegree angularVelocity;
+    };
+
+    template<typename Body>
+    std::vector<Body> RandomBodies(std::size_t count)
+    {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+        std::vector<FloatBody> floatBodies(count);
+        for (auto& body : floatBodies)
+        {
+            body.position = core::Vec2f(distribution(generator), distribution(generator));
+            body.velocity = core::Vec2f(distribution(generator), distribution(generator)) * 0.3f;
+            body.rotation = core::degree_t(distribution(generator) * 18.0f);
+            body.angularVelocity = core::degree_t(distribution(generator) * 13.5f);
+        }
+        if constexpr (std::is_same_v<Body, FloatBody>)
+        {
+            return floatBodies;
+        }
+        else
+        {
+            std::vector<FixedBody> bodies(count);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                bodies[i].position = core::Vec2x(floatBodies[i].position);
+                bodies[i].velocity = core::Vec2x(floatBodies[i].velocity);
+                bodies[i].rotation = core::FixedDegree(floatBodies[i].rotation);
+                bodies[i].angularVelocity = core::FixedDegree(floatBodies[i].angularVelocity);
+            }
+            return bodies;
+        }
+    }
+}
+
+//Player step of the simulation: steering, acceleration, speed clamp and integration
+static void BM_FloatPlayerStep(benchmark::State& state)
+{
+    auto bodies = RandomBodies<FloatBody>(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        for (auto& body : bodies)
+        {
+            const auto dir = core::Vec2f::up().Rotate(-(body.rotation + body.angularVelocity * benchDt));
+            body.velocity += 1.5f * dir * benchDt;
+            if (body.velocity.GetMagnitude() >= benchMaxSpeed)
+            {
+                body.velocity = body.velocity.GetNormalized() * benchMaxSpeed;
+            }
+            body.position += body.velocity * benchDt;
+            body.rotation += body.angularVelocity * benchDt;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FloatPlayerStep)->Arg(16)->Arg(1024);
+
+static void BM_FixedPlayerStep(benchmark::State& state)
+{
+    auto bodies = RandomBodies<FixedBody>(static_cast<std::size_t>(state.range(0)));
+    const core::Fixed dt = benchDt;
+    const core::Fixed maxSpeed = benchMaxSpeed;
+    const core::Fixed acceleration = 1.5f;
+    for (auto _ : state)
+    {
+        for (auto& body : bodies)
+        {
+            const auto dir = core::Vec2x::up().Rotate(-(body.rotation + body.angularVelocity * dt));
+            body.velocity += acceleration * dir * dt;
+            if (body.velocity.GetMagnitude() >= maxSpeed)
+            {
+                body.velocity = body.velocity.GetNormalized() * maxSpeed;
+            }
+            body.position += body.velocity * dt;
+            body.rotation = core::FixedDegree(core::WrapDegrees((body.rotation + body.angularVelocity * dt).value()));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FixedPlayerStep)->Arg(16)->Arg(1024);
+
+static void BM_FloatSinCos(benchmark::State& state)
+{
+    float angle = 0.0f;
+    for (auto _ : state)
+    {
+        angle += 1.7f;
+        const core::degree_t degrees(angle);
+        benchmark::DoNotOptimize(core::Sin(degrees) + core::Cos(degrees));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FloatSinCos);
+
+static void BM_FixedSinCos(benchmark::State& state)
+{
+    core::Fixed angle;
+    const core::Fixed step = 1.7f;
+    for (auto _ : state)
+    {
+        angle += step;
+        const core::FixedDegree degrees(angle);
+        benchmark::DoNotOptimize(core::Sin(degrees) + core::Cos(degrees));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FixedSinCos);
@@ -0,0 +1,60 @@
+#include <engine/entity.h>
+#include <engine/component.h>
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    constexpr core::Component includeComponent = static_cast<core::Component>(core::ComponentType::BOXBODY2D);
+    constexpr core::Component excludeComponent = static_cast<core::Component>(core::ComponentType::OTHER_TYPE);
+
+    //One entity out of four has the component, one out of sixteen of them is excluded
+    void FillEntities(core::EntityManager& entityManager, std::size_t entityNmb)
+    {
+        for (const auto entity : entityManager.CreateEntities(entityNmb))
+        {
+            if (entity % 4 == 0)
+                entityManager.AddComponent(entity, includeComponent);
+            if (entity % 64 == 0)
+                entityManager.AddComponent(entity, excludeComponent);
+        }
+    }
+}
+
+static void BM_HasComponentLoop(benchmark::State& state)
+{
+    const auto entityNmb = static_cast<std::size_t>(state.range(0));
+    core::EntityManager entityManager(entityNmb);
+    FillEntities(entityManager, entityNmb);
+    for (auto _ : state)
+    {
+        core::Entity sum = 0;
+        for (core::Entity entity = 0; entity < entityManager.GetEntitiesSize(); entity++)
+        {
+            if (!entityManager.HasComponent(entity, includeComponent) || 
+                entityManager.HasComponent(entity, excludeComponent))
+                continue;
+            sum += entity;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HasComponentLoop)->Arg(128)->Arg(10'000)->Arg(100'000);
+
+static void BM_View(benchmark::State& state)
+{
+    const auto entityNmb = static_cast<std::size_t>(state.range(0));
+    core::EntityManager entityManager(entityNmb);
+    FillEntities(entityManager, entityNmb);
+    for (auto _ : state)
+    {
+        core::Entity sum = 0;
+        for (const auto entity : entityManager.GetView(includeComponent, excludeComponent))
+        {
+            sum += entity;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_View)->Arg(128)->Arg(10'000)->Arg(100'000);
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <engine/globals.h>
 #include <engine/entity.h>
+#include <engine/component_storage.h>
 
 namespace core
 {
@@ -19,13 +20,17 @@ namespace core
         OTHER_TYPE = 1u << 7u
     };
 
-    template<typename T, Component C>
+    /**
+     * \brief Manages one component type, Storage is DenseStorage, SparseSetStorage or PagedSparseSetStorage (see component_storage.h)
+     */
+    template<typename T, Component C, template<typename> class Storage = DenseStorage>
     class ComponentManager
     {
     public:
+        using Components = typename Storage<T>::Container;
+
         ComponentManager(EntityManager& entityManager) : entityManager_(entityManager)
         {
-            components_.resize(entityInitNmb);
         }
         virtual ~ComponentManager() = default;
 
@@ -42,61 +47,58 @@ namespace core
 
         void SetComponent(Entity entity, const T& value);
 
-        [[nodiscard]] const std::vector<T>& GetAllComponents() const;
-        void CopyAllComponents(const std::vector<T>& components);
+        [[nodiscard]] const Components& GetAllComponents() const;
+        void CopyAllComponents(const Components& components);
+        /**
+         * \brief Entities owning the component, only available with SparseSetStorage
+         */
+        [[nodiscard]] const std::vector<Entity>& GetEntities() const { return components_.GetEntities(); }
     protected:
         EntityManager& entityManager_;
-        std::vector<T> components_;
+        Storage<T> components_;
     };
 
-    template <typename T, Component C>
-    void ComponentManager<T, C>::AddComponent(Entity entity)
+    template <typename T, Component C, template<typename> class Storage>
+    void ComponentManager<T, C, Storage>::AddComponent(Entity entity)
     {
-        // Resize components array if too small
-        auto currentSize = components_.size();
-        while (entity >= currentSize)
-        {
-            auto newSize = currentSize + currentSize / 2;
-            components_.resize(newSize);
-            currentSize = newSize;
-        }
-
+        components_.Add(entity);
         entityManager_.AddComponent(entity, C);
     }
 
-    template <typename T, Component C>
-    void ComponentManager<T, C>::RemoveComponent(Entity entity)
+    template <typename T, Component C, template<typename> class Storage>
+    void ComponentManager<T, C, Storage>::RemoveComponent(Entity entity)
     {
+        components_.Remove(entity);
         entityManager_.RemoveComponent(entity, C);
     }
 
-    template <typename T, Component C>
-    const T& ComponentManager<T, C>::GetComponent(Entity entity) const
+    template <typename T, Component C, template<typename> class Storage>
+    const T& ComponentManager<T, C, Storage>::GetComponent(Entity entity) const
     {
         return components_[entity];
     }
 
-    template <typename T, Component C>
-    T& ComponentManager<T, C>::GetComponent(Entity entity)
+    template <typename T, Component C, template<typename> class Storage>
+    T& ComponentManager<T, C, Storage>::GetComponent(Entity entity)
     {
         return components_[entity];
     }
 
-    template <typename T, Component C>
-    void ComponentManager<T, C>::SetComponent(Entity entity, const T& value)
+    template <typename T, Component C, template<typename> class Storage>
+    void ComponentManager<T, C, Storage>::SetComponent(Entity entity, const T& value)
     {
-        components_[entity] = value;
+        components_.Set(entity, value);
     }
 
-    template <typename T, Component C>
-    const std::vector<T>& ComponentManager<T, C>::GetAllComponents() const
+    template <typename T, Component C, template<typename> class Storage>
+    const typename ComponentManager<T, C, Storage>::Components& ComponentManager<T, C, Storage>::GetAllComponents() const
     {
-        return components_;
+        return components_.GetAll();
     }
 
-    template <typename T, Component C>
-    void ComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components)
+    template <typename T, Component C, template<typename> class Storage>
+    void ComponentManager<T, C, Storage>::CopyAllComponents(const Components& components)
     {
-        components_ = components;
+        components_.CopyAll(components);
     }
 } // namespace core
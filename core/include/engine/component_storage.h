@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include <engine/entity.h>
+#include <engine/globals.h>
+#include <engine/paged_array.h>
+
+namespace core
+{
+    /**
+     * \brief Component storage policy with one component per entity slot, indexed directly by the entity
+     */
+    template<typename T>
+    class DenseStorage
+    {
+    public:
+        using Container = std::vector<T>;
+
+        DenseStorage()
+        {
+            components_.resize(entityInitNmb);
+        }
+
+        void Add(Entity entity)
+        {
+            // Resize components array if too small
+            auto currentSize = components_.size();
+            while (entity >= currentSize)
+            {
+                auto newSize = currentSize + currentSize / 2;
+                components_.resize(newSize);
+                currentSize = newSize;
+            }
+        }
+        void Remove([[maybe_unused]] Entity entity) {}
+
+        [[nodiscard]] const T& operator[](Entity entity) const { return components_[entity]; }
+        [[nodiscard]] T& operator[](Entity entity) { return components_[entity]; }
+        void Set(Entity entity, const T& value) { components_[entity] = value; }
+
+        [[nodiscard]] const std::vector<T>& GetAll() const { return components_; }
+        void CopyAll(const std::vector<T>& components) { components_ = components; }
+    private:
+        std::vector<T> components_;
+    };
+
+    /**
+     * \brief Sorted packed list of entities with an entity->index map, used by the packed component storages.
+     * Adding and removing is O(n) in the number of entities and is meant for spawn time only.
+     */
+    class SparseSet
+    {
+    public:
+        /**
+         * \return the packed index the entity was inserted at, or INVALID_INDEX if it was already in the set
+         */
+        std::size_t Add(Entity entity)
+        {
+            if (entity >= indices_.size())
+            {
+                indices_.resize(std::max<std::size_t>(entity + 1, indices_.size() + indices_.size() / 2), INVALID_INDEX);
+            }
+            if (indices_[entity] != INVALID_INDEX)
+                return INVALID_INDEX;
+            const auto it = std::lower_bound(entities_.begin(), entities_.end(), entity);
+            const auto index = static_cast<std::size_t>(std::distance(entities_.begin(), it));
+            entities_.insert(it, entity);
+            UpdateIndices(index);
+            return index;
+        }
+        /**
+         * \return the packed index the entity was removed from, or INVALID_INDEX if it was not in the set
+         */
+        std::size_t Remove(Entity entity)
+        {
+            if (!Contains(entity))
+                return INVALID_INDEX;
+            const auto index = indices_[entity];
+            indices_[entity] = INVALID_INDEX;
+            entities_.erase(entities_.begin() + static_cast<std::ptrdiff_t>(index));
+            UpdateIndices(index);
+            return index;
+        }
+        [[nodiscard]] bool Contains(Entity entity) const
+        {
+            return entity < indices_.size() && indices_[entity] != INVALID_INDEX;
+        }
+        [[nodiscard]] std::size_t GetIndex(Entity entity) const { return indices_[entity]; }
+        /**
+         * \brief Entities of the set, in increasing order
+         */
+        [[nodiscard]] const std::vector<Entity>& GetEntities() const { return entities_; }
+        [[nodiscard]] std::size_t GetSize() const { return entities_.size(); }
+
+        static constexpr std::size_t INVALID_INDEX = std::numeric_limits<std::size_t>::max();
+    private:
+        void UpdateIndices(std::size_t firstIndex)
+        {
+            for (auto i = firstIndex; i < entities_.size(); i++)
+            {
+                indices_[entities_[i]] = i;
+            }
+        }
+
+        std::vector<Entity> entities_;
+        std::vector<std::size_t> indices_;
+    };
+
+    /**
+     * \brief Component storage policy packing the components of the entities that own one.
+     * The packed array follows the SparseSet order so iteration visits the entities in the same order as DenseStorage.
+     */
+    template<typename T>
+    class SparseSetStorage
+    {
+    public:
+        using Container = std::vector<T>;
+
+        void Add(Entity entity)
+        {
+            const auto index = sparseSet_.Add(entity);
+            if (index == SparseSet::INVALID_INDEX)
+                return;
+            components_.insert(components_.begin() + static_cast<std::ptrdiff_t>(index), T{});
+        }
+        void Remove(Entity entity)
+        {
+            const auto index = sparseSet_.Remove(entity);
+            if (index == SparseSet::INVALID_INDEX)
+                return;
+            components_.erase(components_.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+
+        [[nodiscard]] bool Contains(Entity entity) const { return sparseSet_.Contains(entity); }
+        /**
+         * \brief The entity must own the component, the packed storages have no slot for the other entities
+         */
+        [[nodiscard]] const T& operator[](Entity entity) const
+        {
+            assert(Contains(entity));
+            return components_[sparseSet_.GetIndex(entity)];
+        }
+        [[nodiscard]] T& operator[](Entity entity)
+        {
+            assert(Contains(entity));
+            return components_[sparseSet_.GetIndex(entity)];
+        }
+        void Set(Entity entity, const T& value)
+        {
+            assert(Contains(entity));
+            components_[sparseSet_.GetIndex(entity)] = value;
+        }
+
+        /**
+         * \brief Entities owning a component, in increasing order and in the same order as GetAll
+         */
+        [[nodiscard]] const std::vector<Entity>& GetEntities() const { return sparseSet_.GetEntities(); }
+        [[nodiscard]] const std::vector<T>& GetAll() const { return components_; }
+        /**
+         * \brief Copies packed components, the source must have been taken from a storage with the same entities
+         */
+        void CopyAll(const std::vector<T>& components)
+        {
+            assert(components.size() == components_.size());
+            components_ = components;
+        }
+    private:
+        std::vector<T> components_;
+        SparseSet sparseSet_;
+    };
+
+    /**
+     * \brief SparseSetStorage with the packed components in a PagedArray, copying all the components shares their pages
+     * and only the pages written afterward are duplicated. Meant for the rollback states copied every frame.
+     */
+    template<typename T>
+    class PagedSparseSetStorage
+    {
+    public:
+        using Container = PagedArray<T>;
+
+        void Add(Entity entity)
+        {
+            const auto index = sparseSet_.Add(entity);
+            if (index == SparseSet::INVALID_INDEX)
+                return;
+            components_.Insert(index, T{});
+        }
+        void Remove(Entity entity)
+        {
+            const auto index = sparseSet_.Remove(entity);
+            if (index == SparseSet::INVALID_INDEX)
+                return;
+            components_.Erase(index);
+        }
+
+        [[nodiscard]] bool Contains(Entity entity) const { return sparseSet_.Contains(entity); }
+        [[nodiscard]] const T& operator[](Entity entity) const
+        {
+            assert(Contains(entity));
+            return components_[sparseSet_.GetIndex(entity)];
+        }
+        /**
+         * \brief Duplicates the page of the component if it is shared, prefer the const access to read
+         */
+        [[nodiscard]] T& operator[](Entity entity)
+        {
+            assert(Contains(entity));
+            return components_[sparseSet_.GetIndex(entity)];
+        }
+        /**
+         * \brief Keeps the page shared if the component does not change
+         */
+        void Set(Entity entity, const T& value)
+        {
+            assert(Contains(entity));
+            components_.Set(sparseSet_.GetIndex(entity), value);
+        }
+
+        [[nodiscard]] const std::vector<Entity>& GetEntities() const { return sparseSet_.GetEntities(); }
+        [[nodiscard]] const PagedArray<T>& GetAll() const { return components_; }
+        void CopyAll(const PagedArray<T>& components)
+        {
+            assert(components.size() == components_.size());
+            components_ = components;
+        }
+    private:
+        PagedArray<T> components_;
+        SparseSet sparseSet_;
+    };
+} // namespace core
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <bit>
 #include <cstdint>
+#include <iterator>
 #include <vector>
 #include <limits>
 
@@ -9,9 +11,17 @@ namespace core
     
 using Entity = std::uint32_t;
 using EntityMask = std::uint32_t;
+/**
+ * \brief Packed entity index (low 20 bits) and generation (high 12 bits), a stale handle only aliases a reused entity
+ * after 4096 destructions of the same entity
+ */
+using EntityHandle = std::uint32_t;
+
+class View;
 
 /**
  * \brief Manages the entities in an array using bitwise operations to know if it has components.
+ * Free entities are kept in an intrusive free list stored in the handle array, so create and destroy are O(1).
  */
 class EntityManager
 {
@@ -20,6 +30,10 @@ public:
     EntityManager(std::size_t reservedSize);
 
     Entity CreateEntity();
+    /**
+     * \brief Creates count entities with at most one resize of the entity array
+     */
+    std::vector<Entity> CreateEntities(std::size_t count);
     void DestroyEntity(Entity entity);
     // Normally called by ComponentManager
     void AddComponent(Entity entity, EntityMask mask);
@@ -28,12 +42,123 @@ public:
     [[nodiscard]] bool HasComponent(Entity entity, EntityMask mask) const;
     [[nodiscard]] bool EntityExists(Entity entity) const;
 
+    [[nodiscard]] EntityHandle GetHandle(Entity entity) const;
+    /**
+     * \brief Checks that the entity of the handle exists and was not destroyed since the handle was taken
+     */
+    [[nodiscard]] bool IsAlive(EntityHandle handle) const;
+    [[nodiscard]] static constexpr Entity GetEntity(EntityHandle handle) { return handle & entityIndexMask; }
+    [[nodiscard]] static constexpr std::uint32_t GetGeneration(EntityHandle handle) { return handle >> entityIndexBits; }
+
     [[nodiscard]] std::size_t GetEntitiesSize() const;
+    /**
+     * \brief Entities having all the include components and none of the exclude ones, starting at firstEntity
+     */
+    [[nodiscard]] View GetView(EntityMask include, EntityMask exclude = INVALID_ENTITY_MASK, Entity firstEntity = 0) const;
 
     static constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
     static constexpr EntityMask INVALID_ENTITY_MASK = 0u;
+    static constexpr EntityHandle INVALID_HANDLE = std::numeric_limits<EntityHandle>::max();
+    static constexpr std::uint32_t entityIndexBits = 20u;
+    /**
+     * \brief Also the index ending the free list, it is never given to an entity so no handle is INVALID_HANDLE
+     */
+    static constexpr EntityHandle entityIndexMask = (1u << entityIndexBits) - 1u;
+    static constexpr std::uint32_t entityGenerationMask = INVALID_HANDLE >> entityIndexBits;
 private:
+    friend class View;
+    void Grow(std::size_t newSize);
+
     std::vector<EntityMask> entityMasks_;
+    //Handle of the living entities, for free entities the index part links to the next free entity
+    std::vector<EntityHandle> entityHandles_;
+    Entity freeEntity_ = entityIndexMask;
+    Entity lastFreeEntity_ = entityIndexMask;
+    std::size_t freeEntityCount_ = 0;
+};
+
+/**
+ * \brief Iterates over the entities matching an include and an exclude mask.
+ * Masks are compared a block at a time with SSE2 or AVX2 when available. A block is scanned when the iterator reaches it,
+ * so changing the masks of the next entities of the current block during the iteration is not seen.
+ */
+class View
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entity*;
+        using reference = Entity;
+
+        Iterator() = default;
+        Iterator(const View* view, Entity firstEntity) : view_(view), blockBegin_(firstEntity - firstEntity % blockSize)
+        {
+            if (blockBegin_ >= view_->entityManager_->GetEntitiesSize())
+                return;
+            //Ignore the entities of the first block before firstEntity
+            blockMatches_ = view_->ScanBlock(blockBegin_) & (~0u << (firstEntity - blockBegin_));
+            NextMatch();
+        }
+        Entity operator*() const { return entity_; }
+        Iterator& operator++()
+        {
+            NextMatch();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            auto it = *this;
+            NextMatch();
+            return it;
+        }
+        bool operator==(const Iterator& other) const { return entity_ == other.entity_; }
+    private:
+        void NextMatch()
+        {
+            const auto size = view_->entityManager_->GetEntitiesSize();
+            while (blockMatches_ == 0)
+            {
+                blockBegin_ += blockSize;
+                if (blockBegin_ >= size)
+                {
+                    entity_ = EntityManager::INVALID_ENTITY;
+                    return;
+                }
+                blockMatches_ = view_->ScanBlock(blockBegin_);
+            }
+            entity_ = static_cast<Entity>(blockBegin_ + std::countr_zero(blockMatches_));
+            blockMatches_ &= blockMatches_ - 1;
+        }
+
+        const View* view_ = nullptr;
+        std::size_t blockBegin_ = 0;
+        std::uint32_t blockMatches_ = 0;
+        Entity entity_ = EntityManager::INVALID_ENTITY;
+    };
+
+    View(const EntityManager& entityManager, EntityMask include, EntityMask exclude, Entity firstEntity) :
+        entityManager_(&entityManager), include_(include), exclude_(exclude), firstEntity_(firstEntity)
+    {
+    }
+    [[nodiscard]] Iterator begin() const { return Iterator(this, firstEntity_); }
+    [[nodiscard]] Iterator end() const { return Iterator(); }
+
+    /**
+     * \brief Returns one bit per matching mask of masks[0..blockSize)
+     */
+    [[nodiscard]] static std::uint32_t MatchBlock(const EntityMask* masks, EntityMask include, EntityMask exclude);
+    static constexpr std::size_t blockSize = 8;
+private:
+    [[nodiscard]] std::uint32_t ScanBlock(std::size_t blockBegin) const;
+
+    const EntityManager* entityManager_;
+    EntityMask include_;
+    EntityMask exclude_;
+    Entity firstEntity_;
 };
 
 } // namespace core
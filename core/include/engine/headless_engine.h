@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/System/Time.hpp>
+
+namespace core
+{
+class SystemInterface;
+
+struct TickStats
+{
+    std::uint64_t tickCount = 0;
+    /**
+     * \brief Number of ticks that ended after the next tick deadline
+     */
+    std::uint64_t overrunCount = 0;
+    std::chrono::microseconds maxOverrun{ 0 };
+    std::chrono::microseconds totalOverrun{ 0 };
+};
+
+/**
+ * \brief Runs SystemInterface instances at a fixed tick rate without any window, draw or ImGui interfaces.
+ * Used by servers, bots and benchmarks on machines without a display.
+ */
+class HeadlessEngine
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit HeadlessEngine(float tickRate = 50.0f);
+    virtual ~HeadlessEngine() = default;
+
+    void Run();
+    /**
+     * \brief Ends Run after the current tick, can be called by a system
+     */
+    void Stop() { running_ = false; }
+
+    void RegisterSystem(SystemInterface*);
+
+    void SetTickRate(float tickRate);
+    [[nodiscard]] float GetTickRate() const { return tickRate_; }
+    /**
+     * \brief Number of ticks after which Run returns, 0 runs until Stop is called
+     */
+    void SetRunLimit(std::uint64_t tickLimit) { tickLimit_ = tickLimit; }
+    /**
+     * \brief When disabled, the ticks are not paced on the clock and run as fast as possible (benchmarks, replays)
+     */
+    void SetRealTime(bool realTime) { realTime_ = realTime; }
+    [[nodiscard]] std::uint64_t GetTickCount() const { return stats_.tickCount; }
+    /**
+     * \brief Overruns are only measured in real time
+     */
+    [[nodiscard]] const TickStats& GetStats() const { return stats_; }
+protected:
+    void Init();
+    void Update(sf::Time dt);
+    void Destroy();
+    /**
+     * \brief Waits for the deadline of the next tick in real time, sleeps by default
+     */
+    virtual void WaitUntil(Clock::time_point deadline);
+
+    std::vector<SystemInterface*> systems_;
+    float tickRate_ = 50.0f;
+    std::uint64_t tickLimit_ = 0;
+    TickStats stats_;
+    bool realTime_ = true;
+    bool running_ = false;
+};
+
+} // namespace core
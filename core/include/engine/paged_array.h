@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+    /**
+     * \brief Array stored in fixed size pages that the copies share by reference count (copy-on-write).
+     * Copying the array only copies the page pointers, a page is duplicated the first time it is written
+     * while another copy still holds it, so a snapshot costs the size of the data written since the last one.
+     * Reading goes through the const accessors, the non const ones duplicate the page.
+     * The released pages go back to a pool shared by the copies, steady state copies and writes do not allocate.
+     * The reference counts are not atomic, an array and its copies must stay on one thread.
+     */
+    template<typename T, std::size_t PageSize = 64>
+    class PagedArray
+    {
+    public:
+        static constexpr std::size_t pageSize = PageSize;
+
+        PagedArray() = default;
+        PagedArray(const PagedArray& other) : pages_(other.pages_), size_(other.size_), pool_(other.pool_)
+        {
+            for (auto* page : pages_)
+            {
+                page->refCount++;
+            }
+        }
+        PagedArray(PagedArray&& other) noexcept :
+            pages_(std::move(other.pages_)), size_(std::exchange(other.size_, 0)), pool_(std::move(other.pool_))
+        {
+            other.pages_.clear();
+        }
+        /**
+         * \brief Only copies the page pointers, the pages both arrays already share are not even touched
+         */
+        PagedArray& operator=(const PagedArray& other)
+        {
+            if (this == &other)
+                return *this;
+            const auto commonPageCount = std::min(pages_.size(), other.pages_.size());
+            for (std::size_t pageIndex = 0; pageIndex < commonPageCount; pageIndex++)
+            {
+                auto*& page = pages_[pageIndex];
+                if (page != other.pages_[pageIndex])
+                {
+                    other.pages_[pageIndex]->refCount++;
+                    ReleasePage(page);
+                    page = other.pages_[pageIndex];
+                }
+            }
+            for (auto pageIndex = commonPageCount; pageIndex < pages_.size(); pageIndex++)
+            {
+                ReleasePage(pages_[pageIndex]);
+            }
+            pages_.resize(commonPageCount);
+            for (auto pageIndex = commonPageCount; pageIndex < other.pages_.size(); pageIndex++)
+            {
+                other.pages_[pageIndex]->refCount++;
+                pages_.push_back(other.pages_[pageIndex]);
+            }
+            size_ = other.size_;
+            pool_ = other.pool_;
+            return *this;
+        }
+        PagedArray& operator=(PagedArray&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            ReleasePages();
+            pages_ = std::move(other.pages_);
+            other.pages_.clear();
+            size_ = std::exchange(other.size_, 0);
+            pool_ = std::move(other.pool_);
+            return *this;
+        }
+        ~PagedArray()
+        {
+            ReleasePages();
+        }
+
+        [[nodiscard]] std::size_t size() const { return size_; }
+        [[nodiscard]] bool empty() const { return size_ == 0; }
+        [[nodiscard]] std::size_t GetPageCount() const { return pages_.size(); }
+        /**
+         * \brief Number of used values of the page, only the last page is not full
+         */
+        [[nodiscard]] std::size_t GetPageSize(std::size_t pageIndex) const
+        {
+            return pageIndex + 1 < pages_.size() ? PageSize : size_ - pageIndex * PageSize;
+        }
+
+        [[nodiscard]] const T& operator[](std::size_t index) const { return pages_[index / PageSize]->values[index % PageSize]; }
+        [[nodiscard]] T& operator[](std::size_t index) { return WritePage(index / PageSize)[index % PageSize]; }
+        [[nodiscard]] const T* GetPage(std::size_t pageIndex) const { return pages_[pageIndex]->values.data(); }
+        /**
+         * \brief Page data to write to, duplicated first if another copy holds it
+         */
+        T* WritePage(std::size_t pageIndex)
+        {
+            auto*& page = pages_[pageIndex];
+            if (page->refCount > 1)
+            {
+                auto* copy = pool_->Acquire();
+                copy->values = page->values;
+                page->refCount--;
+                page = copy;
+            }
+            return page->values.data();
+        }
+        /**
+         * \brief Writes the value only if it differs, so that an unchanged value keeps its page shared
+         */
+        void Set(std::size_t index, const T& value)
+        {
+            if (!IsSameValue(std::as_const(*this)[index], value))
+            {
+                WritePage(index / PageSize)[index % PageSize] = value;
+            }
+        }
+        /**
+         * \brief Inserts by shifting the next values, meant for spawn time only
+         */
+        void Insert(std::size_t index, const T& value)
+        {
+            assert(index <= size_);
+            if (size_ == pages_.size() * PageSize)
+            {
+                if (pool_ == nullptr)
+                {
+                    pool_ = std::make_shared<PagePool>();
+                }
+                pages_.push_back(pool_->Acquire());
+            }
+            size_++;
+            for (auto i = size_ - 1; i > index; i--)
+            {
+                Set(i, std::as_const(*this)[i - 1]);
+            }
+            Set(index, value);
+        }
+        /**
+         * \brief Erases by shifting the next values, meant for spawn time only
+         */
+        void Erase(std::size_t index)
+        {
+            assert(index < size_);
+            for (auto i = index; i + 1 < size_; i++)
+            {
+                Set(i, std::as_const(*this)[i + 1]);
+            }
+            size_--;
+            if (size_ == (pages_.size() - 1) * PageSize)
+            {
+                ReleasePage(pages_.back());
+                pages_.pop_back();
+            }
+        }
+        /**
+         * \return true if the page is held by another copy too
+         */
+        [[nodiscard]] bool IsPageShared(std::size_t pageIndex) const { return pages_[pageIndex]->refCount > 1; }
+    private:
+        struct Page
+        {
+            std::array<T, PageSize> values{};
+            std::size_t refCount = 0;
+            Page* nextFree = nullptr;
+        };
+
+        /**
+         * \brief Free list of the released pages, every page of an array comes from the pool of the array
+         */
+        class PagePool
+        {
+        public:
+            PagePool() = default;
+            PagePool(const PagePool&) = delete;
+            PagePool& operator=(const PagePool&) = delete;
+            ~PagePool()
+            {
+                while (freePages_ != nullptr)
+                {
+                    delete std::exchange(freePages_, freePages_->nextFree);
+                }
+            }
+            Page* Acquire()
+            {
+                auto* page = freePages_ != nullptr ? std::exchange(freePages_, freePages_->nextFree) : new Page();
+                page->refCount = 1;
+                return page;
+            }
+            void Release(Page* page)
+            {
+                page->nextFree = freePages_;
+                freePages_ = page;
+            }
+        private:
+            Page* freePages_ = nullptr;
+        };
+
+        static bool IsSameValue(const T& value1, const T& value2)
+        {
+            //Compared bit for bit, -0.0f and 0.0f are not the same state
+            if constexpr (std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>)
+            {
+                return std::memcmp(&value1, &value2, sizeof(T)) == 0;
+            }
+            else if constexpr (std::equality_comparable<T>)
+            {
+                return value1 == value2;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        void ReleasePage(Page* page)
+        {
+            if (--page->refCount == 0)
+            {
+                pool_->Release(page);
+            }
+        }
+        void ReleasePages()
+        {
+            for (auto* page : pages_)
+            {
+                ReleasePage(page);
+            }
+            pages_.clear();
+        }
+
+        std::vector<Page*> pages_;
+        std::size_t size_ = 0;
+        //Shared by the copies, the pages go back to it as long as one of them holds it
+        std::shared_ptr<PagePool> pool_;
+    };
+} // namespace core
@@ -13,9 +13,10 @@ namespace core
     /**
      * \brief Manages sprites, order by greater entity index, background entity < foreground entity
      * Positions are centered at the center of the render target and use pixelPerMeter from globals.h
+     * Sprites are stored in a sparse set so Draw only visits the entities with a sprite
      */
     class SpriteManager :
-        public ComponentManager<sf::Sprite, static_cast<Component>(ComponentType::SPRITE)>,
+        public ComponentManager<sf::Sprite, static_cast<Component>(ComponentType::SPRITE), SparseSetStorage>,
         public DrawInterface
     {
     public:
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+
+#include <maths/angle.h>
+
+namespace core
+{
+/**
+ * \brief Q16.16 fixed point number.
+ * Every operation is integer arithmetic, so the results are the same bit for bit whatever the compiler,
+ * the flags (-ffast-math, FMA contraction) or the CPU. The range is about +-32767 with a precision of 1/65536.
+ */
+class Fixed
+{
+public:
+    static constexpr int fractionBits = 16;
+    static constexpr std::int32_t one = 1 << fractionBits;
+
+    constexpr Fixed() = default;
+    template<std::integral T>
+    constexpr Fixed(T value) : raw_(static_cast<std::int32_t>(value) * one)
+    {
+    }
+    /**
+     * \brief Rounds to the nearest fixed point value, the conversion itself is exact and deterministic
+     */
+    constexpr Fixed(float value) :
+        raw_(static_cast<std::int32_t>(value * static_cast<float>(one) + (value >= 0.0f ? 0.5f : -0.5f)))
+    {
+    }
+    static constexpr Fixed FromRaw(std::int32_t raw)
+    {
+        Fixed fixed;
+        fixed.raw_ = raw;
+        return fixed;
+    }
+
+    [[nodiscard]] constexpr std::int32_t GetRaw() const { return raw_; }
+    [[nodiscard]] constexpr float ToFloat() const { return static_cast<float>(raw_) / static_cast<float>(one); }
+
+    constexpr Fixed operator-() const { return FromRaw(-raw_); }
+    constexpr Fixed& operator+=(Fixed other)
+    {
+        raw_ += other.raw_;
+        return *this;
+    }
+    constexpr Fixed& operator-=(Fixed other)
+    {
+        raw_ -= other.raw_;
+        return *this;
+    }
+    constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(a.raw_ + b.raw_); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(a.raw_ - b.raw_); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b)
+    {
+        return FromRaw(static_cast<std::int32_t>((static_cast<std::int64_t>(a.raw_) * b.raw_) >> fractionBits));
+    }
+    /**
+     * \brief A division by zero saturates to the largest value of the sign of a, 0 / 0 gives 0
+     */
+    friend constexpr Fixed operator/(Fixed a, Fixed b)
+    {
+        if (b.raw_ == 0)
+        {
+            return FromRaw(a.raw_ > 0 ? std::numeric_limits<std::int32_t>::max() :
+                a.raw_ < 0 ? std::numeric_limits<std::int32_t>::min() : 0);
+        }
+        return FromRaw(static_cast<std::int32_t>((static_cast<std::int64_t>(a.raw_) * one) / b.raw_));
+    }
+    friend constexpr bool operator==(const Fixed& a, const Fixed& b) = default;
+    friend constexpr std::strong_ordering operator<=>(const Fixed& a, const Fixed& b) = default;
+private:
+    std::int32_t raw_ = 0;
+};
+
+/**
+ * \brief Angle in degrees as a fixed point number, the simulation counterpart of degree_t
+ */
+class FixedDegree
+{
+public:
+    constexpr FixedDegree() = default;
+    constexpr explicit FixedDegree(Fixed value) : value_(value) {}
+    constexpr explicit FixedDegree(degree_t angle) : value_(angle.value()) {}
+
+    [[nodiscard]] constexpr Fixed value() const { return value_; }
+
+    constexpr FixedDegree operator-() const { return FixedDegree(-value_); }
+    constexpr FixedDegree& operator+=(FixedDegree other)
+    {
+        value_ += other.value_;
+        return *this;
+    }
+    friend constexpr FixedDegree operator+(FixedDegree a, FixedDegree b) { return FixedDegree(a.value_ + b.value_); }
+    friend constexpr FixedDegree operator-(FixedDegree a, FixedDegree b) { return FixedDegree(a.value_ - b.value_); }
+    friend constexpr FixedDegree operator*(FixedDegree angle, Fixed f) { return FixedDegree(angle.value_ * f); }
+    friend constexpr bool operator==(const FixedDegree& a, const FixedDegree& b) = default;
+    friend constexpr std::strong_ordering operator<=>(const FixedDegree& a, const FixedDegree& b) = default;
+private:
+    Fixed value_;
+};
+
+/**
+ * \brief Floor of the square root
+ */
+std::uint64_t IntegerSqrt(std::uint64_t value);
+/**
+ * \brief Square root rounded down to the fixed point precision, 0 for negative values
+ */
+Fixed Sqrt(Fixed value);
+/**
+ * \brief Sine interpolated in a quarter wave table of 256 steps, the table is computed with integers at compile time
+ */
+Fixed Sin(FixedDegree angle);
+Fixed Cos(FixedDegree angle);
+/**
+ * \brief Same angle in [0, 360), the accumulated rotations would overflow the range of Q16.16 after 91 turns
+ */
+Fixed WrapDegrees(Fixed degrees);
+
+//Overloads for both float and Fixed, so that the simulation code is written once for both
+inline float ToFloat(float value) { return value; }
+constexpr float ToFloat(Fixed value) { return value.ToFloat(); }
+inline degree_t ToDegree(degree_t angle) { return angle; }
+inline degree_t ToDegree(FixedDegree angle) { return degree_t(angle.value().ToFloat()); }
+inline std::int32_t FloorToInt(float value) { return static_cast<std::int32_t>(std::floor(value)); }
+constexpr std::int32_t FloorToInt(Fixed value) { return value.GetRaw() >> Fixed::fractionBits; }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <maths/fixed.h>
+#include <maths/vec2.h>
+
+namespace core
+{
+
+/**
+ * \brief Fixed point counterpart of Vec2f for the deterministic simulation
+ */
+struct Vec2x
+{
+    Fixed x, y;
+
+    constexpr Vec2x() = default;
+    constexpr Vec2x(Fixed newX, Fixed newY) : x(newX), y(newY)
+    {
+
+    }
+    explicit Vec2x(Vec2f v);
+
+    /**
+     * \brief Computed on 64 bits, it does not overflow like GetSqrMagnitude for vectors longer than 181
+     */
+    [[nodiscard]] Fixed GetMagnitude() const;
+    void Normalize();
+    /**
+     * \brief The zero vector stays zero instead of dividing by zero
+     */
+    [[nodiscard]] Vec2x GetNormalized() const;
+    [[nodiscard]] Fixed GetSqrMagnitude() const;
+    [[nodiscard]] Vec2x Rotate(FixedDegree rotation) const;
+    static Fixed Dot(Vec2x a, Vec2x b);
+    static Vec2x Lerp(Vec2x a, Vec2x b, Fixed t);
+    [[nodiscard]] Vec2f ToVec2f() const;
+
+    Vec2x operator+(Vec2x v) const;
+    Vec2x& operator+=(Vec2x v);
+    Vec2x operator-(Vec2x v) const;
+    Vec2x& operator-=(Vec2x v);
+    Vec2x operator*(Fixed f) const;
+    Vec2x operator/(Fixed f) const;
+
+    static constexpr Vec2x zero() { return Vec2x(); }
+    static constexpr Vec2x one() { return Vec2x(1, 1); }
+    static constexpr Vec2x up() { return Vec2x(0, 1); }
+    static constexpr Vec2x down() { return Vec2x(0, -1); }
+    static constexpr Vec2x left() { return Vec2x(-1, 0); }
+    static constexpr Vec2x right() { return Vec2x(1, 0); }
+};
+
+Vec2x operator*(Fixed f, Vec2x v);
+
+inline Vec2f ToVec2f(Vec2f v) { return v; }
+inline Vec2f ToVec2f(Vec2x v) { return v.ToVec2f(); }
+
+}
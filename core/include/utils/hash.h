@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Streaming 64 bit xxHash64.
+ * Four independent lanes consume 32 byte stripes so the compiler can keep them in vector registers.
+ * The input is read as little endian words, like on every platform the game runs on.
+ */
+class Hasher
+{
+public:
+    explicit Hasher(std::uint64_t seed = 0);
+
+    void Update(const void* data, std::size_t size);
+    /**
+     * \brief Hashes the bytes of the values, the type must not have padding
+     */
+    template<typename T>
+    void Update(const std::vector<T>& values)
+    {
+        static_assert(std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>);
+        Update(values.data(), values.size() * sizeof(T));
+    }
+    template<typename T>
+    void UpdateValue(T value)
+    {
+        static_assert(std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>);
+        Update(&value, sizeof(T));
+    }
+    /**
+     * \brief Hash of everything given so far, more data can still be added afterward
+     */
+    [[nodiscard]] std::uint64_t Digest() const;
+private:
+    static constexpr std::size_t stripeSize = 32;
+
+    void ConsumeStripe(const std::uint8_t* stripe);
+
+    std::uint64_t seed_;
+    std::array<std::uint64_t, 4> lanes_{};
+    std::array<std::uint8_t, stripeSize> buffer_{};
+    std::size_t bufferSize_ = 0;
+    std::uint64_t totalSize_ = 0;
+};
+
+/**
+ * \brief One shot xxHash64
+ */
+std::uint64_t Hash64(const void* data, std::size_t size, std::uint64_t seed = 0);
+}
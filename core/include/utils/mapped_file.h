@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace core
+{
+/**
+ * \brief Read only memory mapping of a whole file.
+ * The pages are only loaded when they are read, and ReleasePages gives back the ones already read,
+ * so a file much bigger than the memory can be streamed through the mapping.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * \brief Maps the file, hinting the system that it will be read sequentially
+     * \return false if the file is missing, empty or cannot be mapped
+     */
+    bool Open(const std::string& path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+    [[nodiscard]] const std::uint8_t* GetData() const { return data_; }
+    [[nodiscard]] std::size_t GetSize() const { return size_; }
+    /**
+     * \brief Drops the loaded pages from the one holding offset to the one before offset + size,
+     * they are loaded again if read afterward
+     */
+    void ReleasePages(std::size_t offset, std::size_t size) const;
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace core
+{
+/**
+ * \brief Bounded lock-free queue with exactly one producer thread and one consumer thread.
+ * Used to pass messages between threads without a mutex on the hot path.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    /**
+     * \param capacity rounded up to the next power of two
+     */
+    explicit SpscQueue(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1u;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    /**
+     * \brief Producer side
+     * \return false if the queue is full, value is left untouched
+     */
+    bool Push(T&& value)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots_.size())
+            return false;
+        slots_[head & mask_] = std::move(value);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Consumer side
+     * \return false if the queue is empty
+     */
+    bool Pop(T& value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        value = std::move(slots_[tail & mask_]);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t GetCapacity() const { return slots_.size(); }
+private:
+    std::vector<T> slots_;
+    std::size_t mask_ = 0;
+    //Producer and consumer indices on their own cache line to avoid false sharing
+    alignas(64) std::atomic<std::size_t> head_{ 0 };
+    alignas(64) std::atomic<std::size_t> tail_{ 0 };
+};
+} // namespace core
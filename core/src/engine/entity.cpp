@@ -1,47 +1,74 @@
 #include <engine/entity.h>
 
+#include <algorithm>
+#include <cassert>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #include "engine/component.h"
 
 namespace core
 {
 EntityManager::EntityManager()
 {
-    entityMasks_.resize(entityInitNmb, INVALID_ENTITY_MASK);
+    Grow(entityInitNmb);
 }
 
 EntityManager::EntityManager(std::size_t reservedSize)
 {
-    entityMasks_.resize(reservedSize, INVALID_ENTITY_MASK);
+    Grow(reservedSize);
 }
 
 Entity EntityManager::CreateEntity()
 {
-    const auto entityMaskIt = std::find_if(entityMasks_.begin(), entityMasks_.end(),
-        [](EntityMask entityMask)
-        {
-            return entityMask == INVALID_ENTITY_MASK;
-        });
-
-    if (entityMaskIt == entityMasks_.end())
+    if (freeEntityCount_ == 0)
     {
-        const auto newEntity = entityMasks_.size();
-        entityMasks_.resize(newEntity + newEntity / 2, INVALID_ENTITY_MASK);
-        AddComponent(
-            static_cast<Entity>(newEntity),
-            static_cast<EntityMask>(ComponentType::EMPTY));
-        return static_cast<Entity>(newEntity);
+        const auto size = entityMasks_.size();
+        Grow(size + std::max<std::size_t>(size / 2, 1));
     }
-    
-    const auto newEntity = std::distance(entityMasks_.begin(), entityMaskIt);
+
+    const auto newEntity = freeEntity_;
+    //Pop the entity from the free list, the generation was already increased when it was destroyed
+    freeEntity_ = GetEntity(entityHandles_[newEntity]);
+    entityHandles_[newEntity] = (entityHandles_[newEntity] & ~entityIndexMask) | newEntity;
+    freeEntityCount_--;
     AddComponent(
-        static_cast<Entity>(newEntity), 
+        newEntity, 
         static_cast<EntityMask>(ComponentType::EMPTY));
-    return static_cast<Entity>(newEntity);
+    return newEntity;
+}
+
+std::vector<Entity> EntityManager::CreateEntities(std::size_t count)
+{
+    if (freeEntityCount_ < count)
+    {
+        Grow(entityMasks_.size() + count - freeEntityCount_);
+    }
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        entities.push_back(CreateEntity());
+    }
+    return entities;
 }
 
 void EntityManager::DestroyEntity(Entity entity)
 {
+    //Destroying twice would insert the entity twice in the free list
+    if (GetEntity(entityHandles_[entity]) != entity)
+        return;
     entityMasks_[entity] = INVALID_ENTITY_MASK;
+    const auto generation = (GetGeneration(entityHandles_[entity]) + 1u) & entityGenerationMask;
+    entityHandles_[entity] = (generation << entityIndexBits) | freeEntity_;
+    if (freeEntityCount_ == 0)
+    {
+        lastFreeEntity_ = entity;
+    }
+    freeEntity_ = entity;
+    freeEntityCount_++;
 }
 
 void EntityManager::AddComponent(Entity entity, EntityMask mask)
@@ -60,6 +87,19 @@ bool EntityManager::EntityExists(Entity entity) const
     return entityMasks_[entity] != INVALID_ENTITY_MASK;
 }
 
+EntityHandle EntityManager::GetHandle(Entity entity) const
+{
+    return entityHandles_[entity];
+}
+
+bool EntityManager::IsAlive(EntityHandle handle) const
+{
+    const auto entity = GetEntity(handle);
+    return entity < entityHandles_.size() && 
+        entityHandles_[entity] == handle && 
+        entityMasks_[entity] != INVALID_ENTITY_MASK;
+}
+
 std::size_t EntityManager::GetEntitiesSize() const
 {
     return entityMasks_.size();
@@ -69,4 +109,87 @@ bool EntityManager::HasComponent(Entity entity, EntityMask mask) const
 {
     return (entityMasks_[entity] & mask) == mask;
 }
+
+View EntityManager::GetView(EntityMask include, EntityMask exclude, Entity firstEntity) const
+{
+    //Free entities have an empty mask, an empty include would visit them
+    assert(include != INVALID_ENTITY_MASK);
+    return View(*this, include, exclude, firstEntity);
+}
+
+void EntityManager::Grow(std::size_t newSize)
+{
+    const auto oldSize = entityMasks_.size();
+    if (newSize <= oldSize)
+        return;
+    //The last index is used as the end of the free list
+    assert(newSize < entityIndexMask);
+    entityMasks_.resize(newSize, INVALID_ENTITY_MASK);
+    entityHandles_.resize(newSize);
+    //Link the new entities in increasing order at the back of the free list
+    for (auto entity = oldSize; entity < newSize; entity++)
+    {
+        entityHandles_[entity] = static_cast<Entity>(entity + 1);
+    }
+    entityHandles_[newSize - 1] = entityIndexMask;
+    if (freeEntityCount_ == 0)
+    {
+        freeEntity_ = static_cast<Entity>(oldSize);
+    }
+    else
+    {
+        entityHandles_[lastFreeEntity_] = (entityHandles_[lastFreeEntity_] & ~entityIndexMask) | static_cast<Entity>(oldSize);
+    }
+    lastFreeEntity_ = static_cast<Entity>(newSize - 1);
+    freeEntityCount_ += newSize - oldSize;
+}
+
+std::uint32_t View::MatchBlock(const EntityMask* masks, EntityMask include, EntityMask exclude)
+{
+#if defined(__AVX2__)
+    const auto includeMask = _mm256_set1_epi32(static_cast<int>(include));
+    const auto excludeMask = _mm256_set1_epi32(static_cast<int>(exclude));
+    const auto entityMasks = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks));
+    const auto included = _mm256_cmpeq_epi32(_mm256_and_si256(entityMasks, includeMask), includeMask);
+    const auto excluded = _mm256_cmpeq_epi32(_mm256_and_si256(entityMasks, excludeMask), _mm256_setzero_si256());
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(included, excluded))));
+#elif defined(__SSE2__) || defined(_M_X64)
+    const auto includeMask = _mm_set1_epi32(static_cast<int>(include));
+    const auto excludeMask = _mm_set1_epi32(static_cast<int>(exclude));
+    std::uint32_t matches = 0;
+    for (std::size_t i = 0; i < blockSize; i += 4)
+    {
+        const auto entityMasks = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+        const auto included = _mm_cmpeq_epi32(_mm_and_si128(entityMasks, includeMask), includeMask);
+        const auto excluded = _mm_cmpeq_epi32(_mm_and_si128(entityMasks, excludeMask), _mm_setzero_si128());
+        matches |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(included, excluded)))) << i;
+    }
+    return matches;
+#else
+    std::uint32_t matches = 0;
+    for (std::size_t i = 0; i < blockSize; i++)
+    {
+        if ((masks[i] & include) == include && (masks[i] & exclude) == 0)
+            matches |= 1u << i;
+    }
+    return matches;
+#endif
+}
+
+std::uint32_t View::ScanBlock(std::size_t blockBegin) const
+{
+    const auto& entityMasks = entityManager_->entityMasks_;
+    if (blockBegin + blockSize <= entityMasks.size())
+    {
+        return MatchBlock(entityMasks.data() + blockBegin, include_, exclude_);
+    }
+    //Last incomplete block
+    std::uint32_t matches = 0;
+    for (std::size_t i = blockBegin; i < entityMasks.size(); i++)
+    {
+        if ((entityMasks[i] & include_) == include_ && (entityMasks[i] & exclude_) == 0)
+            matches |= 1u << (i - blockBegin);
+    }
+    return matches;
+}
 }
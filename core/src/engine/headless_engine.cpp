@@ -0,0 +1,97 @@
+#include <engine/headless_engine.h>
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+#include "engine/system.h"
+
+namespace core
+{
+HeadlessEngine::HeadlessEngine(float tickRate)
+{
+    SetTickRate(tickRate);
+}
+
+void HeadlessEngine::Run()
+{
+    //After a stall longer than this many ticks, the schedule restarts from now instead of running all the late ticks
+    constexpr int maxCatchUpTicks = 5;
+
+    Init();
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate_));
+    const auto dt = sf::seconds(1.0f / tickRate_);
+    auto deadline = Clock::now() + period;
+    running_ = true;
+    stats_ = {};
+    while (running_ && (tickLimit_ == 0 || stats_.tickCount < tickLimit_))
+    {
+        if (realTime_)
+        {
+            WaitUntil(deadline);
+            if (!running_)
+                break;
+        }
+        Update(dt);
+        stats_.tickCount++;
+        if (!realTime_)
+            continue;
+
+        deadline += period;
+        const auto now = Clock::now();
+        if (now > deadline)
+        {
+            const auto overrun = std::chrono::duration_cast<std::chrono::microseconds>(now - deadline);
+            stats_.overrunCount++;
+            stats_.totalOverrun += overrun;
+            stats_.maxOverrun = std::max(stats_.maxOverrun, overrun);
+            if (now - deadline > maxCatchUpTicks * period)
+            {
+                deadline = now;
+            }
+        }
+    }
+    running_ = false;
+    Destroy();
+}
+
+void HeadlessEngine::RegisterSystem(SystemInterface* system)
+{
+    systems_.push_back(system);
+}
+
+void HeadlessEngine::SetTickRate(float tickRate)
+{
+    assert(tickRate > 0.0f);
+    tickRate_ = tickRate;
+}
+
+void HeadlessEngine::WaitUntil(Clock::time_point deadline)
+{
+    std::this_thread::sleep_until(deadline);
+}
+
+void HeadlessEngine::Init()
+{
+    for (auto* system : systems_)
+    {
+        system->Init();
+    }
+}
+
+void HeadlessEngine::Update(sf::Time dt)
+{
+    for (auto* system : systems_)
+    {
+        system->Update(dt);
+    }
+}
+
+void HeadlessEngine::Destroy()
+{
+    for (auto* system : systems_)
+    {
+        system->Destroy();
+    }
+}
+} // namespace core
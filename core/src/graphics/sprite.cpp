@@ -15,7 +15,7 @@ namespace core
 
     void SpriteManager::Draw(sf::RenderTarget& window)
     {
-        for (Entity entity = 0; entity < components_.size(); entity++)
+        for (const auto entity : components_.GetEntities())
         {
             if (entityManager_.HasComponent(entity, static_cast<Component>(ComponentType::SPRITE)))
             {
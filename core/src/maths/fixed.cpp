@@ -0,0 +1,125 @@
+#include <maths/fixed.h>
+
+#include <algorithm>
+#include <array>
+
+namespace core
+{
+namespace
+{
+constexpr std::int64_t quarterSteps = 256;
+constexpr std::int64_t turnSteps = 4 * quarterSteps;
+constexpr int tableFractionBits = 30;
+constexpr std::int64_t halfPiQ30 = 1686629713; //pi/2 * 2^30
+
+constexpr std::int64_t MulQ30(std::int64_t a, std::int64_t b)
+{
+    return (a * b) >> tableFractionBits;
+}
+
+/**
+ * \brief Taylor series in Q2.30, the terms after x^15/15! are below its precision on [0, pi/2]
+ */
+constexpr std::int32_t ComputeSinStep(std::int64_t step)
+{
+    const auto x = halfPiQ30 * step / quarterSteps;
+    const auto x2 = MulQ30(x, x);
+    auto term = x;
+    auto sum = x;
+    for (std::int64_t n = 1; n <= 7; n++)
+    {
+        term = -MulQ30(term, x2) / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    constexpr auto shift = tableFractionBits - Fixed::fractionBits;
+    return static_cast<std::int32_t>((sum + (std::int64_t{ 1 } << (shift - 1))) >> shift);
+}
+
+constexpr std::array<std::int32_t, quarterSteps + 1> MakeSinTable()
+{
+    std::array<std::int32_t, quarterSteps + 1> table{};
+    for (std::int64_t step = 0; step <= quarterSteps; step++)
+    {
+        table[step] = ComputeSinStep(step);
+    }
+    return table;
+}
+
+constexpr auto sinTable = MakeSinTable();
+static_assert(sinTable[0] == 0 && sinTable[quarterSteps] == Fixed::one);
+
+std::int64_t SinAtStep(std::int64_t step)
+{
+    const auto quadrant = (step / quarterSteps) % 4;
+    const auto index = step % quarterSteps;
+    switch (quadrant)
+    {
+    case 0: return sinTable[index];
+    case 1: return sinTable[quarterSteps - index];
+    case 2: return -sinTable[index];
+    default: return -sinTable[quarterSteps - index];
+    }
+}
+
+/**
+ * \param turnPosition position on the circle in 1/1024 of turn, with 16 bits of fraction
+ */
+Fixed SinAtTurnPosition(std::int64_t turnPosition)
+{
+    const auto step = turnPosition >> Fixed::fractionBits;
+    const auto fraction = turnPosition & (Fixed::one - 1);
+    const auto sin0 = SinAtStep(step);
+    const auto sin1 = SinAtStep(step + 1);
+    return Fixed::FromRaw(static_cast<std::int32_t>(sin0 + (((sin1 - sin0) * fraction) >> Fixed::fractionBits)));
+}
+
+std::int64_t GetTurnPosition(FixedDegree angle)
+{
+    return static_cast<std::int64_t>(WrapDegrees(angle.value()).GetRaw()) * turnSteps / 360;
+}
+}
+
+std::uint64_t IntegerSqrt(std::uint64_t value)
+{
+    //The floating point square root is only a guess, the integer corrections make the result exact
+    //whatever its precision, so it stays deterministic with -ffast-math
+    auto result = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(value)));
+    result = std::min<std::uint64_t>(result, 0xFFFFFFFFull);
+    while (result * result > value)
+    {
+        result--;
+    }
+    while (result < 0xFFFFFFFFull && (result + 1) * (result + 1) <= value)
+    {
+        result++;
+    }
+    return result;
+}
+
+Fixed Sqrt(Fixed value)
+{
+    if (value.GetRaw() <= 0)
+    {
+        return Fixed();
+    }
+    //sqrt(raw / 2^16) * 2^16 = sqrt(raw * 2^16)
+    return Fixed::FromRaw(static_cast<std::int32_t>(
+        IntegerSqrt(static_cast<std::uint64_t>(value.GetRaw()) << static_cast<unsigned>(Fixed::fractionBits))));
+}
+
+Fixed Sin(FixedDegree angle)
+{
+    return SinAtTurnPosition(GetTurnPosition(angle));
+}
+
+Fixed Cos(FixedDegree angle)
+{
+    return SinAtTurnPosition(GetTurnPosition(angle) + (quarterSteps << Fixed::fractionBits));
+}
+
+Fixed WrapDegrees(Fixed degrees)
+{
+    constexpr std::int32_t fullTurn = 360 * Fixed::one;
+    return Fixed::FromRaw(((degrees.GetRaw() % fullTurn) + fullTurn) % fullTurn);
+}
+}
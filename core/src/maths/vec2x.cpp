@@ -0,0 +1,101 @@
+#include <maths/vec2x.h>
+
+namespace core
+{
+    Vec2x::Vec2x(Vec2f v) : x(v.x), y(v.y)
+    {
+    }
+
+    Vec2f Vec2x::ToVec2f() const
+    {
+        return Vec2f(x.ToFloat(), y.ToFloat());
+    }
+
+    Vec2x Vec2x::operator+(Vec2x v) const
+    {
+        return {x + v.x, y + v.y};
+    }
+
+    Vec2x& Vec2x::operator+=(Vec2x v)
+    {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
+
+    Vec2x Vec2x::operator-(Vec2x v) const
+    {
+        return {x - v.x, y - v.y};
+    }
+
+    Vec2x& Vec2x::operator-=(Vec2x v)
+    {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
+
+    Vec2x Vec2x::operator*(Fixed f) const
+    {
+        return {x * f, y * f};
+    }
+
+    Vec2x Vec2x::operator/(Fixed f) const
+    {
+        return {x / f, y / f};
+    }
+
+    Vec2x operator*(Fixed f, Vec2x v)
+    {
+        return v * f;
+    }
+
+    Fixed Vec2x::GetMagnitude() const
+    {
+        //The squares of the raw values are in Q32.32, their square root is back in Q16.16
+        const auto rawX = static_cast<std::int64_t>(x.GetRaw());
+        const auto rawY = static_cast<std::int64_t>(y.GetRaw());
+        return Fixed::FromRaw(static_cast<std::int32_t>(IntegerSqrt(static_cast<std::uint64_t>(rawX * rawX + rawY * rawY))));
+    }
+
+    void Vec2x::Normalize()
+    {
+        *this = GetNormalized();
+    }
+
+    Vec2x Vec2x::GetNormalized() const
+    {
+        const auto magnitude = GetMagnitude();
+        if (magnitude == Fixed())
+        {
+            return zero();
+        }
+        return (*this) / magnitude;
+    }
+
+    Fixed Vec2x::GetSqrMagnitude() const
+    {
+        return x * x + y * y;
+    }
+
+    Vec2x Vec2x::Rotate(FixedDegree rotation) const
+    {
+        const auto cs = Cos(rotation);
+        const auto sn = Sin(rotation);
+
+        Vec2x v;
+        v.x = x * cs - y * sn;
+        v.y = x * sn + y * cs;
+        return v;
+    }
+
+    Fixed Vec2x::Dot(Vec2x a, Vec2x b)
+    {
+        return a.x * b.x + a.y * b.y;
+    }
+
+    Vec2x Vec2x::Lerp(Vec2x a, Vec2x b, Fixed t)
+    {
+        return a + (b - a) * t;
+    }
+}
@@ -0,0 +1,141 @@
+#include <utils/hash.h>
+
+#include <cstring>
+
+namespace core
+{
+namespace
+{
+constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t prime3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+constexpr std::uint64_t RotateLeft(std::uint64_t value, unsigned shift)
+{
+    return (value << shift) | (value >> (64u - shift));
+}
+
+std::uint64_t Read64(const std::uint8_t* data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::uint32_t Read32(const std::uint8_t* data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+constexpr std::uint64_t Round(std::uint64_t lane, std::uint64_t input)
+{
+    lane += input * prime2;
+    lane = RotateLeft(lane, 31);
+    return lane * prime1;
+}
+
+constexpr std::uint64_t MergeRound(std::uint64_t hash, std::uint64_t lane)
+{
+    hash ^= Round(0, lane);
+    return hash * prime1 + prime4;
+}
+}
+
+Hasher::Hasher(std::uint64_t seed) :
+    seed_(seed),
+    lanes_{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 }
+{
+}
+
+void Hasher::Update(const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    totalSize_ += size;
+    if (bufferSize_ + size < stripeSize)
+    {
+        std::memcpy(buffer_.data() + bufferSize_, bytes, size);
+        bufferSize_ += size;
+        return;
+    }
+    if (bufferSize_ > 0)
+    {
+        const auto fillSize = stripeSize - bufferSize_;
+        std::memcpy(buffer_.data() + bufferSize_, bytes, fillSize);
+        ConsumeStripe(buffer_.data());
+        bytes += fillSize;
+        size -= fillSize;
+        bufferSize_ = 0;
+    }
+    for (; size >= stripeSize; bytes += stripeSize, size -= stripeSize)
+    {
+        ConsumeStripe(bytes);
+    }
+    std::memcpy(buffer_.data(), bytes, size);
+    bufferSize_ = size;
+}
+
+std::uint64_t Hasher::Digest() const
+{
+    std::uint64_t hash;
+    if (totalSize_ >= stripeSize)
+    {
+        hash = RotateLeft(lanes_[0], 1) + RotateLeft(lanes_[1], 7) + RotateLeft(lanes_[2], 12) + RotateLeft(lanes_[3], 18);
+        for (const auto lane : lanes_)
+        {
+            hash = MergeRound(hash, lane);
+        }
+    }
+    else
+    {
+        hash = seed_ + prime5;
+    }
+    hash += totalSize_;
+
+    const auto* bytes = buffer_.data();
+    std::size_t size = bufferSize_;
+    for (; size >= 8; bytes += 8, size -= 8)
+    {
+        hash ^= Round(0, Read64(bytes));
+        hash = RotateLeft(hash, 27) * prime1 + prime4;
+    }
+    if (size >= 4)
+    {
+        hash ^= static_cast<std::uint64_t>(Read32(bytes)) * prime1;
+        hash = RotateLeft(hash, 23) * prime2 + prime3;
+        bytes += 4;
+        size -= 4;
+    }
+    for (; size > 0; bytes++, size--)
+    {
+        hash ^= *bytes * prime5;
+        hash = RotateLeft(hash, 11) * prime1;
+    }
+
+    //Avalanche
+    hash ^= hash >> 33u;
+    hash *= prime2;
+    hash ^= hash >> 29u;
+    hash *= prime3;
+    hash ^= hash >> 32u;
+    return hash;
+}
+
+void Hasher::ConsumeStripe(const std::uint8_t* stripe)
+{
+    for (std::size_t i = 0; i < lanes_.size(); i++)
+    {
+        lanes_[i] = Round(lanes_[i], Read64(stripe + i * sizeof(std::uint64_t)));
+    }
+}
+
+std::uint64_t Hash64(const void* data, std::size_t size, std::uint64_t seed)
+{
+    Hasher hasher(seed);
+    hasher.Update(data, size);
+    return hasher.Digest();
+}
+}
@@ -0,0 +1,136 @@
+#include <utils/mapped_file.h>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core
+{
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        file_ = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr)
+    {
+        Close();
+        return false;
+    }
+    data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr)
+    {
+        Close();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr)
+    {
+        CloseHandle(file_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+void MappedFile::ReleasePages(std::size_t offset, std::size_t size) const
+{
+    if (data_ == nullptr || offset >= size_)
+        return;
+    //Unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(const_cast<std::uint8_t*>(data_ + offset), std::min(size, size_ - offset));
+}
+#else
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        close(file);
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(fileStat.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    //The mapping keeps its own reference to the file
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+    data_ = static_cast<const std::uint8_t*>(data);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void MappedFile::ReleasePages(std::size_t offset, std::size_t size) const
+{
+    if (data_ == nullptr || offset >= size_)
+        return;
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    //The page holding the end of the range is still read, the mapping starts on a page boundary
+    const auto begin = offset / pageSize * pageSize;
+    const auto end = std::min(offset + size, size_) / pageSize * pageSize;
+    if (begin < end)
+    {
+        madvise(const_cast<std::uint8_t*>(data_ + begin), end - begin, MADV_DONTNEED);
+    }
+}
+#endif
+}
@@ -0,0 +1,45 @@
+#include <engine/component.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+    constexpr core::Component testComponent = static_cast<core::Component>(core::ComponentType::OTHER_TYPE);
+
+    class SparseIntManager : public core::ComponentManager<int, testComponent, core::SparseSetStorage>
+    {
+    public:
+        using ComponentManager::ComponentManager;
+    };
+}
+
+TEST(Component, SparseSetStorage)
+{
+    core::EntityManager entityManager;
+    SparseIntManager intManager(entityManager);
+    const auto entities = entityManager.CreateEntities(300);
+
+    //Added out of order, the entities are still visited in increasing order
+    for (const auto entity : { entities[200], entities[3], entities[42] })
+    {
+        intManager.AddComponent(entity);
+        intManager.SetComponent(entity, static_cast<int>(entity));
+    }
+    EXPECT_TRUE(entityManager.HasComponent(entities[42], testComponent));
+    EXPECT_FALSE(entityManager.HasComponent(entities[43], testComponent));
+    ASSERT_EQ(intManager.GetEntities().size(), 3u);
+    EXPECT_EQ(intManager.GetEntities()[0], entities[3]);
+    EXPECT_EQ(intManager.GetEntities()[1], entities[42]);
+    EXPECT_EQ(intManager.GetEntities()[2], entities[200]);
+    EXPECT_EQ(intManager.GetAllComponents()[2], static_cast<int>(entities[200]));
+
+    intManager.RemoveComponent(entities[42]);
+    EXPECT_FALSE(entityManager.HasComponent(entities[42], testComponent));
+    ASSERT_EQ(intManager.GetEntities().size(), 2u);
+    EXPECT_EQ(intManager.GetComponent(entities[3]), static_cast<int>(entities[3]));
+    EXPECT_EQ(intManager.GetComponent(entities[200]), static_cast<int>(entities[200]));
+
+    auto components = intManager.GetAllComponents();
+    components[0] = -1;
+    intManager.CopyAllComponents(components);
+    EXPECT_EQ(intManager.GetComponent(entities[3]), -1);
+}
@@ -0,0 +1,96 @@
+#include <engine/headless_engine.h>
+#include <engine/system.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+    class CountingSystem : public core::SystemInterface
+    {
+    public:
+        void Init() override { initCount++; }
+        void Update(sf::Time dt) override
+        {
+            updateCount++;
+            lastDt = dt;
+        }
+        void Destroy() override { destroyCount++; }
+
+        int initCount = 0;
+        int updateCount = 0;
+        int destroyCount = 0;
+        sf::Time lastDt;
+    };
+
+    class StoppingSystem : public CountingSystem
+    {
+    public:
+        explicit StoppingSystem(core::HeadlessEngine& engine) : engine_(engine) {}
+        void Update(sf::Time dt) override
+        {
+            CountingSystem::Update(dt);
+            if (updateCount == 3)
+                engine_.Stop();
+        }
+    private:
+        core::HeadlessEngine& engine_;
+    };
+}
+
+TEST(HeadlessEngine, RunLimit)
+{
+    core::HeadlessEngine engine(100.0f);
+    engine.SetRealTime(false);
+    engine.SetRunLimit(250);
+    CountingSystem system;
+    engine.RegisterSystem(&system);
+    engine.Run();
+
+    EXPECT_EQ(system.initCount, 1);
+    EXPECT_EQ(system.updateCount, 250);
+    EXPECT_EQ(system.destroyCount, 1);
+    EXPECT_EQ(engine.GetTickCount(), 250u);
+    EXPECT_FLOAT_EQ(system.lastDt.asSeconds(), 0.01f);
+}
+
+TEST(HeadlessEngine, Stop)
+{
+    core::HeadlessEngine engine(1000.0f);
+    StoppingSystem system(engine);
+    engine.RegisterSystem(&system);
+    engine.Run();
+
+    EXPECT_EQ(system.updateCount, 3);
+    EXPECT_EQ(system.destroyCount, 1);
+}
+
+namespace
+{
+    //Replaces the sleep like the server waiting on its sockets
+    class WaitingEngine : public core::HeadlessEngine
+    {
+    public:
+        WaitingEngine() : HeadlessEngine(1000.0f) {}
+        int waitCount = 0;
+    protected:
+        void WaitUntil(Clock::time_point deadline) override
+        {
+            waitCount++;
+            HeadlessEngine::WaitUntil(deadline);
+            if (waitCount == 5)
+                Stop();
+        }
+    };
+}
+
+TEST(HeadlessEngine, WaitUntilStopsBeforeTheTick)
+{
+    WaitingEngine engine;
+    CountingSystem system;
+    engine.RegisterSystem(&system);
+    engine.Run();
+
+    EXPECT_EQ(engine.waitCount, 5);
+    EXPECT_EQ(system.updateCount, 4);
+    EXPECT_EQ(engine.GetStats().tickCount, 4u);
+    EXPECT_EQ(system.destroyCount, 1);
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <cmath>
 #include <engine/entity.h>
 #include <gtest/gtest.h>
@@ -34,4 +35,138 @@ TEST(Entity, EntityComponent)
     entityManager.AddComponent(newEntity, newComponent);
     entityManager.DestroyEntity(newEntity);
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent));
-}
\ No newline at end of file
+}
+TEST(Entity, EntityHandle)
+{
+    core::EntityManager entityManager;
+    const auto entity = entityManager.CreateEntity();
+    const auto handle = entityManager.GetHandle(entity);
+    EXPECT_EQ(core::EntityManager::GetEntity(handle), entity);
+    EXPECT_TRUE(entityManager.IsAlive(handle));
+
+    entityManager.DestroyEntity(entity);
+    EXPECT_FALSE(entityManager.IsAlive(handle));
+
+    //The free slot is reused, but the old handle does not alias the new entity
+    const auto newEntity = entityManager.CreateEntity();
+    EXPECT_EQ(newEntity, entity);
+    const auto newHandle = entityManager.GetHandle(newEntity);
+    EXPECT_NE(newHandle, handle);
+    EXPECT_TRUE(entityManager.IsAlive(newHandle));
+    EXPECT_FALSE(entityManager.IsAlive(handle));
+    EXPECT_FALSE(entityManager.IsAlive(core::EntityManager::INVALID_HANDLE));
+}
+
+TEST(Entity, EntityHandleGenerationWraps)
+{
+    core::EntityManager entityManager;
+    const auto entity = entityManager.CreateEntity();
+    const auto handle = entityManager.GetHandle(entity);
+    //More reuses than an 8-bit generation holds
+    for (std::uint32_t i = 0; i < 300; i++)
+    {
+        entityManager.DestroyEntity(entity);
+        ASSERT_EQ(entityManager.CreateEntity(), entity);
+        EXPECT_FALSE(entityManager.IsAlive(handle));
+    }
+    //The generation only comes back to the old handle after all of them were used
+    for (std::uint32_t i = 300; i < core::EntityManager::entityGenerationMask; i++)
+    {
+        entityManager.DestroyEntity(entity);
+        entityManager.CreateEntity();
+    }
+    EXPECT_EQ(core::EntityManager::GetGeneration(entityManager.GetHandle(entity)), core::EntityManager::entityGenerationMask);
+    entityManager.DestroyEntity(entity);
+    entityManager.CreateEntity();
+    EXPECT_EQ(entityManager.GetHandle(entity), handle);
+
+    //The index of INVALID_HANDLE ends the free list and is never an entity
+    static_assert(core::EntityManager::GetEntity(core::EntityManager::INVALID_HANDLE) == core::EntityManager::entityIndexMask);
+    static_assert(core::EntityManager::GetGeneration(core::EntityManager::INVALID_HANDLE) == core::EntityManager::entityGenerationMask);
+}
+
+TEST(Entity, CreateEntities)
+{
+    static constexpr std::size_t entityNmb = 1000;
+    core::EntityManager entityManager(4);
+    const auto entities = entityManager.CreateEntities(entityNmb);
+    ASSERT_EQ(entities.size(), entityNmb);
+    EXPECT_GE(entityManager.GetEntitiesSize(), entityNmb);
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        EXPECT_EQ(entities[i], static_cast<core::Entity>(i));
+        EXPECT_TRUE(entityManager.EntityExists(entities[i]));
+    }
+
+    //Destroying twice must not give the same entity twice
+    entityManager.DestroyEntity(entities[10]);
+    entityManager.DestroyEntity(entities[10]);
+    const auto firstEntity = entityManager.CreateEntity();
+    const auto secondEntity = entityManager.CreateEntity();
+    EXPECT_EQ(firstEntity, entities[10]);
+    EXPECT_NE(secondEntity, firstEntity);
+}
+
+TEST(Entity, View)
+{
+    static constexpr core::Component includeComponent = 2u;
+    static constexpr core::Component excludeComponent = 4u;
+    //Not a multiple of the block size to check the last incomplete block
+    static constexpr std::size_t entityNmb = 301;
+    core::EntityManager entityManager(entityNmb);
+    const auto entities = entityManager.CreateEntities(entityNmb);
+    std::vector<core::Entity> expectedEntities;
+    for (const auto entity : entities)
+    {
+        if (entity % 3 == 0)
+            entityManager.AddComponent(entity, includeComponent);
+        if (entity % 5 == 0)
+            entityManager.AddComponent(entity, excludeComponent);
+        if (entity % 3 == 0 && entity % 5 != 0 && entity >= 10)
+            expectedEntities.push_back(entity);
+    }
+
+    std::vector<core::Entity> viewEntities;
+    for (const auto entity : entityManager.GetView(includeComponent, excludeComponent, 10))
+    {
+        viewEntities.push_back(entity);
+    }
+    EXPECT_EQ(viewEntities, expectedEntities);
+
+    std::size_t count = 0;
+    for ([[maybe_unused]] const auto entity : entityManager.GetView(
+        static_cast<core::EntityMask>(core::ComponentType::EMPTY)))
+    {
+        count++;
+    }
+    EXPECT_EQ(count, entityNmb);
+}
+
+TEST(Entity, MatchBlockMatchesEveryMaskCombination)
+{
+    //Every include and exclude pair of 3 bits against every mask of 3 bits, in the low bits and up to the sign bit,
+    //whichever SIMD path is compiled
+    for (const std::uint32_t shift : { 0u, 29u })
+    {
+        std::array<core::EntityMask, core::View::blockSize> masks{};
+        for (core::EntityMask mask = 0; mask < masks.size(); mask++)
+        {
+            masks[mask] = mask << shift;
+        }
+        for (core::EntityMask includeBits = 0; includeBits < 8; includeBits++)
+        {
+            for (core::EntityMask excludeBits = 0; excludeBits < 8; excludeBits++)
+            {
+                const auto include = includeBits << shift;
+                const auto exclude = excludeBits << shift;
+                std::uint32_t expectedMatches = 0;
+                for (std::size_t i = 0; i < masks.size(); i++)
+                {
+                    if ((masks[i] & include) == include && (masks[i] & exclude) == 0)
+                        expectedMatches |= 1u << i;
+                }
+                EXPECT_EQ(core::View::MatchBlock(masks.data(), include, exclude), expectedMatches) << include << " " << exclude;
+            }
+        }
+    }
+}
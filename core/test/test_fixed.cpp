@@ -0,0 +1,69 @@
+#include <cmath>
+#include "maths/fixed.h"
+#include "maths/vec2x.h"
+#include <gtest/gtest.h>
+
+TEST(Fixed, Arithmetic)
+{
+    constexpr core::Fixed a = 1.5f;
+    constexpr core::Fixed b = -0.25f;
+    static_assert((a + b).GetRaw() == 81920);
+    EXPECT_FLOAT_EQ((a * b).ToFloat(), -0.375f);
+    EXPECT_FLOAT_EQ((a / b).ToFloat(), -6.0f);
+    EXPECT_EQ(core::Fixed(3) - a, a);
+    EXPECT_LT(b, a);
+    EXPECT_EQ(core::FloorToInt(b), -1);
+    EXPECT_EQ(core::FloorToInt(a), 1);
+}
+
+TEST(Fixed, DivisionByZeroSaturates)
+{
+    static_assert((core::Fixed(3) / core::Fixed()).GetRaw() == std::numeric_limits<std::int32_t>::max());
+    EXPECT_EQ((core::Fixed(-0.5f) / core::Fixed()).GetRaw(), std::numeric_limits<std::int32_t>::min());
+    EXPECT_EQ(core::Fixed() / core::Fixed(), core::Fixed());
+}
+
+TEST(Fixed, Sqrt)
+{
+    EXPECT_EQ(core::Sqrt(core::Fixed(4)), core::Fixed(2));
+    EXPECT_EQ(core::Sqrt(core::Fixed(-4)), core::Fixed());
+    for (float value = 0.0f; value < 1000.0f; value += 3.7f)
+    {
+        EXPECT_NEAR(core::Sqrt(core::Fixed(value)).ToFloat(), std::sqrt(value), 1e-3f) << value;
+    }
+}
+
+TEST(Fixed, SinCos)
+{
+    EXPECT_EQ(core::Sin(core::FixedDegree(core::Fixed(90))), core::Fixed(1));
+    EXPECT_EQ(core::Cos(core::FixedDegree(core::Fixed(0))), core::Fixed(1));
+    EXPECT_EQ(core::Sin(core::FixedDegree(core::Fixed(-90))), core::Fixed(-1));
+    for (float degrees = -720.0f; degrees < 720.0f; degrees += 1.3f)
+    {
+        const core::radian_t radians = core::degree_t(degrees);
+        const core::FixedDegree angle(core::Fixed{ degrees });
+        EXPECT_NEAR(core::Sin(angle).ToFloat(), std::sin(radians.value()), 1e-4f) << degrees;
+        EXPECT_NEAR(core::Cos(angle).ToFloat(), std::cos(radians.value()), 1e-4f) << degrees;
+    }
+}
+
+TEST(Fixed, WrapDegrees)
+{
+    EXPECT_EQ(core::WrapDegrees(core::Fixed(370)), core::Fixed(10));
+    EXPECT_EQ(core::WrapDegrees(core::Fixed(-90)), core::Fixed(270));
+    EXPECT_EQ(core::WrapDegrees(core::Fixed(360)), core::Fixed(0));
+}
+
+TEST(Vec2x, MatchesVec2f)
+{
+    const core::Vec2f vector(2.5f, -1.25f);
+    const core::Vec2x fixedVector(vector);
+    EXPECT_NEAR(fixedVector.GetMagnitude().ToFloat(), vector.GetMagnitude(), 1e-4f);
+    const auto normalized = fixedVector.GetNormalized().ToVec2f();
+    EXPECT_NEAR(normalized.x, vector.GetNormalized().x, 1e-4f);
+    EXPECT_NEAR(normalized.y, vector.GetNormalized().y, 1e-4f);
+    const auto rotated = fixedVector.Rotate(core::FixedDegree(core::Fixed(30))).ToVec2f();
+    EXPECT_NEAR(rotated.x, vector.Rotate(core::degree_t(30.0f)).x, 1e-3f);
+    EXPECT_NEAR(rotated.y, vector.Rotate(core::degree_t(30.0f)).y, 1e-3f);
+    EXPECT_EQ(core::Vec2x::zero().GetNormalized().x, core::Fixed());
+}
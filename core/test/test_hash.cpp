@@ -0,0 +1,32 @@
+#include <utils/hash.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <string_view>
+
+TEST(Hash, KnownValues)
+{
+    //Reference values of xxHash64 with a seed of 0
+    constexpr std::string_view empty;
+    constexpr std::string_view abc = "abc";
+    constexpr std::string_view fox = "The quick brown fox jumps over the lazy dog";
+    EXPECT_EQ(core::Hash64(empty.data(), empty.size()), 0xEF46DB3751D8E999ull);
+    EXPECT_EQ(core::Hash64(abc.data(), abc.size()), 0x44BC2CF5AD770999ull);
+    EXPECT_EQ(core::Hash64(fox.data(), fox.size()), 0x0B242D361FDA71BCull);
+}
+
+TEST(Hash, StreamingMatchesOneShot)
+{
+    std::vector<std::uint8_t> bytes(1000);
+    std::iota(bytes.begin(), bytes.end(), std::uint8_t{ 0 });
+    const auto expected = core::Hash64(bytes.data(), bytes.size(), 7);
+    for (const std::size_t chunkSize : { 1u, 3u, 31u, 32u, 33u, 100u })
+    {
+        core::Hasher hasher(7);
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunkSize)
+        {
+            hasher.Update(bytes.data() + offset, std::min(chunkSize, bytes.size() - offset));
+        }
+        EXPECT_EQ(hasher.Digest(), expected) << "chunk size " << chunkSize;
+    }
+}
@@ -0,0 +1,75 @@
+#include <engine/paged_array.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+    using TestPagedArray = core::PagedArray<float, 4>;
+
+    TestPagedArray MakeSequence(std::size_t count)
+    {
+        TestPagedArray values;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            values.Insert(i, static_cast<float>(i));
+        }
+        return values;
+    }
+}
+
+TEST(PagedArray, CopySharesPagesUntilWritten)
+{
+    auto values = MakeSequence(10);
+    ASSERT_EQ(values.GetPageCount(), 3u);
+    EXPECT_EQ(values.GetPageSize(2), 2u);
+    EXPECT_FALSE(values.IsPageShared(0));
+
+    const auto snapshot = values;
+    for (std::size_t page = 0; page < values.GetPageCount(); page++)
+    {
+        EXPECT_TRUE(values.IsPageShared(page));
+        EXPECT_EQ(values.GetPage(page), snapshot.GetPage(page));
+    }
+
+    //Only the written page is duplicated, the snapshot keeps the old value
+    values.Set(5, -1.0f);
+    EXPECT_TRUE(values.IsPageShared(0));
+    EXPECT_FALSE(values.IsPageShared(1));
+    EXPECT_TRUE(values.IsPageShared(2));
+    EXPECT_FLOAT_EQ(std::as_const(values)[5], -1.0f);
+    EXPECT_FLOAT_EQ(snapshot[5], 5.0f);
+
+    //Setting the same value or reading does not duplicate the page
+    values.Set(9, 9.0f);
+    EXPECT_FLOAT_EQ(std::as_const(values)[8], 8.0f);
+    EXPECT_TRUE(values.IsPageShared(2));
+
+    //0.0f and -0.0f are different states
+    values.Set(0, -0.0f);
+    EXPECT_FALSE(values.IsPageShared(0));
+
+    values = snapshot;
+    EXPECT_EQ(values.GetPage(1), snapshot.GetPage(1));
+    EXPECT_FLOAT_EQ(values[5], 5.0f);
+}
+
+TEST(PagedArray, InsertAndErase)
+{
+    auto values = MakeSequence(8);
+    const auto snapshot = values;
+    values.Insert(2, 100.0f);
+    ASSERT_EQ(values.size(), 9u);
+    EXPECT_EQ(values.GetPageCount(), 3u);
+    EXPECT_FLOAT_EQ(std::as_const(values)[2], 100.0f);
+    EXPECT_FLOAT_EQ(std::as_const(values)[3], 2.0f);
+    EXPECT_FLOAT_EQ(std::as_const(values)[8], 7.0f);
+    EXPECT_FLOAT_EQ(snapshot[2], 2.0f);
+
+    values.Erase(2);
+    values.Erase(7);
+    ASSERT_EQ(values.size(), 7u);
+    EXPECT_EQ(values.GetPageCount(), 2u);
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        EXPECT_FLOAT_EQ(std::as_const(values)[i], static_cast<float>(i));
+    }
+}
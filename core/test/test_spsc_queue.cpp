@@ -0,0 +1,54 @@
+#include <utils/spsc_queue.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(SpscQueue, Bounded)
+{
+    core::SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.GetCapacity(), 4u);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.Push(std::move(i)));
+    }
+    int value = 4;
+    EXPECT_FALSE(queue.Push(std::move(value)));
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(queue.Pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+TEST(SpscQueue, TwoThreads)
+{
+    constexpr int count = 100'000;
+    core::SpscQueue<int> queue(64);
+    std::thread producer([&queue]
+        {
+            for (int i = 0; i < count; i++)
+            {
+                int value = i;
+                while (!queue.Push(std::move(value)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    int expected = 0;
+    while (expected < count)
+    {
+        int value;
+        if (queue.Pop(value))
+        {
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
@@ -0,0 +1,106 @@
+#include <game/physics_manager.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace
+{
+    constexpr float benchDt = 0.02f;
+
+    game::BoxBody RandomBody(std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+        game::BoxBody body;
+        body.position = game::SimVec2(distribution(generator), distribution(generator));
+        body.velocity = game::SimVec2(distribution(generator), distribution(generator));
+        body.angularVelocity = game::SimAngle(game::Scalar(distribution(generator)));
+        body.extends = game::SimVec2(0.32f, 0.275f);
+        return body;
+    }
+}
+
+//Previous layout: one BoxBody struct per entity, copied out and back in
+static void BM_AosIntegrate(benchmark::State& state)
+{
+    std::mt19937 generator(0);
+    std::vector<game::BoxBody> bodies(static_cast<std::size_t>(state.range(0)));
+    for (auto& body : bodies)
+    {
+        body = RandomBody(generator);
+    }
+    for (auto _ : state)
+    {
+        for (auto& boxBody : bodies)
+        {
+            auto body = boxBody;
+            body.position += body.velocity * benchDt;
+            body.rotation += body.angularVelocity * benchDt;
+            boxBody = body;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AosIntegrate)->Arg(128)->Arg(1024)->Arg(10'000);
+
+static void BM_SoaIntegrate(benchmark::State& state)
+{
+    std::mt19937 generator(0);
+    core::EntityManager entityManager;
+    game::BoxBodyManager boxBodyManager(entityManager);
+    for (const auto entity : entityManager.CreateEntities(static_cast<std::size_t>(state.range(0))))
+    {
+        boxBodyManager.AddComponent(entity);
+        boxBodyManager.SetComponent(entity, RandomBody(generator));
+    }
+    for (auto _ : state)
+    {
+        boxBodyManager.Integrate(benchDt);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoaIntegrate)->Arg(128)->Arg(1024)->Arg(10'000);
+
+static void BM_AosAabb(benchmark::State& state)
+{
+    std::mt19937 generator(0);
+    std::vector<game::BoxBody> bodies(static_cast<std::size_t>(state.range(0)));
+    for (auto& body : bodies)
+    {
+        body = RandomBody(generator);
+    }
+    std::vector<game::Aabb> aabbs(bodies.size());
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            aabbs[i] = game::GetAabb(bodies[i]);
+        }
+        benchmark::DoNotOptimize(aabbs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AosAabb)->Arg(128)->Arg(1024)->Arg(10'000);
+
+static void BM_SoaAabb(benchmark::State& state)
+{
+    std::mt19937 generator(0);
+    core::EntityManager entityManager;
+    game::BoxBodyManager boxBodyManager(entityManager);
+    for (const auto entity : entityManager.CreateEntities(static_cast<std::size_t>(state.range(0))))
+    {
+        boxBodyManager.AddComponent(entity);
+        boxBodyManager.SetComponent(entity, RandomBody(generator));
+    }
+    std::vector<game::Aabb> aabbs;
+    for (auto _ : state)
+    {
+        boxBodyManager.ComputeAabbs(aabbs);
+        benchmark::DoNotOptimize(aabbs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SoaAabb)->Arg(128)->Arg(1024)->Arg(10'000);
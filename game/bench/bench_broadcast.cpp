@@ -0,0 +1,58 @@
+#include <network/shared_packet.h>
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+    game::ValidateFramePacket CreateValidatePacket()
+    {
+        game::ValidateFramePacket validatePacket;
+        validatePacket.newValidateFrame = core::ConvertToBinary<game::Frame>(1234);
+        validatePacket.stateHash = core::ConvertToBinary<std::uint64_t>(0x0123456789ABCDEFull);
+        validatePacket.partCount = game::StateHash::PART_COUNT;
+        for (std::size_t i = 0; i < validatePacket.partHashes.size(); i++)
+        {
+            validatePacket.partHashes[i] = core::ConvertToBinary<std::uint64_t>(i * 7u);
+        }
+        return validatePacket;
+    }
+}
+
+//Serializing the broadcast for every destination, as the server did before
+static void BM_BroadcastPerDestination(benchmark::State& state)
+{
+    const auto destinationCount = static_cast<std::size_t>(state.range(0));
+    auto validatePacket = CreateValidatePacket();
+    sf::Packet packet;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < destinationCount; i++)
+        {
+            packet.clear();
+            game::GeneratePacket(packet, validatePacket);
+            benchmark::DoNotOptimize(packet.getData());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(destinationCount));
+}
+BENCHMARK(BM_BroadcastPerDestination)->Arg(2)->Arg(16)->Arg(64);
+
+//Serializing the broadcast once and handing a reference to every destination
+static void BM_BroadcastShared(benchmark::State& state)
+{
+    const auto destinationCount = static_cast<std::size_t>(state.range(0));
+    auto validatePacket = CreateValidatePacket();
+    std::vector<game::SharedPacket> destinations(destinationCount);
+    for (auto _ : state)
+    {
+        const game::SharedPacket sharedPacket(validatePacket);
+        for (auto& destination : destinations)
+        {
+            destination = sharedPacket;
+            benchmark::DoNotOptimize(destination.GetData());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(destinationCount));
+}
+BENCHMARK(BM_BroadcastShared)->Arg(2)->Arg(16)->Arg(64);
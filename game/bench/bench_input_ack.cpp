@@ -0,0 +1,58 @@
+#include <game/game_manager.h>
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+#include "match_fixture.h"
+
+namespace
+{
+    //Inputs from frame to the past, newest first, as they are stored in a PlayerInputPacket
+    void FillInputs(std::array<game::PlayerInput, game::maxInputNmb>& inputs, game::Frame frame, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count && i <= frame; i++)
+        {
+            inputs[i] = game::ScriptedInput(frame - static_cast<game::Frame>(i));
+        }
+    }
+}
+
+//Receiving one packet per frame holding the last 50 inputs, each one set with SetPlayerInput
+static void BM_ReceiveFullInputWindow(benchmark::State& state)
+{
+    game::GameManager gameManager;
+    gameManager.SetPlayerCount(game::defaultPlayerNmb);
+    std::array<game::PlayerInput, game::maxInputNmb> inputs{};
+    game::Frame frame = 0;
+    for (auto _ : state)
+    {
+        frame++;
+        FillInputs(inputs, frame, inputs.size());
+        for (game::Frame i = 0; i < inputs.size() && i <= frame; i++)
+        {
+            gameManager.SetPlayerInput(0, inputs[i], frame - i);
+        }
+        benchmark::DoNotOptimize(gameManager.GetRollbackManager().GetLastReceivedFrame(0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReceiveFullInputWindow);
+
+//Receiving one packet per frame holding the inputs after the ack, with the ack one round trip behind
+static void BM_ReceiveAckedInputWindow(benchmark::State& state)
+{
+    const auto windowSize = static_cast<std::size_t>(state.range(0));
+    game::GameManager gameManager;
+    gameManager.SetPlayerCount(game::defaultPlayerNmb);
+    std::array<game::PlayerInput, game::maxInputNmb> inputs{};
+    game::Frame frame = 0;
+    for (auto _ : state)
+    {
+        frame++;
+        FillInputs(inputs, frame, windowSize);
+        gameManager.SetPlayerInputs(0, frame, inputs.data(), windowSize);
+        benchmark::DoNotOptimize(gameManager.GetRollbackManager().GetLastContiguousFrame(0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReceiveAckedInputWindow)->Arg(2)->Arg(5)->Arg(game::maxInputNmb);
@@ -0,0 +1,96 @@
+#include <network/packet_type.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+namespace
+{
+    /**
+     * \brief Inputs of a player holding a direction for a few dozen frames before changing it
+     */
+    std::vector<game::PlayerInput> GeneratePlayerInputs(std::size_t frameCount)
+    {
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<int> holdDistribution(10, 40);
+        std::uniform_int_distribution<int> inputDistribution(0, 15);
+        std::vector<game::PlayerInput> inputs;
+        while (inputs.size() < frameCount)
+        {
+            const auto input = static_cast<game::PlayerInput>(inputDistribution(generator));
+            inputs.insert(inputs.end(), holdDistribution(generator), input);
+        }
+        inputs.resize(frameCount);
+        return inputs;
+    }
+
+    //Wire format before the packet was versioned: 4 bytes frame and all the 50 input bytes
+    void WriteLegacyInputPacket(sf::Packet& packet, const game::PlayerInputPacket& playerInputPacket)
+    {
+        using game::operator<<;
+        packet << static_cast<std::uint8_t>(playerInputPacket.packetType);
+        packet << playerInputPacket.playerNumber << playerInputPacket.currentFrame << playerInputPacket.inputs;
+    }
+
+    void FillPacket(game::PlayerInputPacket& packet, const std::vector<game::PlayerInput>& inputs,
+        game::Frame frame, std::size_t inputCount)
+    {
+        packet.playerNumber = 0;
+        packet.currentFrame = core::ConvertToBinary(frame);
+        packet.inputCount = static_cast<std::uint8_t>(inputCount);
+        for (std::size_t i = 0; i < inputCount; i++)
+        {
+            packet.inputs[i] = inputs[frame - i];
+        }
+    }
+
+    constexpr std::size_t benchFrameCount = 4096;
+}
+
+static void BM_LegacyInputPacket(benchmark::State& state)
+{
+    const auto inputs = GeneratePlayerInputs(benchFrameCount);
+    game::PlayerInputPacket playerInputPacket;
+    game::Frame frame = game::maxInputNmb;
+    std::size_t totalBytes = 0;
+    sf::Packet packet;
+    for (auto _ : state)
+    {
+        FillPacket(playerInputPacket, inputs, frame, game::maxInputNmb);
+        packet.clear();
+        WriteLegacyInputPacket(packet, playerInputPacket);
+        totalBytes += packet.getDataSize();
+        benchmark::DoNotOptimize(packet.getData());
+        frame = frame + 1 < benchFrameCount ? frame + 1 : game::maxInputNmb;
+    }
+    state.counters["bytesPerPacket"] = static_cast<double>(totalBytes) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_LegacyInputPacket);
+
+//Arg is the number of unvalidated frames sent, maxInputNmb is the worst case of a client far behind the validation
+static void BM_InputPacket(benchmark::State& state)
+{
+    const auto inputCount = static_cast<std::size_t>(state.range(0));
+    const auto inputs = GeneratePlayerInputs(benchFrameCount);
+    game::PlayerInputPacket playerInputPacket;
+    game::Frame frame = game::maxInputNmb;
+    std::size_t totalBytes = 0;
+    sf::Packet packet;
+    for (auto _ : state)
+    {
+        FillPacket(playerInputPacket, inputs, frame, inputCount);
+        packet.clear();
+        game::GeneratePacket(packet, playerInputPacket);
+        totalBytes += packet.getDataSize();
+        auto receivedPacket = game::GenerateReceivedPacket(packet);
+        const auto& received = static_cast<const game::PlayerInputPacket&>(*receivedPacket);
+        if (received.inputCount != playerInputPacket.inputCount ||
+            !std::equal(received.inputs.begin(), received.inputs.begin() + inputCount, playerInputPacket.inputs.begin()))
+        {
+            state.SkipWithError("Input packet round trip mismatch");
+            break;
+        }
+        frame = frame + 1 < benchFrameCount ? frame + 1 : game::maxInputNmb;
+    }
+    state.counters["bytesPerPacket"] = static_cast<double>(totalBytes) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_InputPacket)->Arg(3)->Arg(10)->Arg(game::maxInputNmb);
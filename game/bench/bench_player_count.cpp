@@ -0,0 +1,51 @@
+#include <game/game_manager.h>
+#include <benchmark/benchmark.h>
+
+#include "match_fixture.h"
+
+//Server side input bookkeeping of one frame: storing every player input and finding the frame to validate
+static void BM_PlayerInputBookkeeping(benchmark::State& state)
+{
+    const auto playerCount = static_cast<game::PlayerNumber>(state.range(0));
+    game::GameManager gameManager;
+    game::SpawnMatch(gameManager, playerCount);
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    game::Frame frame = 0;
+    for (auto _ : state)
+    {
+        frame++;
+        for (game::PlayerNumber playerNumber = 0; playerNumber < playerCount; playerNumber++)
+        {
+            gameManager.SetPlayerInput(playerNumber, game::ScriptedInput(frame, playerNumber), frame);
+        }
+        auto lastReceiveFrame = rollbackManager.GetLastContiguousFrame(0);
+        for (game::PlayerNumber playerNumber = 1; playerNumber < playerCount; playerNumber++)
+        {
+            lastReceiveFrame = std::min(lastReceiveFrame, rollbackManager.GetLastContiguousFrame(playerNumber));
+        }
+        benchmark::DoNotOptimize(lastReceiveFrame);
+    }
+    state.SetItemsProcessed(state.iterations() * playerCount);
+}
+BENCHMARK(BM_PlayerInputBookkeeping)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+//Full server frame: inputs of every player then validation, which simulates the frame
+static void BM_PlayerValidateFrame(benchmark::State& state)
+{
+    const auto playerCount = static_cast<game::PlayerNumber>(state.range(0));
+    game::GameManager gameManager;
+    game::SpawnMatch(gameManager, playerCount);
+    game::Frame frame = 0;
+    for (auto _ : state)
+    {
+        frame++;
+        for (game::PlayerNumber playerNumber = 0; playerNumber < playerCount; playerNumber++)
+        {
+            gameManager.SetPlayerInput(playerNumber, game::ScriptedInput(frame, playerNumber), frame);
+        }
+        gameManager.Validate(frame);
+        benchmark::DoNotOptimize(gameManager.GetLastValidateFrame());
+    }
+    state.SetItemsProcessed(state.iterations() * playerCount);
+}
+BENCHMARK(BM_PlayerValidateFrame)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
@@ -0,0 +1,46 @@
+#include <game/physics_manager.h>
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+namespace
+{
+    constexpr float snapshotBenchDt = 0.02f;
+    constexpr std::size_t snapshotBenchWindow = 8;
+    constexpr std::size_t movingBodyCount = 8;
+}
+
+//Snapshot of every frame of a rollback window then restore of the oldest one, like a late input does.
+//Only the first bodies move like the players, the other ones rest like the level boxes.
+static void BM_RollbackSnapshot(benchmark::State& state)
+{
+    core::EntityManager entityManager;
+    game::BoxBodyManager boxBodyManager(entityManager);
+    const auto entities = entityManager.CreateEntities(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < entities.size(); i++)
+    {
+        game::BoxBody body;
+        body.position = game::SimVec2(game::Scalar(static_cast<int>(i % 100)), game::Scalar(static_cast<int>(i / 100)));
+        body.extends = game::SimVec2(0.32f, 0.275f);
+        if (i < movingBodyCount)
+        {
+            body.velocity = game::SimVec2(1.0f, 0.5f);
+            body.angularVelocity = game::SimAngle(game::Scalar(10));
+        }
+        boxBodyManager.AddComponent(entities[i]);
+        boxBodyManager.SetComponent(entities[i], body);
+    }
+    std::array<game::BoxBodyArrays, snapshotBenchWindow> snapshots;
+    for (auto _ : state)
+    {
+        for (auto& snapshot : snapshots)
+        {
+            boxBodyManager.Integrate(snapshotBenchDt);
+            snapshot = boxBodyManager.GetAllComponents();
+        }
+        boxBodyManager.CopyAllComponents(snapshots.front());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(snapshotBenchWindow));
+}
+BENCHMARK(BM_RollbackSnapshot)->Arg(64)->Arg(1024)->Arg(10'000);
@@ -0,0 +1,24 @@
+#include <game/game_manager.h>
+#include <benchmark/benchmark.h>
+
+#include "match_fixture.h"
+
+//Checksum the server computes and sends with every validated frame
+static void BM_ValidateStateHash(benchmark::State& state)
+{
+    const auto playerCount = static_cast<game::PlayerNumber>(state.range(0));
+    game::GameManager gameManager;
+    game::SpawnMatch(gameManager, playerCount);
+    for (game::PlayerNumber playerNumber = 0; playerNumber < playerCount; playerNumber++)
+    {
+        gameManager.SetPlayerInput(playerNumber, game::PlayerInputEnum::UP, 1);
+    }
+    gameManager.Validate(1);
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(rollbackManager.GetValidateStateHash());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ValidateStateHash)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
@@ -0,0 +1,140 @@
+#include <network/batch_udp_socket.h>
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    //Datagrams of one burst, like the inputs relayed to a full match in one server tick
+    constexpr std::size_t burstSize = 32;
+    //Size of a typical input packet
+    constexpr std::size_t datagramSize = 12;
+    //Gives up on a burst when the datagrams stop coming, loopback may still drop under load
+    constexpr int maxEmptyReceives = 100000;
+
+    std::int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    void WriteTimestamp(std::uint8_t* datagram)
+    {
+        const auto now = Now();
+        std::memcpy(datagram, &now, sizeof(now));
+    }
+
+    void AddLatency(const std::uint8_t* datagram, std::vector<std::int64_t>& latencies)
+    {
+        std::int64_t sentTime = 0;
+        std::memcpy(&sentTime, datagram, sizeof(sentTime));
+        latencies.push_back(Now() - sentTime);
+    }
+
+    void ReportLatencies(benchmark::State& state, std::vector<std::int64_t>& latencies, std::size_t lostCount)
+    {
+        if (!latencies.empty())
+        {
+            const auto p99 = latencies.begin() + static_cast<std::ptrdiff_t>(latencies.size() * 99 / 100);
+            std::nth_element(latencies.begin(), p99, latencies.end());
+            state.counters["p99_us"] = static_cast<double>(*p99) / 1000.0;
+        }
+        state.counters["lost"] = static_cast<double>(lostCount);
+        state.SetItemsProcessed(static_cast<std::int64_t>(latencies.size()));
+    }
+}
+
+//One send and one receive system call per datagram through SFML
+static void BM_SfmlUdpLoopback(benchmark::State& state)
+{
+    sf::UdpSocket receiver;
+    sf::UdpSocket sender;
+    if (receiver.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done ||
+        sender.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done)
+    {
+        state.SkipWithError("Could not bind the loopback sockets");
+        return;
+    }
+    receiver.setBlocking(false);
+    const auto port = receiver.getLocalPort();
+    std::vector<std::int64_t> latencies;
+    std::size_t lostCount = 0;
+    std::array<std::uint8_t, datagramSize> datagram{};
+    std::array<std::uint8_t, game::BatchUdpSocket::maxDatagramSize> receiveBuffer{};
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < burstSize; i++)
+        {
+            WriteTimestamp(datagram.data());
+            sender.send(datagram.data(), datagram.size(), sf::IpAddress::LocalHost, port);
+        }
+        std::size_t receivedCount = 0;
+        int emptyReceives = 0;
+        while (receivedCount < burstSize && emptyReceives < maxEmptyReceives)
+        {
+            std::size_t received = 0;
+            sf::IpAddress address;
+            unsigned short remotePort = 0;
+            if (receiver.receive(receiveBuffer.data(), receiveBuffer.size(), received, address, remotePort) != sf::Socket::Done)
+            {
+                emptyReceives++;
+                continue;
+            }
+            AddLatency(receiveBuffer.data(), latencies);
+            receivedCount++;
+        }
+        lostCount += burstSize - receivedCount;
+    }
+    ReportLatencies(state, latencies, lostCount);
+}
+BENCHMARK(BM_SfmlUdpLoopback);
+
+//The burst leaves in one sendmmsg and is drained with recvmmsg
+static void BM_BatchUdpLoopback(benchmark::State& state)
+{
+    game::BatchUdpSocket receiver(burstSize);
+    game::BatchUdpSocket sender(burstSize);
+    if (receiver.GetSocket().bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done ||
+        sender.GetSocket().bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost) != sf::Socket::Done)
+    {
+        state.SkipWithError("Could not bind the loopback sockets");
+        return;
+    }
+    receiver.GetSocket().setBlocking(false);
+    const auto port = receiver.GetSocket().getLocalPort();
+    std::vector<std::int64_t> latencies;
+    std::size_t lostCount = 0;
+    std::array<std::uint8_t, datagramSize> datagram{};
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < burstSize; i++)
+        {
+            WriteTimestamp(datagram.data());
+            sender.Send(datagram.data(), datagram.size(), sf::IpAddress::LocalHost, port);
+        }
+        sender.Flush();
+        std::size_t receivedCount = 0;
+        int emptyReceives = 0;
+        while (receivedCount < burstSize && emptyReceives < maxEmptyReceives)
+        {
+            const auto received = receiver.Receive();
+            if (received == 0)
+            {
+                emptyReceives++;
+                continue;
+            }
+            for (std::size_t i = 0; i < received; i++)
+            {
+                AddLatency(receiver.GetDatagram(i).data, latencies);
+            }
+            receivedCount += received;
+        }
+        lostCount += burstSize - std::min(receivedCount, burstSize);
+    }
+    ReportLatencies(state, latencies, lostCount);
+}
+BENCHMARK(BM_BatchUdpLoopback);
@@ -5,7 +5,9 @@
 #include "engine/component.h"
 #include "engine/entity.h"
 #include "maths/angle.h"
+#include "maths/fixed.h"
 #include "maths/vec2.h"
+#include "maths/vec2x.h"
 
 
 namespace game
@@ -14,37 +16,93 @@ namespace game
     using PlayerNumber = std::uint8_t;
     const PlayerNumber INVALID_PLAYER = std::numeric_limits<PlayerNumber>::max();
     using ClientId = std::uint16_t;
+    using MatchId = std::uint32_t;
     using Frame = std::uint32_t;
+    const Frame INVALID_FRAME = std::numeric_limits<Frame>::max();
+
+    /**
+     * \brief Number types of the simulation (BoxBody, physics and players), the rendering keeps floats.
+     * GAME_FIXED_POINT simulates in Q16.16 fixed point so that the server and clients built with different
+     * compilers or flags never desync.
+     */
+#ifdef GAME_FIXED_POINT
+    using Scalar = core::Fixed;
+    using SimVec2 = core::Vec2x;
+    using SimAngle = core::FixedDegree;
+#else
+    using Scalar = float;
+    using SimVec2 = core::Vec2f;
+    using SimAngle = core::degree_t;
+#endif
 
     const std::uint32_t maxBoxNmb = 10;
-    const std::uint32_t maxPlayerNmb = 2;
+    const std::uint32_t maxPlayerNmb = 16; // capacity, the player count of a match is chosen at runtime
+    const std::uint32_t defaultPlayerNmb = 2;
+    constexpr std::size_t windowBufferSize = 5 * 50; // 5 seconds of frame at 50 fps
     const float playerSpeed = 1.0f;
     const core::degree_t playerAngularSpeed = core::degree_t(90.0f);
+    constexpr float physicsCellSize = 2.0f; // broadphase grid cell size in meters
 
-    const std::array<sf::Color, std::max(maxPlayerNmb, 4u)> playerColors =
+    const std::array<sf::Color, maxPlayerNmb> playerColors =
     {
       {
             sf::Color::Cyan,
             sf::Color::Red,
             sf::Color::Yellow,
-            sf::Color::Magenta
+            sf::Color::Magenta,
+            sf::Color::Green,
+            sf::Color::Blue,
+            sf::Color::White,
+            sf::Color(255, 128, 0),
+            sf::Color(128, 0, 255),
+            sf::Color(0, 128, 128),
+            sf::Color(255, 128, 192),
+            sf::Color(128, 255, 0),
+            sf::Color(128, 64, 0),
+            sf::Color(0, 64, 128),
+            sf::Color(192, 192, 192),
+            sf::Color(128, 128, 0)
         }
     };
 
-    constexpr std::array<core::Vec2f, std::max(4u, maxPlayerNmb)> spawnPositions
+    constexpr std::array<core::Vec2f, maxPlayerNmb> spawnPositions
     {
             core::Vec2f(-1,0),
             core::Vec2f(1,0),
             core::Vec2f(1,-1),
             core::Vec2f(0,0),
+            core::Vec2f(-1,-1),
+            core::Vec2f(0,-1),
+            core::Vec2f(-0.5f,-0.5f),
+            core::Vec2f(0.5f,-0.5f),
+            core::Vec2f(-0.5f,0),
+            core::Vec2f(0.5f,0),
+            core::Vec2f(-1,0.5f),
+            core::Vec2f(1,0.5f),
+            core::Vec2f(-0.5f,0.5f),
+            core::Vec2f(0.5f,0.5f),
+            core::Vec2f(0,0.5f),
+            core::Vec2f(-1,-0.5f),
     };
 
-    const std::array<core::degree_t, std::max(4u, maxPlayerNmb)> spawnRotations
+    const std::array<core::degree_t, maxPlayerNmb> spawnRotations
     {
         core::degree_t(0.0f),
         core::degree_t(0.0f),
         core::degree_t(-90.0f),
-        core::degree_t(90.0f)
+        core::degree_t(90.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f),
+        core::degree_t(0.0f)
     };
 
     enum class ComponentType : core::EntityMask
@@ -55,6 +113,7 @@ namespace game
         WALL = static_cast<core::EntityMask>(core::ComponentType::OTHER_TYPE) << 2u,
         PLAYER_INPUT = static_cast<core::EntityMask>(core::ComponentType::OTHER_TYPE) << 3u,
         DESTROYED = static_cast<core::EntityMask>(core::ComponentType::OTHER_TYPE) << 4u,
+        STATIC_BODY = static_cast<core::EntityMask>(core::ComponentType::OTHER_TYPE) << 5u,
     };
 
     using PlayerInput = std::uint8_t;
@@ -6,6 +6,9 @@
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Text.hpp>
 
+#include <memory>
+#include <string>
+
 #include "game_globals.h"
 #include "rollback_manager.h"
 #include "engine/entity.h"
@@ -29,18 +32,37 @@ namespace game
         GameManager();
         virtual ~GameManager() = default;
         virtual void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::degree_t rotation);
-        virtual core::Entity SpawnBox(core::Vec2f position);
-        virtual core::Entity SpawnFlag(core::Vec2f position);
-        virtual core::Entity SpawnTrack(core::Vec2f position);
-        virtual core::Entity SpawnWall(core::Vec2f position);
-        virtual core::Entity SpawnGreatBox(core::Vec2f position);
+        virtual void SpawnBox(core::Entity entity, core::Vec2f position);
+        virtual void SpawnFlag(core::Entity entity, core::Vec2f position);
+        virtual void SpawnTrack(core::Entity entity, core::Vec2f position);
+        virtual void SpawnWall(core::Entity entity, core::Vec2f position);
+        virtual void SpawnGreatBox(core::Entity entity, core::Vec2f position);
         void SpawnLevel();
         [[nodiscard]] core::Entity GetEntityFromPlayerNumber(PlayerNumber playerNumber) const;
+        /**
+         * \brief Number of players of the match, up to maxPlayerNmb
+         */
+        void SetPlayerCount(PlayerNumber playerCount);
+        [[nodiscard]] PlayerNumber GetPlayerCount() const { return rollbackManager_.GetPlayerCount(); }
         [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
         [[nodiscard]] Frame GetLastValidateFrame() const { return rollbackManager_.GetLastValidateFrame(); }
         [[nodiscard]] const core::TransformManager& GetTransformManager() const { return transformManager_; }
         [[nodiscard]] const RollbackManager& GetRollbackManager() const { return rollbackManager_; }
+        /**
+         * \brief Records the spawns and the validated inputs into a replay for the replay tool, to start before the players spawn.
+         * With MatchReplayWriter::STATE_HASHES, the replay is a desync trace for the desync_bisect tool.
+         * \return false if the replay file could not be created
+         */
+        bool StartMatchReplay(const std::string& path, std::uint8_t flags = 0);
+        /**
+         * \brief Start time of the match in milliseconds since epoch, only kept in the match replay
+         */
+        void SetMatchReplayStartTime(unsigned long long startTime);
         virtual void SetPlayerInput(PlayerNumber playerNumber, std::uint8_t playerInput, std::uint32_t inputFrame);
+        /**
+         * \brief Set the inputs of a received player packet, newest first, only the frames not received yet are applied
+         */
+        void SetPlayerInputs(PlayerNumber playerNumber, Frame newestFrame, const PlayerInput* playerInputs, std::size_t count);
         /*
          * \brief Called by the server to validate a frame
          */
@@ -54,11 +76,11 @@ namespace game
         core::EntityManager entityManager_;
         core::TransformManager transformManager_;
         RollbackManager rollbackManager_;
-        PhysicsManager physicsManager_;
         std::array<core::Entity, maxPlayerNmb> playerEntityMap_{};
         std::array<core::Entity, maxBoxNmb> boxEntityMap_{};
         Frame currentFrame_ = 0;
         PlayerNumber winner_ = INVALID_PLAYER;
+        std::unique_ptr<MatchReplayWriter> matchReplay_;
     };
 
     class ClientGameManager : public GameManager,
@@ -73,6 +95,10 @@ namespace game
         explicit ClientGameManager(PacketSenderInterface& packetSenderInterface);
         void StartGame(unsigned long long int startingTime);
         void Init() override;
+        /**
+         * \brief Loads the textures and the font used by Draw, headless clients and bots never call it and run without a display
+         */
+        void LoadResources();
         void Update(sf::Time dt) override;
         void Destroy() override;
         void SetWindowSize(sf::Vector2u windowsSize);
@@ -80,15 +106,20 @@ namespace game
         void Draw(sf::RenderTarget& target) override;
         void SetClientPlayer(PlayerNumber clientPlayer);
         void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::degree_t rotation) override;
-        core::Entity SpawnBox(core::Vec2f position) override;
-        core::Entity SpawnFlag(core::Vec2f position) override;
-        core::Entity SpawnTrack(core::Vec2f position) override;
-        core::Entity SpawnWall(core::Vec2f position) override;
-        core::Entity SpawnGreatBox(core::Vec2f position) override;
+        void SpawnBox(core::Entity entity, core::Vec2f position) override;
+        void SpawnFlag(core::Entity entity, core::Vec2f position) override;
+        void SpawnTrack(core::Entity entity, core::Vec2f position) override;
+        void SpawnWall(core::Entity entity, core::Vec2f position) override;
+        void SpawnGreatBox(core::Entity entity, core::Vec2f position) override;
         void FixedUpdate();
         void SetPlayerInput(PlayerNumber playerNumber, std::uint8_t playerInput, std::uint32_t inputFrame) override;
         void DrawImGui() override;
-        void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& physicsStates);
+        void ConfirmValidateFrame(Frame newValidateFrame, const StateHash& stateHash, std::size_t partCount);
+        /**
+         * \brief Called when the server replicates our inputs, the server holds all of them up to ackFrame
+         */
+        void AcknowledgeInputs(Frame ackFrame);
+        [[nodiscard]] Frame GetInputAckFrame() const { return inputAckFrame_; }
         [[nodiscard]] PlayerNumber GetPlayerNumber() const { return clientPlayer_; }
         void WinGame(PlayerNumber winner) override;
         [[nodiscard]] std::uint32_t GetState() const { return state_; }
@@ -106,6 +137,10 @@ namespace game
         float fixedTimer_ = 0.0f;
         unsigned long long startingTime_ = 0;
         std::uint32_t state_ = 0;
+        /**
+         * \brief Last frame of our inputs acknowledged by the server, only the newer inputs are sent
+         */
+        Frame inputAckFrame_ = 0;
 
         sf::Color color_;
         sf::Texture trackTexture_;
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+#include "game_globals.h"
+
+namespace game
+{
+    /**
+     * \brief Circular buffer of the inputs of one player, indexed by frame between the oldest frame and the current frame (head).
+     * Frames after the last received frame are predicted by repeating the last received input, so advancing a frame
+     * and receiving an input do not move any data.
+     * Inputs are stored from the newest to the oldest frame, so the last inputs can be copied in a packet with at most two copies.
+     */
+    class PlayerInputBuffer
+    {
+    public:
+        /**
+         * \brief Set the input of a frame, frames older than the buffer are ignored.
+         * The frames skipped since the last received one repeat its input and count as received
+         * \return the first frame whose stored or predicted input changed, INVALID_FRAME if none changed
+         */
+        Frame SetInput(Frame frame, PlayerInput input);
+        /**
+         * \brief Set the inputs of a packet from newestFrame to the past, newest first.
+         * Frames up to the last contiguous frame are already held and skipped.
+         * \return the first frame whose stored or predicted input changed, INVALID_FRAME if none changed
+         */
+        Frame SetInputs(Frame newestFrame, const PlayerInput* inputs, std::size_t count);
+        [[nodiscard]] PlayerInput GetInput(Frame frame) const;
+        void StartNewFrame(Frame newFrame);
+        /**
+         * \brief Copy the inputs from newestFrame to the past into destination, newest first
+         * \return the number of inputs copied
+         */
+        std::size_t CopyInputs(Frame newestFrame, PlayerInput* destination, std::size_t count) const;
+        [[nodiscard]] bool Contains(Frame frame) const;
+        [[nodiscard]] Frame GetCurrentFrame() const { return head_; }
+        [[nodiscard]] Frame GetOldestFrame() const;
+        [[nodiscard]] Frame GetLastReceivedFrame() const { return lastReceivedFrame_; }
+        /**
+         * \brief Last frame such that all the inputs up to it were received, frames after it may still be predicted
+         */
+        [[nodiscard]] Frame GetLastContiguousFrame() const { return lastContiguousFrame_; }
+    private:
+        static constexpr std::size_t Index(Frame frame) { return windowBufferSize - 1 - frame % windowBufferSize; }
+
+        std::array<PlayerInput, windowBufferSize> inputs_{};
+        Frame head_ = 0;
+        Frame lastReceivedFrame_ = 0;
+        Frame lastContiguousFrame_ = 0;
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "game_manager.h"
+#include "match_replay.h"
+
+namespace game
+{
+    /**
+     * \brief Headless game playing the inputs of a replay as fast as possible, one validation per frame like the server.
+     * The replay tools and the determinism tests all play the replays through it.
+     */
+    class MatchPlayback
+    {
+    public:
+        /**
+         * \brief Spawns the level and the recorded players, the replay must start at the first frame of the match
+         */
+        explicit MatchPlayback(MatchReplayReader& replay);
+        /**
+         * \brief Validates the next recorded frame, the frames already played are released from the memory now and then
+         * \return false once every recorded frame is played
+         */
+        bool Step();
+        /**
+         * \brief Plays the remaining recorded frames
+         */
+        void Play();
+        /**
+         * \brief Last frame played, 0 before the first step
+         */
+        [[nodiscard]] Frame GetFrame() const { return nextFrame_ - 1; }
+        [[nodiscard]] PlayerNumber GetWinner() const { return winner_; }
+        [[nodiscard]] Frame GetWinFrame() const { return winFrame_; }
+        [[nodiscard]] const RollbackManager& GetRollbackManager() const { return gameManager_.GetRollbackManager(); }
+    private:
+        MatchReplayReader& replay_;
+        GameManager gameManager_;
+        Frame nextFrame_ = 1;
+        PlayerNumber winner_ = INVALID_PLAYER;
+        Frame winFrame_ = 0;
+    };
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "game_globals.h"
+#include "maths/angle.h"
+#include "maths/vec2.h"
+#include "network/packet_type.h"
+#include "utils/mapped_file.h"
+
+namespace game
+{
+    struct MatchReplaySpawn
+    {
+        bool spawned = false;
+        core::Vec2f position;
+        core::degree_t rotation = core::degree_t(0.0f);
+    };
+
+    /**
+     * \brief Recording of a match: a header with the player count, the start time and the spawns,
+     * then one fixed size record per validated frame, contiguous from the first frame, so that a reader can seek to any frame.
+     * A record holds the inputs of every player, and with state hashes (desync traces), the hash of the frames ending a validation.
+     * A two player match takes 2 bytes per frame without the hashes, 360 KB per hour at 50 fps, less than 10 MB with them.
+     */
+    class MatchReplayWriter
+    {
+    public:
+        enum Flags : std::uint8_t
+        {
+            STATE_HASHES = 1u << 0u,
+        };
+        static constexpr std::uint32_t magic = 0x50524252u; //RBRP
+        static constexpr std::uint16_t version = 2;
+        static constexpr std::size_t spawnSize = sizeof(std::uint8_t) + 3 * sizeof(float);
+        static constexpr std::size_t headerSize = sizeof(magic) + sizeof(version) + sizeof(std::uint8_t) + sizeof(std::uint8_t) +
+            sizeof(std::uint64_t) + sizeof(Frame) + maxPlayerNmb * spawnSize;
+        /**
+         * \brief Size of the state hash of a record, after a byte telling if the frame is hashed
+         */
+        static constexpr std::size_t stateHashSize = sizeof(std::uint8_t) + sizeof(std::uint64_t) +
+            StateHash::PART_COUNT * sizeof(std::uint64_t);
+
+        [[nodiscard]] static std::size_t GetRecordSize(PlayerNumber playerCount, std::uint8_t flags)
+        {
+            return playerCount * sizeof(PlayerInput) + ((flags & STATE_HASHES) ? stateHashSize : 0);
+        }
+
+        /**
+         * \brief Creates the replay file, the spawns and the frames are written as they happen
+         * \return false if the file could not be created
+         */
+        bool Open(const std::string& path, std::uint8_t flags = 0);
+        [[nodiscard]] bool IsOpen() const { return file_.is_open(); }
+        [[nodiscard]] bool HasStateHashes() const { return flags_ & STATE_HASHES; }
+        /**
+         * \brief The player count gives the size of the frames, it cannot change once a frame is written
+         */
+        void SetPlayerCount(PlayerNumber playerCount);
+        void WriteSpawn(PlayerNumber playerNumber, core::Vec2f position, core::degree_t rotation);
+        /**
+         * \brief Start time sent to the clients, in milliseconds since epoch
+         */
+        void SetStartTime(unsigned long long startTime);
+        /**
+         * \brief Appends the inputs of the player count players, the frames must be contiguous.
+         * The state hash is only kept by a replay with state hashes, nullptr when the frame does not end a validation.
+         */
+        void WriteFrame(Frame frame, const PlayerInput* inputs, const StateHash* stateHash = nullptr);
+        /**
+         * \brief Writes the buffered frames to the file, called at the end of the match and before asserting on a desync
+         */
+        void Flush();
+        [[nodiscard]] std::uint64_t GetFrameCount() const { return frameCount_; }
+    private:
+        void WriteHeader();
+
+        std::ofstream file_;
+        std::uint8_t flags_ = 0;
+        PlayerNumber playerCount_ = 0;
+        unsigned long long startTime_ = 0;
+        Frame firstFrame_ = 0;
+        std::uint64_t frameCount_ = 0;
+        std::array<MatchReplaySpawn, maxPlayerNmb> spawns_{};
+    };
+
+    /**
+     * \brief Streams a replay through a memory mapping, the inputs are read in place without copy.
+     * Releasing the frames already played keeps the memory constant whatever the length of the recording.
+     */
+    class MatchReplayReader
+    {
+    public:
+        /**
+         * \return false if the file is missing or is not a replay of this version
+         */
+        bool Open(const std::string& path);
+        [[nodiscard]] PlayerNumber GetPlayerCount() const { return playerCount_; }
+        [[nodiscard]] bool HasStateHashes() const { return flags_ & MatchReplayWriter::STATE_HASHES; }
+        [[nodiscard]] unsigned long long GetStartTime() const { return startTime_; }
+        [[nodiscard]] const MatchReplaySpawn& GetSpawn(PlayerNumber playerNumber) const { return spawns_[playerNumber]; }
+        [[nodiscard]] Frame GetFirstFrame() const { return firstFrame_; }
+        [[nodiscard]] std::uint64_t GetFrameCount() const { return frameCount_; }
+        /**
+         * \brief Inputs of every player at the frame, the frame must be in [GetFirstFrame(), GetFirstFrame() + GetFrameCount())
+         */
+        [[nodiscard]] const PlayerInput* GetInputs(Frame frame) const;
+        /**
+         * \return false if the frame is out of the replay or was not hashed
+         */
+        bool ReadStateHash(Frame frame, StateHash& stateHash) const;
+        /**
+         * \brief Gives back the memory of the frames before this one, they can still be read afterward from the disk
+         */
+        void ReleaseFramesBefore(Frame frame);
+    private:
+        [[nodiscard]] const std::uint8_t* GetRecord(Frame frame) const;
+
+        core::MappedFile file_;
+        std::uint8_t flags_ = 0;
+        PlayerNumber playerCount_ = 0;
+        std::size_t recordSize_ = 0;
+        unsigned long long startTime_ = 0;
+        Frame firstFrame_ = 0;
+        std::uint64_t frameCount_ = 0;
+        std::uint64_t releasedFrameCount_ = 0;
+        std::array<MatchReplaySpawn, maxPlayerNmb> spawns_{};
+    };
+
+    /**
+     * \brief Binary searches the first frame hashed by both replays whose hashes differ.
+     * A desync never heals, so once the hashes differ they differ on every later frame.
+     * \return INVALID_FRAME if the frames the replays share all agree
+     */
+    [[nodiscard]] Frame FindFirstDivergentFrame(const MatchReplayReader& replay1, const MatchReplayReader& replay2);
+}
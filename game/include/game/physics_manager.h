@@ -2,6 +2,7 @@
 #include "game_globals.h"
 #include "engine/component.h"
 #include "engine/entity.h"
+#include "engine/paged_array.h"
 #include "maths/angle.h"
 #include "maths/vec2.h"
 
@@ -18,12 +19,12 @@ namespace game
     };
     struct BoxBody
     {
-        core::Vec2f position = core::Vec2f::zero();
-        core::Vec2f velocity = core::Vec2f::zero();
-        core::degree_t angularVelocity = core::degree_t(0.0f);
-        core::degree_t rotation = core::degree_t(0.0f);
+        SimVec2 position = SimVec2::zero();
+        SimVec2 velocity = SimVec2::zero();
+        SimAngle angularVelocity = SimAngle(Scalar(0));
+        SimAngle rotation = SimAngle(Scalar(0));
         BodyType bodyType = BodyType::DYNAMIC;
-        core::Vec2f extends;
+        SimVec2 extends;
        
     };
 
@@ -36,28 +37,167 @@ namespace game
         virtual void OnTrigger(core::Entity entity1, core::Entity entity2) = 0;
     };
 
-    class BoxBodyManager : public core::ComponentManager<BoxBody, static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)>
+    /**
+     * \brief Axis aligned bounds of a box body, computed like Box2Box always did
+     */
+    struct Aabb
+    {
+        Scalar minX = 0.0f;
+        Scalar minY = 0.0f;
+        Scalar maxX = 0.0f;
+        Scalar maxY = 0.0f;
+    };
+    [[nodiscard]] Aabb GetAabb(const BoxBody& body);
+    [[nodiscard]] bool Box2Box(const Aabb& aabb1, const Aabb& aabb2);
+
+    /**
+     * \brief State of the dynamic box bodies as structure of arrays in SparseSet order, what rollback copies and snapshots hold.
+     * The arrays are paged copy-on-write: a copy shares the pages and only the ones written since are duplicated,
+     * so the resting bodies cost nothing to snapshot and to restore.
+     */
+    struct BoxBodyArrays
+    {
+        core::PagedArray<Scalar> positionX;
+        core::PagedArray<Scalar> positionY;
+        core::PagedArray<Scalar> velocityX;
+        core::PagedArray<Scalar> velocityY;
+        core::PagedArray<Scalar> angularVelocity;
+        core::PagedArray<Scalar> rotation;
+        core::PagedArray<Scalar> extendX;
+        core::PagedArray<Scalar> extendY;
+        core::PagedArray<BodyType> bodyType;
+    };
+
+    /**
+     * \brief Dynamic box bodies, packed in a sparse set as structure of arrays so integration is vectorized.
+     * GetComponent and SetComponent gather and scatter a whole BoxBody for the gameplay code.
+     */
+    class BoxBodyManager
     {
     public:
-        using ComponentManager::ComponentManager;
+        explicit BoxBodyManager(core::EntityManager& entityManager);
+
+        void AddComponent(core::Entity entity);
+        void RemoveComponent(core::Entity entity);
+        [[nodiscard]] BoxBody GetComponent(core::Entity entity) const;
+        /**
+         * \brief Only the changed fields are written, the pages of the others stay shared
+         */
+        void SetComponent(core::Entity entity, const BoxBody& body);
+        /**
+         * \brief Index of the entity in the arrays
+         */
+        [[nodiscard]] std::size_t GetIndex(core::Entity entity) const { return sparseSet_.GetIndex(entity); }
+        [[nodiscard]] const std::vector<core::Entity>& GetEntities() const { return sparseSet_.GetEntities(); }
+
+        [[nodiscard]] const BoxBodyArrays& GetAllComponents() const { return bodies_; }
+        /**
+         * \brief Copies bodies taken from a manager with the same entities
+         */
+        void CopyAllComponents(const BoxBodyArrays& bodies);
+
+        /**
+         * \brief Advances the position and the rotation of every body, with SSE2 or AVX when available in floating point.
+         * The pages where no body moves are not written.
+         */
+        void Integrate(Scalar dt);
+        /**
+         * \brief Computes the bounds of every body, in the order of the arrays
+         */
+        void ComputeAabbs(std::vector<Aabb>& aabbs) const;
+    private:
+        core::EntityManager& entityManager_;
+        core::SparseSet sparseSet_;
+        BoxBodyArrays bodies_;
+    };
+
+    /**
+     * \brief Grid cells overlapped by an AABB, bounds included
+     */
+    struct CellRange
+    {
+        std::int32_t minX = 0;
+        std::int32_t minY = 0;
+        std::int32_t maxX = 0;
+        std::int32_t maxY = 0;
+    };
+    struct CellEntry
+    {
+        std::uint64_t cell = 0;
+        core::Entity entity = core::EntityManager::INVALID_ENTITY;
+        bool operator<(const CellEntry& other) const
+        {
+            return cell < other.cell || (cell == other.cell && entity < other.entity);
+        }
+    };
+    [[nodiscard]] CellRange GetCellRange(const Aabb& aabb, Scalar cellSize);
+    [[nodiscard]] std::uint64_t GetCellKey(std::int32_t x, std::int32_t y);
+
+    /**
+     * \brief Immutable STATIC box bodies, filled while the level is spawned and shared by the physics managers.
+     * They are never integrated nor copied on rollback, and are only tested against the dynamic bodies.
+     */
+    class StaticCollisionSet
+    {
+    public:
+        explicit StaticCollisionSet(Scalar cellSize = physicsCellSize) : cellSize_(cellSize) {}
+        void AddBody(core::Entity entity, const BoxBody& body);
+        [[nodiscard]] const BoxBody& GetBody(core::Entity entity) const;
+        [[nodiscard]] const Aabb& GetAabb(core::Entity entity) const;
+        /**
+         * \brief Fills entities with the static entities sharing a cell with aabb, sorted and without duplicates
+         */
+        void Query(const Aabb& aabb, std::vector<core::Entity>& entities) const;
+        [[nodiscard]] std::size_t GetSize() const { return entities_.size(); }
+    private:
+        Scalar cellSize_;
+        //Sorted by entity
+        std::vector<core::Entity> entities_;
+        std::vector<BoxBody> bodies_;
+        std::vector<Aabb> aabbs_;
+        std::vector<CellEntry> cellEntries_;
     };
     
+    /**
+     * \brief Integrates the dynamic box bodies and resolves their collisions.
+     * The broadphase is a uniform grid for the dynamic bodies and the shared StaticCollisionSet for the static ones,
+     * intersecting pairs are resolved in increasing entity order like the full double loop.
+     */
     class PhysicsManager
     {
     public:
-        explicit PhysicsManager(core::EntityManager& entityManager);
+        PhysicsManager(core::EntityManager& entityManager, StaticCollisionSet& staticCollisionSet);
         void FixedUpdate(sf::Time dt);
-        [[nodiscard]] const BoxBody& GetBody(core::Entity entity) const;
+        void SetCellSize(Scalar cellSize) { cellSize_ = cellSize; }
+        [[nodiscard]] Scalar GetCellSize() const { return cellSize_; }
+        [[nodiscard]] BoxBody GetBody(core::Entity entity) const;
         void SetBoxBody(core::Entity entity, const BoxBody& body);
         void AddBoxBody(core::Entity entity);
+        /**
+         * \brief Adds a body to the shared static collision set, it cannot be modified afterward
+         */
+        void AddStaticBody(core::Entity entity, const BoxBody& body);
         
         void RegisterTriggerListener(OnTriggerInterface& collisionInterface);
         void CopyAllComponents(const PhysicsManager& physicsManager);
+        [[nodiscard]] const BoxBodyArrays& GetAllBodies() const;
+        /**
+         * \brief Entities of the dynamic bodies, in the order of the arrays
+         */
+        [[nodiscard]] const std::vector<core::Entity>& GetEntities() const { return boxbodyManager_.GetEntities(); }
+        void CopyAllBodies(const BoxBodyArrays& bodies);
         void ResolveCollision(BoxBody& boxbody1, BoxBody& boxbody2);
     private:
+
         core::EntityManager& entityManager_;
         BoxBodyManager boxbodyManager_;
+        StaticCollisionSet& staticCollisionSet_;
         core::Action<core::Entity, core::Entity> onTriggerAction_;
+        Scalar cellSize_ = physicsCellSize;
+        //Reused every frame to avoid allocations
+        std::vector<Aabb> aabbs_;
+        std::vector<CellEntry> cellEntries_;
+        std::vector<core::Entity> candidates_;
+        std::vector<std::pair<core::Entity, core::Entity>> contacts_;
     };
-
 }
@@ -12,11 +12,17 @@ namespace game
         PlayerInput input = 0u;
         PlayerNumber playerNumber = INVALID_PLAYER;
         static constexpr float maxSpeed = 3.0f;
-        int player1win = 0;
-        int player2win = 0;
+        //Number of frames the player spent past the finish line
+        int winCount = 0;
+
+        bool operator==(const PlayerCharacter& other) const = default;
     };
     class GameManager;
-    class PlayerCharacterManager : public core::ComponentManager<PlayerCharacter, core::EntityMask(ComponentType::PLAYER_CHARACTER)>
+    /**
+     * \brief Players are stored in a paged sparse set, FixedUpdate only visits the player entities
+     * and the rollback copies share the pages of the players that did not change
+     */
+    class PlayerCharacterManager : public core::ComponentManager<PlayerCharacter, core::EntityMask(ComponentType::PLAYER_CHARACTER), core::PagedSparseSetStorage>
     {
     public:
         explicit PlayerCharacterManager(core::EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager);
@@ -1,5 +1,7 @@
 #pragma once
+#include "match_replay.h"
 #include "game_globals.h"
+#include "input_buffer.h"
 #include "physics_manager.h"
 #include "player_character.h"
 #include "engine/entity.h"
@@ -14,10 +16,27 @@ class GameManager;
 
     struct CreatedEntity
     {
-        core::Entity entity = core::EntityManager::INVALID_ENTITY;
+        core::EntityHandle handle = core::EntityManager::INVALID_HANDLE;
         Frame createdFrame = 0;
     };
 
+    struct DestroyedEntity
+    {
+        core::EntityHandle handle = core::EntityManager::INVALID_HANDLE;
+        Frame destroyedFrame = 0;
+    };
+
+    /**
+     * \brief Simulated state at the end of a frame, used to restart a rollback from the frame before a late input.
+     * It shares the pages of the component managers, saving and restoring it only copies page pointers.
+     */
+    struct FrameSnapshot
+    {
+        Frame frame = INVALID_FRAME;
+        BoxBodyArrays boxBodies;
+        PlayerCharacterManager::Components playerCharacters;
+    };
+
     class RollbackManager : public OnTriggerInterface
     {
     public:
@@ -27,21 +46,50 @@ class GameManager;
          */
         void SimulateToCurrentFrame();
         void SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, Frame inputFrame);
+        /**
+         * \brief Set the inputs of a player packet, newest first, skipping the frames already received
+         */
+        void SetPlayerInputs(PlayerNumber playerNumber, Frame newestFrame, const PlayerInput* playerInputs, std::size_t count);
         void StartNewFrame(Frame newFrame);
         /**
          * \brief Validate all the frame from lastValidateFrame_ to newValidateFrame
          */
         void ValidateFrame(Frame newValidateFrame);
         /**
-         * \brief Confirm Frame and Check with Physics State checksum, called by the clients when receiving Confirm Frame packet
+         * \brief Confirm Frame and Check with the server state hash, called by the clients when receiving Confirm Frame packet
+         * \param serverPartCount number of part hashes sent by the server, they tell which manager diverged
+         */
+        void ConfirmFrame(Frame newValidatedFrame, const StateHash& serverStateHash, std::size_t serverPartCount);
+        /**
+         * \brief Hashes the whole last validated state, one linear pass over the arrays of each component manager
          */
-        void ConfirmFrame(Frame newValidatedFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState);
-        [[nodiscard]] PhysicsState GetValidatePhysicsState(PlayerNumber playerNumber) const;
+        [[nodiscard]] StateHash GetValidateStateHash() const;
         [[nodiscard]] Frame GetLastValidateFrame() const { return lastValidateFrame_; }
-        [[nodiscard]] Frame GetLastReceivedFrame(PlayerNumber playerNumber) const { return lastReceivedFrame_[playerNumber]; }
+        [[nodiscard]] Frame GetLastReceivedFrame(PlayerNumber playerNumber) const { return inputs_[playerNumber].GetLastReceivedFrame(); }
+        [[nodiscard]] Frame GetLastContiguousFrame(PlayerNumber playerNumber) const { return inputs_[playerNumber].GetLastContiguousFrame(); }
+        /**
+         * \brief Resize the input buffers, the new players start at the current frame
+         */
+        void SetPlayerCount(PlayerNumber playerCount);
+        [[nodiscard]] PlayerNumber GetPlayerCount() const { return static_cast<PlayerNumber>(inputs_.size()); }
         [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
         [[nodiscard]] const core::TransformManager& GetTransformManager() const { return currentTransformManager_; }
         [[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return currentPlayerManager_; }
+        [[nodiscard]] const PhysicsManager& GetLastValidatePhysicsManager() const { return lastValidatePhysicsManager_; }
+        [[nodiscard]] const PlayerCharacterManager& GetLastValidatePlayerManager() const { return lastValidatePlayerManager_; }
+        /**
+         * \brief Records the spawns and the inputs of every validated frame, with the state hashes if the replay keeps them,
+         * nullptr stops the recording
+         */
+        void SetMatchReplay(MatchReplayWriter* matchReplay);
+        /**
+         * \brief Number of already simulated frames that were simulated again because of a misprediction
+         */
+        [[nodiscard]] std::uint64_t GetFramesResimulated() const { return framesResimulated_; }
+        /**
+         * \brief Number of simulations that only stepped the new frames forward instead of rollbacking
+         */
+        [[nodiscard]] std::uint64_t GetRollbacksAvoided() const { return rollbacksAvoided_; }
         void SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::degree_t rotation);
         void SpawnBox(core::Entity entity, core::Vec2f position);
         void SpawnFlag(core::Entity entity, core::Vec2f position);
@@ -60,12 +108,43 @@ class GameManager;
         
     private:
         PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame);
+        /**
+         * \brief Copy the players inputs of the frame into the current player manager and simulate it
+         */
+        void SimulateFrame(Frame frame);
+        void SaveSnapshot(Frame frame);
+        /**
+         * \brief Revert the current game state to the end of frame, or to the last validated frame
+         * if the snapshot is not available anymore
+         * \return the frame the current game state is at
+         */
+        Frame RestoreSnapshot(Frame frame);
+        /**
+         * \brief Called when a new dynamic body is spawned, the snapshots do not contain it
+         */
+        void InvalidateSnapshots();
+        /**
+         * \brief Removes the DESTROYED flags put after the frame, the rollback simulates these frames again
+         */
+        void RestoreDestroyedEntities(Frame frame);
+        /**
+         * \brief Definitely destroys the entities flagged DESTROYED up to the validated frame
+         */
+        void DestroyValidatedEntities(Frame validatedFrame);
+        /**
+         * \brief Writes the newly validated frames into the match replay
+         */
+        void RecordValidatedFrames(Frame firstFrame, Frame lastFrame);
         GameManager& gameManager_;
         core::EntityManager& entityManager_;
         /**
          * \brief Used for rendering
          */
         core::TransformManager currentTransformManager_;
+        /**
+         * \brief Static bodies of the level, shared by the current and last validate physics managers
+         */
+        StaticCollisionSet staticCollisionSet_;
         PhysicsManager currentPhysicsManager_;
         PlayerCharacterManager currentPlayerManager_;
         BoxBodyManager boxBodyManager_;
@@ -79,17 +158,34 @@ class GameManager;
         Frame lastValidateFrame_ = 0; //Confirm frame
         Frame currentFrame_ = 0;
         Frame testedFrame_ = 0;
+        /**
+         * \brief Frame the current component managers are at
+         */
+        Frame lastSimulatedFrame_ = 0;
+        /**
+         * \brief Earliest frame that received a new input since it was simulated
+         */
+        Frame dirtyFrame_ = INVALID_FRAME;
+        std::uint64_t framesResimulated_ = 0;
+        std::uint64_t rollbacksAvoided_ = 0;
+        MatchReplayWriter* matchReplay_ = nullptr;
 
-        static constexpr std::size_t windowBufferSize = 5 * 50; // 5 seconds of frame at 50 fps
-        std::array<std::uint32_t, maxPlayerNmb> lastReceivedFrame_{};
-        std::array<std::array<PlayerInput, windowBufferSize>, maxPlayerNmb> inputs_{};
+        std::array<FrameSnapshot, windowBufferSize> frameSnapshots_{};
+        /**
+         * \brief One input buffer per player of the match, contiguous so the per frame loops over the players stay linear
+         */
+        std::vector<PlayerInputBuffer> inputs_;
         /**
          * \brief Array containing all the created entities in the window between the confirm frame and the current frame
          * to destroy them when rollbacking.
          */
         std::vector<CreatedEntity> createdEntities_;
+        /**
+         * \brief Entities flagged DESTROYED in the window, with the frame that destroyed them
+         */
+        std::vector<DestroyedEntity> destroyedEntities_;
     public:
-        [[nodiscard]] const std::array<PlayerInput, windowBufferSize>& GetInputs(PlayerNumber playerNumber) const
+        [[nodiscard]] const PlayerInputBuffer& GetInputs(PlayerNumber playerNumber) const
         {
             return inputs_[playerNumber];
         }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+
+namespace game
+{
+    /**
+     * \brief UDP socket receiving and sending its datagrams in batches, with recvmmsg and sendmmsg on Linux.
+     * All the datagram buffers are allocated once, a received datagram stays valid until the next Receive.
+     * On the other platforms the batches go through SFML one datagram at a time.
+     */
+    class BatchUdpSocket
+    {
+    public:
+        struct Datagram
+        {
+            const std::uint8_t* data = nullptr;
+            std::size_t size = 0;
+            sf::IpAddress address;
+            unsigned short port = 0;
+        };
+        //Ethernet MTU minus the IP and UDP headers, bigger datagrams are sent alone and dropped on receive
+        static constexpr std::size_t maxDatagramSize = 1472;
+
+        explicit BatchUdpSocket(std::size_t batchSize = 64);
+        ~BatchUdpSocket();
+        BatchUdpSocket(const BatchUdpSocket&) = delete;
+        BatchUdpSocket& operator=(const BatchUdpSocket&) = delete;
+
+        /**
+         * \brief Underlying socket, to bind it or to wait on it
+         */
+        [[nodiscard]] sf::UdpSocket& GetSocket() { return socket_; }
+        [[nodiscard]] std::size_t GetBatchSize() const { return batchSize_; }
+        /**
+         * \brief Receives the waiting datagrams without blocking, up to the batch size
+         * \return the number of datagrams received
+         */
+        std::size_t Receive();
+        [[nodiscard]] const Datagram& GetDatagram(std::size_t index) const { return receivedDatagrams_[index]; }
+        /**
+         * \brief Copies the datagram in the send batch, the batch is sent when it is full or flushed
+         */
+        void Send(const void* data, std::size_t size, const sf::IpAddress& address, unsigned short port);
+        [[nodiscard]] std::size_t GetPendingCount() const { return sendCount_; }
+        /**
+         * \brief Sends the batch, a datagram the system refuses is dropped and the next ones are still sent,
+         * unless the socket buffer is full
+         * \return the number of datagrams sent, the others are dropped
+         */
+        std::size_t Flush();
+        /**
+         * \brief Datagrams dropped by all the flushes of the socket
+         */
+        [[nodiscard]] std::uint64_t GetDroppedCount() const { return droppedCount_; }
+    private:
+        struct SystemBatch;
+
+        sf::UdpSocket socket_;
+        std::size_t batchSize_;
+        std::vector<std::uint8_t> receiveBuffer_;
+        std::vector<Datagram> receivedDatagrams_;
+        std::vector<std::uint8_t> sendBuffer_;
+        std::vector<Datagram> sendDatagrams_;
+        std::size_t sendCount_ = 0;
+        std::uint64_t droppedCount_ = 0;
+        //System headers of the batches, only used on Linux
+        std::unique_ptr<SystemBatch> systemBatch_;
+    };
+}
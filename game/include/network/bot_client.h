@@ -0,0 +1,26 @@
+#pragma once
+#include <network/network_client.h>
+#include <SFML/Network/IpAddress.hpp>
+
+namespace game
+{
+    /**
+     * \brief Headless client joining a server with random inputs, run by the hundreds on a HeadlessEngine to load test the servers
+     */
+    class BotClient : public ClientNetworkManager
+    {
+    public:
+        BotClient(const sf::IpAddress& serverAddress, unsigned short serverPort, MatchId matchId = 0);
+        /**
+         * \brief Joins the server, the textures and the font are never loaded
+         */
+        void Init() override;
+        void Update(sf::Time dt) override;
+        [[nodiscard]] bool IsFinished() const { return gameManager_.GetState() & ClientGameManager::FINISHED; }
+    private:
+        sf::IpAddress joinAddress_;
+        unsigned short joinPort_;
+        MatchId joinMatchId_;
+        PlayerInput input_ = PlayerInputEnum::UP;
+    };
+}
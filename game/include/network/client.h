@@ -18,6 +18,15 @@ namespace game
             gameManager_.SetWindowSize(windowSize);
         }
         virtual void ReceivePacket(const Packet* packet);
+        /**
+         * \brief Loads the resources needed to draw the client, must be called before Init by the windowed applications
+         */
+        void LoadResources() { gameManager_.LoadResources(); }
+        /**
+         * \brief Records the frames confirmed by the server with their state hashes, must be called before joining the match
+         */
+        bool StartDesyncTrace(const std::string& path) { return gameManager_.StartMatchReplay(path, MatchReplayWriter::STATE_HASHES); }
+        [[nodiscard]] const ClientGameManager& GetGameManager() const { return gameManager_; }
     protected:
 
         ClientGameManager gameManager_;
@@ -30,8 +30,9 @@ class NetworkDebugApp : public core::DrawInterface, public core::DrawImGuiInterf
 
         void OnEvent(const sf::Event& event) override;
     private:
-        std::array<ClientNetworkManager, maxPlayerNmb> clients_;
-        std::array<sf::RenderTexture, maxPlayerNmb> clientsFramebuffers_;
+        //One split screen view per client, the debug apps always run a match with the default player count
+        std::array<ClientNetworkManager, defaultPlayerNmb> clients_;
+        std::array<sf::RenderTexture, defaultPlayerNmb> clientsFramebuffers_;
         sf::Sprite screenQuad_;
         sf::Vector2u windowSize_;
     };
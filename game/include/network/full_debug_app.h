@@ -26,8 +26,9 @@ namespace game
 
         void OnEvent(const sf::Event& event) override;
     private:
-        std::array<std::unique_ptr<SimulationClient>, maxPlayerNmb> clients_;
-        std::array<sf::RenderTexture, maxPlayerNmb> clientsFramebuffers_;
+        //One split screen view per client, the debug apps always run a match with the default player count
+        std::array<std::unique_ptr<SimulationClient>, defaultPlayerNmb> clients_;
+        std::array<sf::RenderTexture, defaultPlayerNmb> clientsFramebuffers_;
         SimulationServer server_;
         sf::Sprite screenQuad_;
         sf::Vector2u windowSize_;
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+
+#include "batch_udp_socket.h"
+#include "reliable_channel.h"
+#include "server.h"
+#include "shared_packet.h"
+#include "socket_poller.h"
+#include "utils/spsc_queue.h"
+
+namespace game
+{
+    const MatchId INVALID_MATCH = std::numeric_limits<MatchId>::max();
+
+    /**
+     * \brief Message exchanged between the match host network thread and the match workers
+     */
+    struct MatchMessage
+    {
+        enum class Type : std::uint8_t
+        {
+            //Network thread to worker
+            CREATE_MATCH,
+            RELIABLE_PACKET,
+            UNRELIABLE_PACKET,
+            DISCONNECT,
+            //Worker to network thread
+            SEND_RELIABLE,
+            SEND_UNRELIABLE,
+            MATCH_CLOSED
+        };
+        Type type = Type::RELIABLE_PACKET;
+        MatchId matchId = INVALID_MATCH;
+        //Only used by CREATE_MATCH
+        PlayerNumber playerCount = 0;
+        //Received packet, network thread to worker
+        sf::Packet packet;
+        //Packet to send, serialized once by the worker for all the players of the match
+        SharedPacket sharedPacket;
+    };
+
+    using MatchQueue = core::SpscQueue<MatchMessage>;
+
+    /**
+     * \brief Server of one match inside a MatchHost, its packets go through the host sockets
+     */
+    class MatchSession : public Server
+    {
+    public:
+        MatchSession(MatchId matchId, PlayerNumber playerCount, unsigned short udpPort, MatchQueue& outbox);
+        void Init() override;
+        /**
+         * \brief Ends a full match when no frame was validated for a while, one of the players stopped sending inputs
+         */
+        void Update(sf::Time dt) override;
+        void Destroy() override;
+
+        void SendReliablePacket(std::unique_ptr<Packet> packet) override;
+        void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
+
+        void ReceivePacket(sf::Packet& packet, bool reliable);
+        /**
+         * \brief Called when one of the players left, ends the match like ServerNetworkManager does
+         */
+        void Disconnect();
+        [[nodiscard]] bool IsOpen() const { return isOpen_; }
+    private:
+        void Send(std::unique_ptr<Packet> packet, MatchMessage::Type type);
+
+        MatchId matchId_;
+        unsigned short udpPort_;
+        MatchQueue& outbox_;
+        bool isOpen_ = true;
+        Frame lastValidateFrame_ = 0;
+        //Time since the last validated frame changed
+        sf::Time stalledTime_ = sf::Time::Zero;
+    };
+
+    /**
+     * \brief Owns a shard of the matches and runs them on its own thread.
+     * The matches are only touched by this thread, it talks to the network thread through two SpscQueue.
+     */
+    class MatchWorker
+    {
+    public:
+        /**
+         * \param replayDirectory directory the matches are recorded in, empty to not record them
+         */
+        MatchWorker(unsigned short udpPort, std::size_t queueCapacity, std::string replayDirectory);
+        void Start();
+        void Stop();
+
+        [[nodiscard]] MatchQueue& GetInbox() { return inbox_; }
+        [[nodiscard]] MatchQueue& GetOutbox() { return outbox_; }
+    private:
+        using SessionMap = std::unordered_map<MatchId, std::unique_ptr<MatchSession>>;
+
+        void Run();
+        void ProcessMessage(MatchMessage& message);
+        /**
+         * \brief Destroys the session and tells the network thread the match is over
+         * \return the iterator following the closed session
+         */
+        SessionMap::iterator CloseSession(SessionMap::iterator it);
+
+        MatchQueue inbox_;
+        MatchQueue outbox_;
+        SessionMap sessions_;
+        unsigned short udpPort_;
+        std::string replayDirectory_;
+        //Number of matches created, a match id is reused once its match is over
+        std::uint64_t createdMatchCount_ = 0;
+        std::atomic<bool> running_{ false };
+        std::thread thread_;
+    };
+
+    /**
+     * \brief Process hosting many matches behind a single UDP port.
+     * The network thread owns the socket and a reliable channel per remote address,
+     * it routes the packets by match id to the MatchWorker owning the match.
+     * A match is created when the first player joins it and destroyed when one of its players times out.
+     */
+    class MatchHost
+    {
+    public:
+        /**
+         * \param workerCount number of worker threads, 0 uses the number of hardware threads minus the network one
+         */
+        explicit MatchHost(std::size_t workerCount = 0);
+        /**
+         * \brief Port to bind in Init, the next free one is taken if it is busy and 0 lets the system choose
+         */
+        void SetPort(unsigned short port) { udpPort_ = port; }
+        /**
+         * \brief Port the host is bound to after Init
+         */
+        [[nodiscard]] unsigned short GetPort() const { return udpPort_; }
+        /**
+         * \brief Number of players of the matches created from now on
+         */
+        void SetPlayerCount(PlayerNumber playerCount) { playerCount_ = playerCount; }
+        /**
+         * \brief Records every match in a replay file of the directory, named after its match id, must be called before Init
+         */
+        void SetReplayDirectory(const std::string& replayDirectory) { replayDirectory_ = replayDirectory; }
+        void Init();
+        /**
+         * \brief Runs the network thread until Stop is called
+         */
+        void Run();
+        void Stop() { running_ = false; }
+        void Destroy();
+        [[nodiscard]] std::size_t GetMatchCount() const { return matches_.size(); }
+        /**
+         * \brief Match of a join packet
+         * \return INVALID_MATCH if the packet is not a whole join packet
+         */
+        [[nodiscard]] static MatchId ReadJoinMatchId(const sf::Packet& packet);
+    private:
+        /**
+         * \brief Remote player, opened by its first reliable datagram and joined to a match by its first packet.
+         * Until then it is pending: it is not answered and it is forgotten when its join packet does not come in time
+         */
+        struct Connection
+        {
+            ReliableChannel channel;
+            sf::IpAddress address;
+            unsigned short port = 0;
+            ReliableChannel::Clock::time_point openTime;
+            MatchId matchId = INVALID_MATCH;
+            bool connected = false;
+        };
+        struct MatchRoute
+        {
+            std::size_t worker = 0;
+            PlayerNumber playerCount = 0;
+            std::vector<std::size_t> connections;
+            //Client of each connection
+            std::vector<ClientId> clientIds;
+            //A player left, the worker is closing the match
+            bool closing = false;
+        };
+
+        void ReceiveUdp();
+        void ReceiveReliable(std::size_t connectionIndex);
+        /**
+         * \brief Sends the acks and the resends of the channels and drops the connections that timed out
+         */
+        void UpdateConnections();
+        void SendChannelDatagrams(Connection& connection, ReliableChannel::Clock::time_point now);
+        void ProcessOutbox(MatchWorker& worker);
+        void FlushUdp();
+        /**
+         * \brief Opens a pending connection
+         * \return connections_.size() if too many connections are pending
+         */
+        std::size_t OpenConnection(const sf::IpAddress& address, unsigned short port, ReliableChannel::Clock::time_point now);
+        void DisconnectConnection(std::size_t connectionIndex);
+        void CloseConnection(std::size_t connectionIndex);
+        void CloseMatch(MatchId matchId);
+        /**
+         * \brief Finds or creates the match, returns nullptr if the match is full or the client already joined it
+         */
+        MatchRoute* JoinMatch(MatchId matchId, ClientId clientId);
+        void PushToWorker(std::size_t worker, MatchMessage&& message);
+
+        static std::uint64_t GetEndpointKey(const sf::IpAddress& address, unsigned short port);
+
+        std::vector<std::unique_ptr<MatchWorker>> workers_;
+        std::unordered_map<MatchId, MatchRoute> matches_;
+        //Connection index of each remote address
+        std::unordered_map<std::uint64_t, std::size_t> connectionRoutes_;
+        std::vector<Connection> connections_;
+        std::vector<std::size_t> freeConnections_;
+        std::size_t pendingConnectionCount_ = 0;
+
+        SocketPoller poller_;
+        std::vector<SocketPoller::Key> readyKeys_;
+        BatchUdpSocket udpSocket_;
+        unsigned short udpPort_ = 12345;
+        PlayerNumber playerCount_ = defaultPlayerNmb;
+        std::string replayDirectory_;
+        std::atomic<bool> running_{ false };
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
+#include "batch_udp_socket.h"
 #include "client.h"
-#include <SFML/Network/TcpSocket.hpp>
+#include "reliable_channel.h"
 #include <SFML/Network/UdpSocket.hpp>
 
 namespace game
@@ -19,8 +20,8 @@ namespace game
 		};
 		enum class PacketSource
 		{
-			TCP,
-			UDP
+			RELIABLE,
+			UNRELIABLE
 		};
 		void Init() override;
 
@@ -36,16 +37,26 @@ namespace game
 
 		void SendUnreliablePacket(std::unique_ptr<Packet> packet) override;
 		void SetPlayerInput(PlayerInput input);
+		/**
+		 * \brief Sends the join packet of the match to the server, the address is resolved once for all the sends
+		 */
+		void Join(const sf::IpAddress& serverAddress, unsigned short serverPort, MatchId matchId = 0);
 
 
 	private:
 		void ReceivePacket(sf::Packet& packet, PacketSource source);
-		sf::UdpSocket udpSocket_;
-		sf::TcpSocket tcpSocket_;
+		//Carries both the unreliable packets and the reliable channel to the server
+		BatchUdpSocket udpSocket_;
+		ReliableChannel reliableChannel_;
+		//Reused for every packet so their buffers keep their capacity
+		sf::Packet sendingPacket_;
+		sf::Packet receivedPacket_;
 
 		std::string serverAddress_ = "localhost";
-		unsigned short serverTcpPort_ = 12345;
-		unsigned short serverUdpPort_ = 0;
+		//Resolved when joining, a string address would be resolved again by every send
+		sf::IpAddress serverIpAddress_;
+		unsigned short serverPort_ = 12345;
+		MatchId matchId_ = 0;
 
 
 		State currentState_ = State::NONE;
@@ -1,9 +1,15 @@
 #pragma once
+#include <chrono>
+#include <vector>
+
 #include <SFML/Network/IpAddress.hpp>
-#include <SFML/Network/TcpListener.hpp>
 
+#include "batch_udp_socket.h"
 #include "network_client.h"
+#include "reliable_channel.h"
 #include "server.h"
+#include "shared_packet.h"
+#include "socket_poller.h"
 #include "game/game_globals.h"
 
 namespace game
@@ -14,16 +20,45 @@ namespace game
         unsigned long long timeDifference = 0;
         sf::IpAddress udpRemoteAddress;
         unsigned short udpRemotePort = 0;
+        std::uint32_t connectionIndex = maxPlayerNmb;
 
 
     };
+    struct SendQueueStats
+    {
+        /**
+         * \brief Bytes waiting in the reliable channels after the last flush
+         */
+        std::size_t queuedBytes = 0;
+        std::size_t maxQueuedBytes = 0;
+        std::uint64_t flushCount = 0;
+        std::chrono::microseconds maxFlushTime{ 0 };
+        std::chrono::microseconds totalFlushTime{ 0 };
+        /**
+         * \brief Flushes that left messages queued behind a full window, a blocking send would have waited there
+         */
+        std::uint64_t stallsAvoided = 0;
+        /**
+         * \brief Unreliable packets not sent to a client above the high water mark
+         */
+        std::uint64_t shedPackets = 0;
+        /**
+         * \brief Clients dropped because their reliable queue went above the maximum queued bytes
+         */
+        std::uint64_t overflowDisconnects = 0;
+        /**
+         * \brief Datagrams the socket refused, a refused datagram does not stop the rest of the batch
+         */
+        std::uint64_t droppedDatagrams = 0;
+    };
+
     class ServerNetworkManager : public Server
     {
     public:
         enum class PacketSocketSource
         {
-            TCP,
-            UDP
+            RELIABLE,
+            UNRELIABLE
         };
         void SendReliablePacket(std::unique_ptr<Packet> packet) override;
 
@@ -32,16 +67,70 @@ namespace game
         void Init() override;
 
         void Update(sf::Time dt) override;
+        /**
+         * \brief Accepts the new connections and processes all the packets waiting on the sockets
+         */
+        void ReceivePackets();
+        /**
+         * \brief Blocks until a socket is ready to be read or the timeout is reached
+         * \return true if a socket is ready
+         */
+        bool WaitForPackets(sf::Time timeout);
 
         void Destroy() override;
 
-        void SetTcpPort(unsigned short i);
+        /**
+         * \brief Port to bind in Init, the next free one is taken if it is busy and 0 lets the system choose
+         */
+        void SetPort(unsigned short port);
+        /**
+         * \brief Port the socket is bound to after Init
+         */
+        [[nodiscard]] unsigned short GetPort() const { return udpPort_; }
+        /**
+         * \brief Queued reliable bytes above which a client only gets its reliable packets until it catches up
+         */
+        void SetHighWaterMark(std::size_t highWaterMark) { highWaterMark_ = highWaterMark; }
+        /**
+         * \brief Queued reliable bytes above which a client is disconnected, must be set before Init
+         */
+        void SetMaxQueuedBytes(std::size_t maxQueuedBytes) { maxQueuedBytes_ = maxQueuedBytes; }
+        [[nodiscard]] const SendQueueStats& GetSendQueueStats() const { return sendQueueStats_; }
 
         bool IsOpen() const;
-    protected:
-        void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) override;
-
     private:
+        /**
+         * \brief Remote player sending reliable packets, it only takes a player slot once its join packet was received
+         */
+        struct Connection
+        {
+            ReliableChannel channel;
+            sf::IpAddress address;
+            unsigned short port = 0;
+            ReliableChannel::Clock::time_point openTime;
+            bool connected = false;
+        };
+        /**
+         * \brief Addresses sending reliable datagrams without a join packet yet, the others are dropped
+         */
+        static constexpr std::size_t maxPendingConnections = 8;
+        /**
+         * \brief A pending connection is forgotten if its join packet does not come in time, nothing else happens
+         */
+        static constexpr std::chrono::seconds pendingConnectionTimeout{ 2 };
+        [[nodiscard]] std::uint32_t FindConnection(const sf::IpAddress& address, unsigned short port) const;
+        /**
+         * \brief Gives the datagrams of the channels to the socket and sends them
+         */
+        void FlushConnections(ReliableChannel::Clock::time_point now);
+        void ReceiveReliableDatagram(const BatchUdpSocket::Datagram& datagram, ReliableChannel::Clock::time_point now);
+        /**
+         * \brief Waits for the join packet of a new address, without answering it.
+         * A join packet of a client not in the match yet binds a player slot, anything else drops the pending connection
+         */
+        void ReceivePendingDatagram(const BatchUdpSocket::Datagram& datagram, ReliableChannel::Clock::time_point now);
+        void ExpirePendingConnections(ReliableChannel::Clock::time_point now);
+        void Disconnect(std::size_t connectionIndex);
         void ProcessReceivePacket(std::unique_ptr<Packet> packet,
             PacketSocketSource packetSource,
             sf::IpAddress address = "localhost",
@@ -56,16 +145,24 @@ namespace game
             STARTED = 1u << 1u,
             FIRST_PLAYER_CONNECT = 1u << 2u,
         };
-        sf::UdpSocket udpSocket_;
-        sf::TcpListener tcpListener_;
-        std::array<sf::TcpSocket, maxPlayerNmb> tcpSockets_;
+        //Carries both the unreliable packets and the reliable channels
+        BatchUdpSocket udpSocket_;
+        //Waits on the native socket handle with epoll between two ticks
+        SocketPoller socketPoller_;
+        std::vector<SocketPoller::Key> readySockets_;
+        std::array<Connection, maxPlayerNmb> connections_;
+        std::array<Connection, maxPendingConnections> pendingConnections_;
+        //Reused for every packet so its buffer keeps its capacity
+        sf::Packet receivedPacket_;
 
         std::array<ClientInfo, maxPlayerNmb> clientInfoMap_{};
 
 
-        unsigned short tcpPort_ = 12345;
         unsigned short udpPort_ = 12345;
-        std::uint32_t lastSocketIndex_ = 0;
+        std::uint32_t lastConnectionIndex_ = 0;
+        std::size_t highWaterMark_ = 64 * 1024;
+        std::size_t maxQueuedBytes_ = 1024 * 1024;
+        SendQueueStats sendQueueStats_;
         std::uint8_t status_ = 0;
     };
 }
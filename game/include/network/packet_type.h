@@ -1,8 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <memory>
 #include <SFML/Network/Packet.hpp>
 
 #include "game/game_globals.h"
+#include "utils/conversion.h"
 
 
 namespace game
@@ -19,11 +21,30 @@ namespace game
         NONE,
     };
 
-    using PhysicsState = std::uint16_t;
+    /**
+     * \brief 64 bit hash of the validated simulation state, combining the hash of each component manager
+     */
+    struct StateHash
+    {
+        enum Part : std::uint8_t
+        {
+            BOX_BODY,
+            PLAYER_CHARACTER,
+            PART_COUNT
+        };
+        std::uint64_t full = 0;
+        std::array<std::uint64_t, PART_COUNT> parts{};
+    };
 
+    /**
+     * \brief Base of the game packets, allocated in fixed size slots recycled by each thread
+     * so that sending and receiving packets does not reach the heap once the slots are warm
+     */
     struct Packet
     {
         virtual ~Packet() = default;
+        static void* operator new(std::size_t size);
+        static void operator delete(void* ptr, std::size_t size) noexcept;
         PacketType packetType = PacketType::NONE;
     };
 
@@ -36,7 +57,8 @@ namespace game
 
     inline sf::Packet& operator>>(sf::Packet& packetReceived, Packet& packet)
     {
-        std::uint8_t packetType;
+        //An empty packet reads as NONE, not as the first packet type
+        auto packetType = static_cast<std::uint8_t>(PacketType::NONE);
         packetReceived >> packetType;
         packet.packetType = static_cast<PacketType>(packetType);
         return packetReceived;
@@ -69,25 +91,41 @@ namespace game
     }
 
     /**
-     * \brief TCP Packet sent by a client to the server to join a game
+     * \brief Reliable packet sent by a client to the server to join a game
      */
     struct JoinPacket : TypedPacket<PacketType::JOIN>
     {
         std::array<std::uint8_t, sizeof(ClientId)> clientId{};
         std::array<std::uint8_t, sizeof(unsigned long)> startTime{};
+        //Used by the match host to route the client to its match, ignored by a single match server
+        std::array<std::uint8_t, sizeof(MatchId)> matchId{};
     };
 
     inline sf::Packet& operator<<(sf::Packet& packet, const JoinPacket& joinPacket)
     {
-        return packet << joinPacket.clientId << joinPacket.startTime;
+        return packet << joinPacket.clientId << joinPacket.startTime << joinPacket.matchId;
     }
 
     inline sf::Packet& operator>>(sf::Packet& packet, JoinPacket& joinPacket)
     {
-        return packet >> joinPacket.clientId >> joinPacket.startTime;
+        return packet >> joinPacket.clientId >> joinPacket.startTime >> joinPacket.matchId;
     }
+
     /**
-     * \brief TCP Packet sent by the server to the client to answer a join packet
+     * \brief Reads a whole join packet, the first packet of a connection comes from anyone so it is not trusted
+     * \return false if the packet is not a whole join packet
+     */
+    inline bool ReadJoinPacket(const sf::Packet& packet, JoinPacket& joinPacket)
+    {
+        sf::Packet packetCopy = packet;
+        Packet header{};
+        //A short datagram leaves the stream invalid
+        if (!(packetCopy >> header) || header.packetType != PacketType::JOIN)
+            return false;
+        return static_cast<bool>(packetCopy >> joinPacket);
+    }
+    /**
+     * \brief Reliable packet sent by the server to the client to answer a join packet
      */
     struct JoinAckPacket : TypedPacket<PacketType::JOIN_ACK>
     {
@@ -130,27 +168,144 @@ namespace game
 
     //
     const size_t maxInputNmb = 50;
+    /**
+     * \brief Version of the PlayerInputPacket wire format, packets with another version are dropped
+     */
+    constexpr std::uint8_t playerInputPacketVersion = 2;
+
+    /**
+     * \brief Frames are written as a little endian base 128 varint, most frames fit in 2 bytes
+     */
+    inline void WriteVarFrame(sf::Packet& packet, Frame frame)
+    {
+        while (frame >= 0x80u)
+        {
+            packet << static_cast<std::uint8_t>(frame | 0x80u);
+            frame >>= 7u;
+        }
+        packet << static_cast<std::uint8_t>(frame);
+    }
+
+    inline Frame ReadVarFrame(sf::Packet& packet)
+    {
+        Frame frame = 0;
+        for (std::uint32_t shift = 0; shift < sizeof(Frame) * 8; shift += 7)
+        {
+            std::uint8_t byte = 0;
+            packet >> byte;
+            frame |= static_cast<Frame>(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0)
+                break;
+        }
+        return frame;
+    }
+
+    /**
+     * \brief Frames close to a reference frame are written as the zigzag encoded difference, most fit in 1 byte
+     */
+    inline void WriteRelativeFrame(sf::Packet& packet, Frame referenceFrame, Frame frame)
+    {
+        const auto delta = static_cast<std::int32_t>(referenceFrame - frame);
+        WriteVarFrame(packet, static_cast<Frame>(delta) << 1u ^ static_cast<Frame>(delta >> 31));
+    }
+
+    inline Frame ReadRelativeFrame(sf::Packet& packet, Frame referenceFrame)
+    {
+        const auto zigzag = ReadVarFrame(packet);
+        return referenceFrame - (zigzag >> 1u ^ (0u - (zigzag & 1u)));
+    }
+
     /**
      * \brief Packet sent by the player client and then replicated by the server to all clients to share the currentFrame
-     * and all the previous ones player inputs.
+     * and the previous player inputs the receiver does not hold yet.
+     * The client sends the inputs after the frame acknowledged by the server, and the last contiguous frame it holds
+     * for each player. The server replicates the inputs of a player up to the last contiguous frame it received,
+     * so the currentFrame of a replicated packet is the ack of the sending player.
+     * On the wire the inputs are run length encoded, one byte per run with the 4 bits input in the high nibble
+     * and the run length minus one in the low nibble.
      */
     struct PlayerInputPacket : TypedPacket<PacketType::INPUT>
     {
         PlayerNumber playerNumber = INVALID_PLAYER;
         std::array<std::uint8_t, sizeof(Frame)> currentFrame{};
+        //Number of inputs from currentFrame to the past, newest first
+        std::uint8_t inputCount = 0;
         std::array<std::uint8_t, maxInputNmb> inputs{};
+        //Only sent by the clients, last contiguous input frame held for each player
+        PlayerNumber receivedCount = 0;
+        std::array<Frame, maxPlayerNmb> receivedFrames{};
     };
 
     inline sf::Packet& operator<<(sf::Packet& packet, const PlayerInputPacket& playerInputPacket)
     {
-        return packet << playerInputPacket.playerNumber <<
-            playerInputPacket.currentFrame << playerInputPacket.inputs;
+        const auto inputCount = std::min<std::size_t>(playerInputPacket.inputCount, maxInputNmb);
+        packet << playerInputPacketVersion << playerInputPacket.playerNumber;
+        WriteVarFrame(packet, core::ConvertFromBinary<Frame>(playerInputPacket.currentFrame));
+        packet << static_cast<std::uint8_t>(inputCount);
+        std::size_t index = 0;
+        while (index < inputCount)
+        {
+            const auto input = static_cast<std::uint8_t>(playerInputPacket.inputs[index] & 0x0Fu);
+            std::size_t runLength = 1;
+            while (runLength < 16 && index + runLength < inputCount &&
+                (playerInputPacket.inputs[index + runLength] & 0x0Fu) == input)
+            {
+                runLength++;
+            }
+            packet << static_cast<std::uint8_t>(input << 4u | (runLength - 1));
+            index += runLength;
+        }
+        const auto receivedCount = std::min<PlayerNumber>(playerInputPacket.receivedCount, maxPlayerNmb);
+        packet << receivedCount;
+        for (PlayerNumber i = 0; i < receivedCount; i++)
+        {
+            WriteRelativeFrame(packet, core::ConvertFromBinary<Frame>(playerInputPacket.currentFrame),
+                playerInputPacket.receivedFrames[i]);
+        }
+        return packet;
     }
 
     inline sf::Packet& operator>>(sf::Packet& packet, PlayerInputPacket& playerInputPacket)
     {
-        return packet >> playerInputPacket.playerNumber >>
-            playerInputPacket.currentFrame >> playerInputPacket.inputs;
+        std::uint8_t version = 0;
+        packet >> version;
+        if (version != playerInputPacketVersion)
+        {
+            playerInputPacket.playerNumber = INVALID_PLAYER;
+            playerInputPacket.inputCount = 0;
+            playerInputPacket.receivedCount = 0;
+            return packet;
+        }
+        packet >> playerInputPacket.playerNumber;
+        playerInputPacket.currentFrame = core::ConvertToBinary(ReadVarFrame(packet));
+        std::uint8_t inputCount = 0;
+        packet >> inputCount;
+        playerInputPacket.inputCount = static_cast<std::uint8_t>(std::min<std::size_t>(inputCount, maxInputNmb));
+        std::size_t index = 0;
+        while (index < playerInputPacket.inputCount)
+        {
+            std::uint8_t run = 0;
+            if (!(packet >> run))
+                break;
+            const auto runLength = std::min<std::size_t>((run & 0x0Fu) + 1u, playerInputPacket.inputCount - index);
+            std::fill_n(playerInputPacket.inputs.begin() + index, runLength, static_cast<std::uint8_t>(run >> 4u));
+            index += runLength;
+        }
+        //A truncated packet only keeps the inputs it fully contains
+        playerInputPacket.inputCount = static_cast<std::uint8_t>(index);
+        PlayerNumber receivedCount = 0;
+        packet >> receivedCount;
+        playerInputPacket.receivedCount = std::min<PlayerNumber>(receivedCount, maxPlayerNmb);
+        const auto currentFrame = core::ConvertFromBinary<Frame>(playerInputPacket.currentFrame);
+        for (PlayerNumber i = 0; i < playerInputPacket.receivedCount; i++)
+        {
+            playerInputPacket.receivedFrames[i] = ReadRelativeFrame(packet, currentFrame);
+        }
+        if (!packet)
+        {
+            playerInputPacket.receivedCount = 0;
+        }
+        return packet;
     }
 
     struct StartGamePacket : TypedPacket<PacketType::START_GAME>
@@ -172,17 +327,31 @@ namespace game
     struct ValidateFramePacket : TypedPacket<PacketType::VALIDATE_STATE>
     {
         std::array<std::uint8_t, sizeof(Frame)> newValidateFrame{};
-        std::array<std::uint8_t, sizeof(PhysicsState)* maxPlayerNmb> physicsState{};
+        std::array<std::uint8_t, sizeof(std::uint64_t)> stateHash{};
+        //0 when the server only sends the full hash, the part hashes tell which manager diverged
+        std::uint8_t partCount = 0;
+        std::array<std::array<std::uint8_t, sizeof(std::uint64_t)>, StateHash::PART_COUNT> partHashes{};
     };
 
     inline sf::Packet& operator<<(sf::Packet& packet, const ValidateFramePacket& validateFramePacket)
     {
-        return packet << validateFramePacket.newValidateFrame << validateFramePacket.physicsState;
+        packet << validateFramePacket.newValidateFrame << validateFramePacket.stateHash << validateFramePacket.partCount;
+        for (std::size_t i = 0; i < std::min<std::size_t>(validateFramePacket.partCount, StateHash::PART_COUNT); i++)
+        {
+            packet << validateFramePacket.partHashes[i];
+        }
+        return packet;
     }
 
-    inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& ValidateFramePacket)
+    inline sf::Packet& operator>>(sf::Packet& packet, ValidateFramePacket& validateFramePacket)
     {
-        return packet >> ValidateFramePacket.newValidateFrame >> ValidateFramePacket.physicsState;
+        packet >> validateFramePacket.newValidateFrame >> validateFramePacket.stateHash >> validateFramePacket.partCount;
+        validateFramePacket.partCount = std::min<std::uint8_t>(validateFramePacket.partCount, StateHash::PART_COUNT);
+        for (std::size_t i = 0; i < validateFramePacket.partCount; i++)
+        {
+            packet >> validateFramePacket.partHashes[i];
+        }
+        return packet;
     }
 
     struct WinGamePacket : TypedPacket<PacketType::WIN_GAME>
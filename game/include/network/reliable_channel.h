@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+
+#include "shared_packet.h"
+
+namespace game
+{
+    /**
+     * \brief Reliable and ordered stream of packets multiplexed over the unreliable udp socket.
+     * Each message gets a sequence number, every channel datagram carries the last sequence received in order
+     * with a bitfield of the messages received after it, and the messages not acknowledged are sent again
+     * after the resend delay.
+     * The channel never touches a socket: the received channel datagrams are given to it and Update gives back
+     * the datagrams to send, so a reliable send never blocks the tick.
+     */
+    class ReliableChannel
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Sequence = std::uint16_t;
+        /**
+         * \brief First byte of the channel datagrams, the unreliable datagrams start with their PacketType
+         */
+        static constexpr std::uint8_t datagramTag = 0xFFu;
+        /**
+         * \brief Number of messages the sender can send ahead of the oldest one not acknowledged
+         */
+        static constexpr Sequence windowSize = 32;
+        static constexpr std::size_t headerSize = sizeof(datagramTag) + sizeof(Sequence) + sizeof(std::uint32_t);
+        static constexpr std::size_t messageHeaderSize = sizeof(Sequence) + sizeof(std::uint16_t);
+
+        [[nodiscard]] static bool IsChannelDatagram(const std::uint8_t* data, std::size_t size)
+        {
+            return size >= headerSize && data[0] == datagramTag;
+        }
+
+        /**
+         * \brief Queues the packet, it is sent by the next Update
+         * \return false if the packet was not queued. Above the maximum queued bytes the channel is overflowed:
+         * the stream has a hole and every other packet is refused, the connection has to be dropped
+         */
+        bool Send(const SharedPacket& packet);
+        /**
+         * \brief Reads the acks and the messages of a channel datagram, malformed datagrams are ignored
+         */
+        void ReceiveDatagram(const std::uint8_t* data, std::size_t size, Clock::time_point now);
+        /**
+         * \brief Gives the next message in order
+         * \return false if the next message was not received yet
+         */
+        bool PopPacket(sf::Packet& packet);
+        /**
+         * \brief Writes the datagrams to send now: the new messages, the ones to resend and the acks
+         * \return number of datagrams to get with GetDatagram
+         */
+        std::size_t Update(Clock::time_point now);
+        [[nodiscard]] const std::vector<std::uint8_t>& GetDatagram(std::size_t index) const { return datagrams_[index]; }
+        /**
+         * \brief The remote side did not send anything for longer than the timeout
+         */
+        [[nodiscard]] bool IsTimedOut(Clock::time_point now) const;
+
+        [[nodiscard]] std::size_t GetPendingCount() const { return outgoing_.size(); }
+        /**
+         * \brief Size of the messages queued and not acknowledged yet
+         */
+        [[nodiscard]] std::size_t GetQueuedBytes() const { return queuedBytes_; }
+        /**
+         * \brief More messages are queued than the window lets in flight, the others wait for the acks
+         */
+        [[nodiscard]] bool IsWindowFull() const { return outgoing_.size() > windowSize; }
+        [[nodiscard]] bool IsOverflowed() const { return overflowed_; }
+        void SetMaxQueuedBytes(std::size_t maxQueuedBytes) { maxQueuedBytes_ = maxQueuedBytes; }
+        [[nodiscard]] std::uint64_t GetResendCount() const { return resendCount_; }
+        void SetResendDelay(Clock::duration resendDelay) { resendDelay_ = resendDelay; }
+        void SetTimeout(Clock::duration timeout) { timeout_ = timeout; }
+    private:
+        struct OutgoingMessage
+        {
+            Sequence sequence = 0;
+            SharedPacket packet;
+            Clock::time_point lastSendTime;
+            bool sent = false;
+            bool acked = false;
+        };
+
+        std::vector<std::uint8_t>& StartDatagram();
+        void ReceiveAck(Sequence ack, std::uint32_t ackBits);
+        void ReceiveMessage(Sequence sequence, const std::uint8_t* data, std::size_t size);
+
+        //Oldest message not acknowledged first
+        std::deque<OutgoingMessage> outgoing_;
+        std::size_t queuedBytes_ = 0;
+        //A remote side that stopped acknowledging would otherwise grow the queue forever
+        std::size_t maxQueuedBytes_ = 1024 * 1024;
+        bool overflowed_ = false;
+        Sequence nextSendSequence_ = 0;
+
+        //Messages received ahead of the next one to pop, indexed by sequence
+        std::array<std::vector<std::uint8_t>, windowSize> receiveWindow_;
+        std::array<bool, windowSize> received_{};
+        Sequence nextReceiveSequence_ = 0;
+        bool ackPending_ = false;
+
+        //Reused between the updates so that their buffers keep their capacity
+        std::vector<std::vector<std::uint8_t>> datagrams_;
+        std::size_t datagramCount_ = 0;
+
+        Clock::time_point lastReceiveTime_;
+        Clock::time_point lastSendTime_;
+        Clock::duration resendDelay_ = std::chrono::milliseconds(100);
+        //An idle channel still sends its acks at this period so that the other side does not time out
+        Clock::duration keepAlivePeriod_ = std::chrono::seconds(1);
+        Clock::duration timeout_ = std::chrono::seconds(5);
+        std::uint64_t resendCount_ = 0;
+    };
+}
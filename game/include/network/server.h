@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <memory>
 
 #include "packet_type.h"
@@ -10,14 +11,47 @@ namespace game
 {
     class Server : public PacketSenderInterface, public core::SystemInterface
     {
+    public:
+        /**
+         * \brief Number of players the match waits for before starting, must be set before Init
+         */
+        void SetPlayerCount(PlayerNumber playerCount);
+        [[nodiscard]] PlayerNumber GetPlayerCount() const { return playerCount_; }
+        /**
+         * \brief Sends the hash of each component manager with the full state hash, so that a desync names the diverging manager
+         */
+        void SetSendStateParts(bool sendStateParts) { sendStateParts_ = sendStateParts; }
+        /**
+         * \brief Records the match for the replay tool, with MatchReplayWriter::STATE_HASHES for desync_bisect, must be called before Init
+         */
+        bool StartMatchReplay(const std::string& path, std::uint8_t flags = 0) { return gameManager_.StartMatchReplay(path, flags); }
+        /**
+         * \brief Time between the last player joining and the start of the match, to let the start packet reach everyone
+         */
+        void SetStartDelay(std::chrono::milliseconds startDelay) { startDelay_ = startDelay; }
     protected:
-        virtual void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) = 0;
+        /**
+         * \brief Spawns the new player and sends the spawn of every player joined so far, the new client does not know them yet
+         */
+        virtual void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber);
         virtual void ReceivePacket(std::unique_ptr<Packet> packet);
         void Init() override;
+        /**
+         * \brief Replicate the inputs of a player that at least one client does not hold yet, up to the last contiguous
+         * received frame that acknowledges them to their player
+         */
+        void SendPlayerInputs(PlayerNumber playerNumber);
         //Server game manager
         GameManager gameManager_;
         PlayerNumber lastPlayerNumber_ = 0;
+        PlayerNumber playerCount_ = defaultPlayerNmb;
         std::array<ClientId, maxPlayerNmb> clientMap_{};
+        /**
+         * \brief Last contiguous input frame held by each client (first index) for each player (second index)
+         */
+        std::array<std::array<Frame, maxPlayerNmb>, maxPlayerNmb> receivedFrames_{};
+        bool sendStateParts_ = true;
+        std::chrono::milliseconds startDelay_{ 3000 };
 
     };
 }
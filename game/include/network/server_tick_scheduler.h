@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/headless_engine.h"
+#include "game/game_manager.h"
+
+namespace game
+{
+    class ServerNetworkManager;
+
+    /**
+     * \brief Runs a ServerNetworkManager on a HeadlessEngine, sleeping on the server sockets between two ticks
+     * instead of spinning, so that one host can run many matches.
+     */
+    class ServerTickScheduler : public core::HeadlessEngine
+    {
+    public:
+        explicit ServerTickScheduler(float period = GameManager::FixedPeriod);
+        /**
+         * \brief Inits the server and ticks it until it closes
+         */
+        void Run(ServerNetworkManager& server);
+        /**
+         * \brief Number of ticks between two stats logs, 0 only logs when the server closes
+         */
+        void SetReportPeriod(std::uint64_t reportPeriod) { reportPeriod_ = reportPeriod; }
+    protected:
+        /**
+         * \brief Processes the packets as they arrive until the deadline, stops the engine when the server closes
+         */
+        void WaitUntil(Clock::time_point deadline) override;
+    private:
+        void LogStats() const;
+
+        ServerNetworkManager* server_ = nullptr;
+        std::uint64_t reportPeriod_ = 3000;
+    };
+}
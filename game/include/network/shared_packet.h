@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+
+#include "packet_type.h"
+
+namespace game
+{
+    struct SharedPacketBuffer;
+
+    /**
+     * \brief Packet serialized once and shared by all the destinations of a broadcast.
+     * The buffer is immutable and reference counted, copies only add a reference and can be handed to other threads.
+     * Released buffers go back to the pool of the thread that built them, keeping their capacity.
+     */
+    class SharedPacket
+    {
+    public:
+        SharedPacket() = default;
+        explicit SharedPacket(Packet& packet);
+        SharedPacket(const SharedPacket& other) noexcept;
+        SharedPacket(SharedPacket&& other) noexcept;
+        SharedPacket& operator=(const SharedPacket& other) noexcept;
+        SharedPacket& operator=(SharedPacket&& other) noexcept;
+        ~SharedPacket();
+
+        [[nodiscard]] bool IsEmpty() const { return buffer_ == nullptr; }
+        [[nodiscard]] const std::uint8_t* GetData() const;
+        [[nodiscard]] std::size_t GetSize() const;
+        sf::Socket::Status Send(sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port) const;
+    private:
+        void Release();
+
+        SharedPacketBuffer* buffer_ = nullptr;
+    };
+}
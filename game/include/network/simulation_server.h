@@ -15,7 +15,7 @@ namespace game
 	class SimulationServer : public Server, public core::DrawImGuiInterface
 	{
 	public:
-		explicit SimulationServer(std::array<std::unique_ptr<SimulationClient>, 2>& clients);
+		explicit SimulationServer(std::array<std::unique_ptr<SimulationClient>, defaultPlayerNmb>& clients);
 		void Init() override;
 		void Update(sf::Time dt) override;
 		void Destroy() override;
@@ -31,7 +31,7 @@ namespace game
 
 		std::vector<DelayPacket> receivedPackets_;
 		std::vector<DelayPacket> sentPackets_;
-		std::array<std::unique_ptr<SimulationClient>, maxPlayerNmb>& clients_;
+		std::array<std::unique_ptr<SimulationClient>, defaultPlayerNmb>& clients_;
 
 
 		float avgDelay_ = 0.25f;
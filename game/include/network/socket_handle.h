@@ -0,0 +1,26 @@
+#pragma once
+
+#include <SFML/Network/Socket.hpp>
+
+namespace game
+{
+    namespace detail
+    {
+        //sf::Socket::getHandle is protected, going through a derived class gives access to it
+        struct SocketHandleAccess : sf::Socket
+        {
+            static sf::SocketHandle Get(const sf::Socket& socket)
+            {
+                return (socket.*(&SocketHandleAccess::getHandle))();
+            }
+        };
+    }
+
+    /**
+     * \brief Native handle of a SFML socket, for the system calls SFML does not wrap
+     */
+    inline sf::SocketHandle GetSocketHandle(const sf::Socket& socket)
+    {
+        return detail::SocketHandleAccess::Get(socket);
+    }
+}
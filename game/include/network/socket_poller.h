@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Network/Socket.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace game
+{
+    /**
+     * \brief Waits for read readiness on many SFML sockets and returns the keys of the ready ones.
+     * Uses epoll on Linux so that it is not limited to FD_SETSIZE sockets like sf::SocketSelector,
+     * which is used as fallback on the other platforms.
+     */
+    class SocketPoller
+    {
+    public:
+        using Key = std::uint64_t;
+
+        SocketPoller();
+        ~SocketPoller();
+        SocketPoller(const SocketPoller&) = delete;
+        SocketPoller& operator=(const SocketPoller&) = delete;
+
+        void Add(sf::Socket& socket, Key key);
+        void Remove(sf::Socket& socket);
+        /**
+         * \brief Blocks until at least one socket is ready or the timeout is reached
+         * \param readyKeys cleared and filled with the keys of the ready sockets
+         */
+        void Wait(sf::Time timeout, std::vector<Key>& readyKeys);
+    private:
+#ifdef __linux__
+        int epollFd_ = -1;
+#else
+        struct Entry
+        {
+            sf::Socket* socket = nullptr;
+            Key key = 0;
+        };
+        sf::SocketSelector selector_;
+        std::vector<Entry> entries_;
+#endif
+    };
+}
@@ -1,5 +1,8 @@
 #include <game/game_manager.h>
 
+#include <algorithm>
+#include <cassert>
+
 #include "utils/log.h"
 #include <fmt/format.h>
 #include <imgui.h>
@@ -11,11 +14,11 @@ namespace game
 
     GameManager::GameManager() :
         transformManager_(entityManager_),
-        rollbackManager_(*this, entityManager_),
-        physicsManager_(entityManager_)
+        rollbackManager_(*this, entityManager_)
 
     {
         playerEntityMap_.fill(core::EntityManager::INVALID_ENTITY);
+        SetPlayerCount(defaultPlayerNmb);
         
     }
 
@@ -23,6 +26,11 @@ namespace game
     {
         if (GetEntityFromPlayerNumber(playerNumber) != core::EntityManager::INVALID_ENTITY)
             return;
+        //The clients learn the player count of the match from the spawned players
+        if (playerNumber >= GetPlayerCount())
+        {
+            SetPlayerCount(playerNumber + 1);
+        }
         core::LogDebug("[GameManager] Spawning new player");
         const auto entity = entityManager_.CreateEntity();
         playerEntityMap_[playerNumber] = entity;
@@ -33,86 +41,122 @@ namespace game
         rollbackManager_.SpawnPlayer(playerNumber, entity, position, core::degree_t(rotation));
     }
 
-    core::Entity GameManager::SpawnBox(core::Vec2f position)
+    void GameManager::SpawnBox(core::Entity boxEntity, core::Vec2f position)
     { 
         core::LogDebug("SpawnBoxGameManager");
-        const auto boxEntity = entityManager_.CreateEntity();
         transformManager_.AddComponent(boxEntity);
         transformManager_.SetPosition(boxEntity, position);
         rollbackManager_.SpawnBox(boxEntity, position);
-        return boxEntity;
     }
 
-    core::Entity GameManager::SpawnFlag(core::Vec2f position)
+    void GameManager::SpawnFlag(core::Entity flagEntity, core::Vec2f position)
     {
         core::LogDebug("SpawnFlagGameManager");
-        const auto flagEntity = entityManager_.CreateEntity();
         transformManager_.AddComponent(flagEntity);
         transformManager_.SetPosition(flagEntity, position);
         rollbackManager_.SpawnFlag(flagEntity, position);
-        return flagEntity;
     }
 
-    core::Entity GameManager::SpawnTrack(core::Vec2f position)
+    void GameManager::SpawnTrack(core::Entity trackEntity, core::Vec2f position)
     {
         core::LogDebug("SpawnTrackGameManager");
-        const auto trackEntity = entityManager_.CreateEntity();
         transformManager_.AddComponent(trackEntity);
         transformManager_.SetPosition(trackEntity, position);
         rollbackManager_.SpawnTrack(trackEntity, position);
-        return trackEntity;
     }
 
-    core::Entity GameManager::SpawnWall(core::Vec2f position)
+    void GameManager::SpawnWall(core::Entity wallEntity, core::Vec2f position)
     {
         core::LogDebug("SpawnWallGameManager");
-        const auto wallEntity = entityManager_.CreateEntity();
         transformManager_.AddComponent(wallEntity);
         transformManager_.SetPosition(wallEntity, position);
         rollbackManager_.SpawnWall(wallEntity, position);
-        return wallEntity;
     }
 
-    core::Entity GameManager::SpawnGreatBox(core::Vec2f position)
+    void GameManager::SpawnGreatBox(core::Entity greatBoxEntity, core::Vec2f position)
     {
         core::LogDebug("SpawnGreatBoxGameManager");
-        const auto greatBoxEntity = entityManager_.CreateEntity();
         transformManager_.AddComponent(greatBoxEntity);
         transformManager_.SetPosition(greatBoxEntity, position);
         rollbackManager_.SpawnGreatBox(greatBoxEntity, position);
-        return greatBoxEntity;
     }
 
     void GameManager::SpawnLevel()
     {
         core::LogDebug("SpawnLevel");
-        
-        // Spawn the whole level taking the position of every single gameobject
-        SpawnTrack(core::Vec2f(0, 20)); SpawnTrack(core::Vec2f(0, 40)); SpawnTrack(core::Vec2f(0, 60));
-        SpawnTrack(core::Vec2f(0, 80)); SpawnTrack(core::Vec2f(0, 100));
-        
-        SpawnGreatBox(core::Vec2f(-2, -5)); SpawnGreatBox(core::Vec2f(2, -5));
-
-        SpawnBox(core::Vec2f(-3, 3));SpawnBox(core::Vec2f(3, 3));SpawnBox(core::Vec2f(0, 8));
-        SpawnBox(core::Vec2f(3, 11));SpawnBox(core::Vec2f(-3, 11));SpawnBox(core::Vec2f(1.5, 13));
-        SpawnBox(core::Vec2f(-1.5, 13));SpawnBox(core::Vec2f(2, 16));SpawnBox(core::Vec2f(-2, 16));
-        SpawnBox(core::Vec2f(0, 20));SpawnBox(core::Vec2f(-3, 26));SpawnBox(core::Vec2f(3, 26));
-        SpawnBox(core::Vec2f(1, 28));SpawnBox(core::Vec2f(-1.5, 31));SpawnBox(core::Vec2f(3, 40));
-        SpawnBox(core::Vec2f(2, 47));SpawnBox(core::Vec2f(1, 46));SpawnBox(core::Vec2f(-3, 50));
-        SpawnBox(core::Vec2f(-1, 55));SpawnBox(core::Vec2f(2, 58));
-        SpawnGreatBox(core::Vec2f(0, 65));
-        SpawnBox(core::Vec2f(-2.5, 70)); SpawnBox(core::Vec2f(2.5, 70));
-        SpawnGreatBox(core::Vec2f(1, 77));
-        SpawnGreatBox(core::Vec2f(-1, 85));
-        SpawnBox(core::Vec2f(3, 88));
-        SpawnBox(core::Vec2f(1, 90));SpawnBox(core::Vec2f(-1, 92));SpawnBox(core::Vec2f(-2, 94));
-
-        SpawnWall(core::Vec2f(4, 50)); SpawnWall(core::Vec2f(-4, 50));
-        
 
-        SpawnFlag(core::Vec2f(0, 100));SpawnFlag(core::Vec2f(-2, 100));SpawnFlag(core::Vec2f(2, 100));
-        SpawnFlag(core::Vec2f(-1, 100));SpawnFlag(core::Vec2f(1, 100));SpawnFlag(core::Vec2f(3, 100));
-        SpawnFlag(core::Vec2f(-3, 100));
+        enum class LevelObject
+        {
+            TRACK,
+            GREAT_BOX,
+            BOX,
+            WALL,
+            FLAG
+        };
+        struct LevelSpawn
+        {
+            LevelObject object;
+            core::Vec2f position;
+        };
+        // The whole level taking the position of every single gameobject, in spawn order
+        static constexpr std::array levelSpawns
+        {
+            LevelSpawn{LevelObject::TRACK, core::Vec2f(0, 20)}, LevelSpawn{LevelObject::TRACK, core::Vec2f(0, 40)},
+            LevelSpawn{LevelObject::TRACK, core::Vec2f(0, 60)}, LevelSpawn{LevelObject::TRACK, core::Vec2f(0, 80)},
+            LevelSpawn{LevelObject::TRACK, core::Vec2f(0, 100)},
+
+            LevelSpawn{LevelObject::GREAT_BOX, core::Vec2f(-2, -5)}, LevelSpawn{LevelObject::GREAT_BOX, core::Vec2f(2, -5)},
+
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-3, 3)}, LevelSpawn{LevelObject::BOX, core::Vec2f(3, 3)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(0, 8)}, LevelSpawn{LevelObject::BOX, core::Vec2f(3, 11)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-3, 11)}, LevelSpawn{LevelObject::BOX, core::Vec2f(1.5, 13)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-1.5, 13)}, LevelSpawn{LevelObject::BOX, core::Vec2f(2, 16)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-2, 16)}, LevelSpawn{LevelObject::BOX, core::Vec2f(0, 20)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-3, 26)}, LevelSpawn{LevelObject::BOX, core::Vec2f(3, 26)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(1, 28)}, LevelSpawn{LevelObject::BOX, core::Vec2f(-1.5, 31)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(3, 40)}, LevelSpawn{LevelObject::BOX, core::Vec2f(2, 47)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(1, 46)}, LevelSpawn{LevelObject::BOX, core::Vec2f(-3, 50)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-1, 55)}, LevelSpawn{LevelObject::BOX, core::Vec2f(2, 58)},
+            LevelSpawn{LevelObject::GREAT_BOX, core::Vec2f(0, 65)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-2.5, 70)}, LevelSpawn{LevelObject::BOX, core::Vec2f(2.5, 70)},
+            LevelSpawn{LevelObject::GREAT_BOX, core::Vec2f(1, 77)},
+            LevelSpawn{LevelObject::GREAT_BOX, core::Vec2f(-1, 85)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(3, 88)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(1, 90)}, LevelSpawn{LevelObject::BOX, core::Vec2f(-1, 92)},
+            LevelSpawn{LevelObject::BOX, core::Vec2f(-2, 94)},
+
+            LevelSpawn{LevelObject::WALL, core::Vec2f(4, 50)}, LevelSpawn{LevelObject::WALL, core::Vec2f(-4, 50)},
+
+            LevelSpawn{LevelObject::FLAG, core::Vec2f(0, 100)}, LevelSpawn{LevelObject::FLAG, core::Vec2f(-2, 100)},
+            LevelSpawn{LevelObject::FLAG, core::Vec2f(2, 100)}, LevelSpawn{LevelObject::FLAG, core::Vec2f(-1, 100)},
+            LevelSpawn{LevelObject::FLAG, core::Vec2f(1, 100)}, LevelSpawn{LevelObject::FLAG, core::Vec2f(3, 100)},
+            LevelSpawn{LevelObject::FLAG, core::Vec2f(-3, 100)}
+        };
+
+        //All the level entities are allocated at once
+        const auto entities = entityManager_.CreateEntities(levelSpawns.size());
+        for (std::size_t i = 0; i < levelSpawns.size(); i++)
+        {
+            const auto& levelSpawn = levelSpawns[i];
+            switch (levelSpawn.object)
+            {
+            case LevelObject::TRACK:
+                SpawnTrack(entities[i], levelSpawn.position);
+                break;
+            case LevelObject::GREAT_BOX:
+                SpawnGreatBox(entities[i], levelSpawn.position);
+                break;
+            case LevelObject::BOX:
+                SpawnBox(entities[i], levelSpawn.position);
+                break;
+            case LevelObject::WALL:
+                SpawnWall(entities[i], levelSpawn.position);
+                break;
+            case LevelObject::FLAG:
+                SpawnFlag(entities[i], levelSpawn.position);
+                break;
+            }
+        }
     }
 
     core::Entity GameManager::GetEntityFromPlayerNumber(PlayerNumber playerNumber) const
@@ -120,6 +164,12 @@ namespace game
         return playerEntityMap_[playerNumber];
     }
 
+    void GameManager::SetPlayerCount(PlayerNumber playerCount)
+    {
+        assert(playerCount <= maxPlayerNmb);
+        rollbackManager_.SetPlayerCount(playerCount);
+    }
+
 
     void GameManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame)
     {
@@ -129,6 +179,14 @@ namespace game
         rollbackManager_.SetPlayerInput(playerNumber, playerInput, inputFrame);
 
     }
+
+    void GameManager::SetPlayerInputs(PlayerNumber playerNumber, Frame newestFrame, const PlayerInput* playerInputs, std::size_t count)
+    {
+        if (playerNumber == INVALID_PLAYER)
+            return;
+
+        rollbackManager_.SetPlayerInputs(playerNumber, newestFrame, playerInputs, count);
+    }
     void GameManager::Validate(Frame newValidateFrame)
     {
         if (rollbackManager_.GetCurrentFrame() < newValidateFrame)
@@ -138,39 +196,59 @@ namespace game
         rollbackManager_.ValidateFrame(newValidateFrame);
     }
 
+    bool GameManager::StartMatchReplay(const std::string& path, std::uint8_t flags)
+    {
+        auto matchReplay = std::make_unique<MatchReplayWriter>();
+        if (!matchReplay->Open(path, flags))
+        {
+            core::LogError(fmt::format("[GameManager] Could not create match replay {}", path));
+            return false;
+        }
+        matchReplay_ = std::move(matchReplay);
+        rollbackManager_.SetMatchReplay(matchReplay_.get());
+        return true;
+    }
+
+    void GameManager::SetMatchReplayStartTime(unsigned long long startTime)
+    {
+        if (matchReplay_ != nullptr)
+        {
+            matchReplay_->SetStartTime(startTime);
+        }
+    }
+
 
     PlayerNumber GameManager::CheckWinner() const
     {
-        int firstPlayer = 0;
+        int finishedPlayers = 0;
         PlayerNumber winner = INVALID_PLAYER;
         const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        for (const auto entity : playerManager.GetEntities())
         {
             if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
                 continue;
             const auto& player = playerManager.GetComponent(entity);
 
-            //use the player1win or player2win variable to determine which player won
-            if (player.player1win >= 1)
+            //use the winCount variable to determine which player won
+            if (player.winCount >= 1)
             {
-                firstPlayer++;
-                winner = 0;
-            }
-            else if (player.player2win >= 1)
-            {
-                firstPlayer++;
-                winner = 1;
+                finishedPlayers++;
+                winner = player.playerNumber;
             }
 
         }
 
-        return firstPlayer == 1 ? winner : INVALID_PLAYER;
+        return finishedPlayers == 1 ? winner : INVALID_PLAYER;
     }
 
 
     void GameManager::WinGame(PlayerNumber winner)
     {
         winner_ = winner;
+        if (matchReplay_ != nullptr)
+        {
+            matchReplay_->Flush();
+        }
     }
 
     ClientGameManager::ClientGameManager(PacketSenderInterface& packetSenderInterface) :
@@ -181,6 +259,12 @@ namespace game
     }
 
     void ClientGameManager::Init()
+    {
+        //Simulation only, the textures and the font are loaded by LoadResources for the clients that draw
+        SpawnLevel();
+    }
+
+    void ClientGameManager::LoadResources()
     {
         //load textures
         if (!trackTexture_.loadFromFile("data/sprites/racetrack.jpg"))
@@ -213,7 +297,6 @@ namespace game
             core::LogError("Could not load font");
         }
         textRenderer_.setFont(font_);
-        SpawnLevel();
     }
 
     void ClientGameManager::Update(sf::Time dt)
@@ -222,16 +305,11 @@ namespace game
         {
             rollbackManager_.SimulateToCurrentFrame();
             //Copy rollback transform position to our own
-            for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+            for (const auto entity : entityManager_.GetView(static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
             {
-                
-
-                if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
-                {
-                    transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-                    transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-                    transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
-                }
+                transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
+                transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
+                transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
             }
         }
         fixedTimer_ += dt.asSeconds();
@@ -328,7 +406,7 @@ namespace game
         {
             std::string health;
             const auto& playerManager = rollbackManager_.GetPlayerCharacterManager();
-            for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+            for (PlayerNumber playerNumber = 0; playerNumber < GetPlayerCount(); playerNumber++)
             {
                 const auto playerEntity = GetEntityFromPlayerNumber(playerNumber);
                 if (playerEntity == core::EntityManager::INVALID_ENTITY)
@@ -367,68 +445,60 @@ namespace game
 
     }
 
-    core::Entity ClientGameManager::SpawnBox(core::Vec2f position)
+    void ClientGameManager::SpawnBox(core::Entity boxEntity, core::Vec2f position)
     {
         core::LogDebug("ClientSpawnBox");
-        const auto boxEntity = GameManager::SpawnBox(position);
+        GameManager::SpawnBox(boxEntity, position);
         entityManager_.AddComponent(boxEntity, static_cast<core::EntityMask>(ComponentType::WALL));
         spriteManager_.AddComponent(boxEntity);
         spriteManager_.SetTexture(boxEntity, boxTexture_);
         spriteManager_.SetOrigin(boxEntity, sf::Vector2f(boxTexture_.getSize()) / 2.0f);
        
         spriteManager_.SetColor(boxEntity, sf::Color::Black);
-        return boxEntity;
-       
     }
 
-    core::Entity ClientGameManager::SpawnFlag(core::Vec2f position)
+    void ClientGameManager::SpawnFlag(core::Entity flagEntity, core::Vec2f position)
     {
         core::LogDebug("ClientSpawnFlag");
-        const auto flagEntity = GameManager::SpawnFlag(position);
+        GameManager::SpawnFlag(flagEntity, position);
 
         spriteManager_.AddComponent(flagEntity);
         spriteManager_.SetTexture(flagEntity, flagTexture_);
         spriteManager_.SetOrigin(flagEntity, sf::Vector2f(flagTexture_.getSize()) / 2.0f);
-
-        return flagEntity;
     }
 
-    core::Entity ClientGameManager::SpawnTrack(core::Vec2f position)
+    void ClientGameManager::SpawnTrack(core::Entity trackEntity, core::Vec2f position)
     {
         core::LogDebug("ClientSpawnTrack");
-        const auto trackEntity = GameManager::SpawnTrack(position);
+        GameManager::SpawnTrack(trackEntity, position);
 
         spriteManager_.AddComponent(trackEntity);
         spriteManager_.SetTexture(trackEntity, trackTexture_);
         spriteManager_.SetOrigin(trackEntity, sf::Vector2f(trackTexture_.getSize()) / 2.0f);
-
-        return trackEntity;
     }
 
-    core::Entity ClientGameManager::SpawnWall(core::Vec2f position)
+    void ClientGameManager::SpawnWall(core::Entity wallEntity, core::Vec2f position)
     {
         core::LogDebug("ClientSpawnWall");
-        const auto wallEntity = GameManager::SpawnWall(position);
+        GameManager::SpawnWall(wallEntity, position);
         entityManager_.AddComponent(wallEntity, static_cast<core::EntityMask>(ComponentType::WALL));
         spriteManager_.AddComponent(wallEntity);
         spriteManager_.SetTexture(wallEntity, wallTexture_);
         spriteManager_.SetOrigin(wallEntity, sf::Vector2f(wallTexture_.getSize()) / 2.0f);
 
         spriteManager_.SetColor(wallEntity, sf::Color::Black);
-        return wallEntity;
     }
 
-    core::Entity ClientGameManager::SpawnGreatBox(core::Vec2f position)
+    void ClientGameManager::SpawnGreatBox(core::Entity greatBoxEntity, core::Vec2f position)
     {
         core::LogDebug("ClientSpawnGreatBox");
-        const auto greatBoxEntity = GameManager::SpawnGreatBox(position);
+        GameManager::SpawnGreatBox(greatBoxEntity, position);
         entityManager_.AddComponent(greatBoxEntity, static_cast<core::EntityMask>(ComponentType::WALL));
         spriteManager_.AddComponent(greatBoxEntity);
         spriteManager_.SetTexture(greatBoxEntity, greatBoxTexture_);
         spriteManager_.SetOrigin(greatBoxEntity, sf::Vector2f(greatBoxTexture_.getSize()) / 2.0f);
 
         spriteManager_.SetColor(greatBoxEntity, sf::Color::Black);
-        return greatBoxEntity;
     }
 
     void ClientGameManager::FixedUpdate()
@@ -472,15 +542,19 @@ namespace game
         const auto& inputs = rollbackManager_.GetInputs(playerNumber);
         auto playerInputPacket = std::make_unique<PlayerInputPacket>();
         playerInputPacket->playerNumber = playerNumber;
-        playerInputPacket->currentFrame = core::ConvertToBinary(currentFrame_);
-        for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+        //The server already has the inputs up to the acknowledged frame and the last validated frame
+        const auto ackFrame = std::min(currentFrame_, std::max(inputAckFrame_, GetLastValidateFrame()));
+        //When the ack lags more than a packet can hold, the oldest missing inputs are sent first so the server never gets a hole
+        const auto newestFrame = std::min<Frame>(currentFrame_, ackFrame + static_cast<Frame>(maxInputNmb));
+        const auto inputCount = std::max<Frame>(newestFrame - ackFrame, 1);
+        playerInputPacket->currentFrame = core::ConvertToBinary(newestFrame);
+        playerInputPacket->inputCount = static_cast<std::uint8_t>(
+            inputs.CopyInputs(newestFrame, playerInputPacket->inputs.data(), inputCount));
+        //Tells the server which inputs of the other players we already hold, so it only replicates the newer ones
+        playerInputPacket->receivedCount = GetPlayerCount();
+        for (PlayerNumber i = 0; i < GetPlayerCount(); i++)
         {
-            if (i > currentFrame_)
-            {
-                break;
-            }
-
-            playerInputPacket->inputs[i] = inputs[i];
+            playerInputPacket->receivedFrames[i] = rollbackManager_.GetLastContiguousFrame(i);
         }
         packetSenderInterface_.SendUnreliablePacket(std::move(playerInputPacket));
 
@@ -517,32 +591,40 @@ namespace game
                 ).count();
             ImGui::Text("Current Time: %llu", ms);
         }
+        ImGui::Text("Frames resimulated: %llu",
+            static_cast<unsigned long long>(rollbackManager_.GetFramesResimulated()));
+        ImGui::Text("Rollbacks avoided: %llu",
+            static_cast<unsigned long long>(rollbackManager_.GetRollbacksAvoided()));
     }
 
-    void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
-        const std::array<PhysicsState, maxPlayerNmb>& physicsStates)
+    void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame, const StateHash& stateHash, std::size_t partCount)
     {
         if (newValidateFrame < rollbackManager_.GetLastValidateFrame())
         {
             //core::LogDebug(fmt::format("[Warning] New validate frame is too old"));
             return;
         }
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        for (PlayerNumber playerNumber = 0; playerNumber < GetPlayerCount(); playerNumber++)
         {
-            if (rollbackManager_.GetLastReceivedFrame(playerNumber) < newValidateFrame)
+            if (rollbackManager_.GetLastContiguousFrame(playerNumber) < newValidateFrame)
             {
                /*
                 core::LogDebug(fmt::format("[Warning] Trying to validate frame {} while playerNumber {} is at input frame {}, client player {}",
                     newValidateFrame,
                     playerNumber + 1,
-                    rollbackManager_.GetLastReceivedFrame(playerNumber),
+                    rollbackManager_.GetLastContiguousFrame(playerNumber),
                     GetPlayerNumber()+1));
                 */
                 return;
                 
             }
         }
-        rollbackManager_.ConfirmFrame(newValidateFrame, physicsStates);
+        rollbackManager_.ConfirmFrame(newValidateFrame, stateHash, partCount);
+    }
+
+    void ClientGameManager::AcknowledgeInputs(Frame ackFrame)
+    {
+        inputAckFrame_ = std::max(inputAckFrame_, ackFrame);
     }
 
     void ClientGameManager::WinGame(PlayerNumber winner)
@@ -0,0 +1,111 @@
+#include <game/input_buffer.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace game
+{
+    Frame PlayerInputBuffer::SetInput(Frame frame, PlayerInput input)
+    {
+        assert(frame <= head_ && "Trying to set input in the future");
+        const auto oldestFrame = GetOldestFrame();
+        if (frame < oldestFrame)
+        {
+            return INVALID_FRAME;
+        }
+        if (frame > lastReceivedFrame_)
+        {
+            const auto predictedInput = inputs_[Index(lastReceivedFrame_)];
+            //The frames between the last received frame and this one keep the predicted input
+            for (Frame gapFrame = std::max(lastReceivedFrame_ + 1, oldestFrame); gapFrame < frame; gapFrame++)
+            {
+                inputs_[Index(gapFrame)] = predictedInput;
+            }
+            inputs_[Index(frame)] = input;
+            //A single input comes from the local player, whose skipped frames really repeat the last input
+            if (lastContiguousFrame_ == lastReceivedFrame_)
+            {
+                lastContiguousFrame_ = frame;
+            }
+            lastReceivedFrame_ = frame;
+            return predictedInput != input ? frame : INVALID_FRAME;
+        }
+        if (inputs_[Index(frame)] == input)
+        {
+            return INVALID_FRAME;
+        }
+        inputs_[Index(frame)] = input;
+        return frame;
+    }
+
+    Frame PlayerInputBuffer::SetInputs(Frame newestFrame, const PlayerInput* inputs, std::size_t count)
+    {
+        count = std::min<std::size_t>(count, static_cast<std::size_t>(newestFrame) + 1);
+        if (count == 0)
+        {
+            return INVALID_FRAME;
+        }
+        const auto packetOldestFrame = static_cast<Frame>(newestFrame - (count - 1));
+        const auto lastContiguousFrame = lastContiguousFrame_;
+        Frame dirtyFrame = INVALID_FRAME;
+        //Oldest first, so the frames after the last received one are set in order and nothing is predicted in between
+        for (Frame frame = std::max(packetOldestFrame, lastContiguousFrame + 1); frame <= newestFrame; frame++)
+        {
+            dirtyFrame = std::min(dirtyFrame, SetInput(frame, inputs[newestFrame - frame]));
+        }
+        //A packet starting after a hole does not make the inputs contiguous, the hole is filled by a later packet
+        lastContiguousFrame_ = packetOldestFrame <= lastContiguousFrame + 1 ?
+            std::max(lastContiguousFrame, newestFrame) : lastContiguousFrame;
+        return dirtyFrame;
+    }
+
+    PlayerInput PlayerInputBuffer::GetInput(Frame frame) const
+    {
+        assert(Contains(frame) && "Trying to get input too far in the past");
+        return inputs_[Index(std::min(frame, lastReceivedFrame_))];
+    }
+
+    void PlayerInputBuffer::StartNewFrame(Frame newFrame)
+    {
+        if (newFrame > head_)
+        {
+            head_ = newFrame;
+        }
+    }
+
+    std::size_t PlayerInputBuffer::CopyInputs(Frame newestFrame, PlayerInput* destination, std::size_t count) const
+    {
+        const auto oldestFrame = GetOldestFrame();
+        if (newestFrame < oldestFrame || newestFrame > head_)
+        {
+            return 0;
+        }
+        count = std::min<std::size_t>(count, newestFrame - oldestFrame + 1);
+        std::size_t copied = 0;
+        //Predicted inputs are not stored, they repeat the last received input
+        while (copied < count && newestFrame - copied > lastReceivedFrame_)
+        {
+            destination[copied] = inputs_[Index(lastReceivedFrame_)];
+            copied++;
+        }
+        //Received inputs are contiguous until the buffer wraps around
+        while (copied < count)
+        {
+            const auto index = Index(static_cast<Frame>(newestFrame - copied));
+            const auto length = std::min(count - copied, windowBufferSize - index);
+            std::copy_n(inputs_.begin() + index, length, destination + copied);
+            copied += length;
+        }
+        return copied;
+    }
+
+    bool PlayerInputBuffer::Contains(Frame frame) const
+    {
+        return frame >= GetOldestFrame() && frame <= head_;
+    }
+
+    Frame PlayerInputBuffer::GetOldestFrame() const
+    {
+        return head_ >= windowBufferSize ? static_cast<Frame>(head_ - windowBufferSize + 1) : 0;
+    }
+}
@@ -0,0 +1,57 @@
+#include <game/match_playback.h>
+
+namespace game
+{
+    namespace
+    {
+        //The pages of the inputs already played are given back every 64 K frames, about 20 minutes of match
+        constexpr Frame releaseFramePeriod = 1u << 16u;
+    }
+
+    MatchPlayback::MatchPlayback(MatchReplayReader& replay) : replay_(replay)
+    {
+        gameManager_.SetPlayerCount(replay_.GetPlayerCount());
+        gameManager_.SpawnLevel();
+        for (PlayerNumber playerNumber = 0; playerNumber < replay_.GetPlayerCount(); playerNumber++)
+        {
+            const auto& spawn = replay_.GetSpawn(playerNumber);
+            if (spawn.spawned)
+            {
+                gameManager_.SpawnPlayer(playerNumber, spawn.position, spawn.rotation);
+            }
+        }
+        nextFrame_ = replay_.GetFirstFrame();
+    }
+
+    bool MatchPlayback::Step()
+    {
+        if (nextFrame_ - replay_.GetFirstFrame() >= replay_.GetFrameCount())
+        {
+            return false;
+        }
+        const auto* inputs = replay_.GetInputs(nextFrame_);
+        for (PlayerNumber playerNumber = 0; playerNumber < replay_.GetPlayerCount(); playerNumber++)
+        {
+            gameManager_.SetPlayerInput(playerNumber, inputs[playerNumber], nextFrame_);
+        }
+        gameManager_.Validate(nextFrame_);
+        if (winner_ == INVALID_PLAYER)
+        {
+            winner_ = gameManager_.CheckWinner();
+            winFrame_ = nextFrame_;
+        }
+        if (nextFrame_ % releaseFramePeriod == 0)
+        {
+            replay_.ReleaseFramesBefore(nextFrame_);
+        }
+        nextFrame_++;
+        return true;
+    }
+
+    void MatchPlayback::Play()
+    {
+        while (Step())
+        {
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include <game/match_replay.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace game
+{
+    namespace
+    {
+        template<typename T>
+        std::uint8_t* StoreReplayValue(std::uint8_t* data, T value)
+        {
+            std::memcpy(data, &value, sizeof(T));
+            return data + sizeof(T);
+        }
+
+        template<typename T>
+        const std::uint8_t* LoadReplayValue(const std::uint8_t* data, T& value)
+        {
+            std::memcpy(&value, data, sizeof(T));
+            return data + sizeof(T);
+        }
+    }
+
+    bool MatchReplayWriter::Open(const std::string& path, std::uint8_t flags)
+    {
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open())
+        {
+            return false;
+        }
+        flags_ = flags;
+        WriteHeader();
+        return true;
+    }
+
+    void MatchReplayWriter::SetPlayerCount(PlayerNumber playerCount)
+    {
+        assert(frameCount_ == 0 && "The player count of a replay cannot change during the match");
+        playerCount_ = playerCount;
+        WriteHeader();
+    }
+
+    void MatchReplayWriter::WriteSpawn(PlayerNumber playerNumber, core::Vec2f position, core::degree_t rotation)
+    {
+        spawns_[playerNumber] = { true, position, rotation };
+        WriteHeader();
+    }
+
+    void MatchReplayWriter::SetStartTime(unsigned long long startTime)
+    {
+        startTime_ = startTime;
+        WriteHeader();
+    }
+
+    void MatchReplayWriter::WriteFrame(Frame frame, const PlayerInput* inputs, const StateHash* stateHash)
+    {
+        if (frameCount_ == 0)
+        {
+            firstFrame_ = frame;
+            WriteHeader();
+        }
+        assert(frame == firstFrame_ + frameCount_ && "The frames of a replay must be contiguous");
+        file_.write(reinterpret_cast<const char*>(inputs), static_cast<std::streamsize>(playerCount_));
+        if (flags_ & STATE_HASHES)
+        {
+            std::array<std::uint8_t, stateHashSize> data{};
+            if (stateHash != nullptr)
+            {
+                auto* it = StoreReplayValue(data.data(), std::uint8_t{ 1 });
+                it = StoreReplayValue(it, stateHash->full);
+                for (const auto partHash : stateHash->parts)
+                {
+                    it = StoreReplayValue(it, partHash);
+                }
+            }
+            file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+        frameCount_++;
+    }
+
+    void MatchReplayWriter::Flush()
+    {
+        file_.flush();
+    }
+
+    void MatchReplayWriter::WriteHeader()
+    {
+        if (!file_.is_open())
+            return;
+        std::array<std::uint8_t, headerSize> data{};
+        auto* it = StoreReplayValue(data.data(), magic);
+        it = StoreReplayValue(it, version);
+        it = StoreReplayValue(it, playerCount_);
+        it = StoreReplayValue(it, flags_);
+        it = StoreReplayValue(it, static_cast<std::uint64_t>(startTime_));
+        it = StoreReplayValue(it, firstFrame_);
+        for (const auto& spawn : spawns_)
+        {
+            it = StoreReplayValue(it, static_cast<std::uint8_t>(spawn.spawned));
+            it = StoreReplayValue(it, spawn.position.x);
+            it = StoreReplayValue(it, spawn.position.y);
+            it = StoreReplayValue(it, spawn.rotation.value());
+        }
+        //The header only changes before the first frames, the frames are appended after it
+        const auto end = file_.tellp();
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (end > static_cast<std::streamoff>(headerSize))
+        {
+            file_.seekp(end);
+        }
+    }
+
+    bool MatchReplayReader::Open(const std::string& path)
+    {
+        if (!file_.Open(path) || file_.GetSize() < MatchReplayWriter::headerSize)
+        {
+            file_.Close();
+            return false;
+        }
+        std::uint32_t magic = 0;
+        std::uint16_t version = 0;
+        std::uint64_t startTime = 0;
+        const auto* it = LoadReplayValue(file_.GetData(), magic);
+        it = LoadReplayValue(it, version);
+        if (magic != MatchReplayWriter::magic || version != MatchReplayWriter::version)
+        {
+            file_.Close();
+            return false;
+        }
+        it = LoadReplayValue(it, playerCount_);
+        it = LoadReplayValue(it, flags_);
+        it = LoadReplayValue(it, startTime);
+        it = LoadReplayValue(it, firstFrame_);
+        playerCount_ = std::min<PlayerNumber>(playerCount_, maxPlayerNmb);
+        startTime_ = startTime;
+        for (auto& spawn : spawns_)
+        {
+            std::uint8_t spawned = 0;
+            float rotation = 0.0f;
+            it = LoadReplayValue(it, spawned);
+            it = LoadReplayValue(it, spawn.position.x);
+            it = LoadReplayValue(it, spawn.position.y);
+            it = LoadReplayValue(it, rotation);
+            spawn.spawned = spawned != 0;
+            spawn.rotation = core::degree_t(rotation);
+        }
+        recordSize_ = MatchReplayWriter::GetRecordSize(playerCount_, flags_);
+        //A replay cut by a crash can end with a partial frame
+        frameCount_ = recordSize_ == 0 ? 0 : (file_.GetSize() - MatchReplayWriter::headerSize) / recordSize_;
+        releasedFrameCount_ = 0;
+        return true;
+    }
+
+    const PlayerInput* MatchReplayReader::GetInputs(Frame frame) const
+    {
+        return GetRecord(frame);
+    }
+
+    bool MatchReplayReader::ReadStateHash(Frame frame, StateHash& stateHash) const
+    {
+        if (!HasStateHashes() || frame < firstFrame_ || frame - firstFrame_ >= frameCount_)
+        {
+            return false;
+        }
+        std::uint8_t hashed = 0;
+        const auto* it = LoadReplayValue(GetRecord(frame) + playerCount_ * sizeof(PlayerInput), hashed);
+        if (hashed == 0)
+        {
+            return false;
+        }
+        it = LoadReplayValue(it, stateHash.full);
+        for (auto& partHash : stateHash.parts)
+        {
+            it = LoadReplayValue(it, partHash);
+        }
+        return true;
+    }
+
+    void MatchReplayReader::ReleaseFramesBefore(Frame frame)
+    {
+        const auto frameCount = std::min<std::uint64_t>(frame > firstFrame_ ? frame - firstFrame_ : 0, frameCount_);
+        if (frameCount <= releasedFrameCount_)
+            return;
+        const auto offset = MatchReplayWriter::headerSize + static_cast<std::size_t>(releasedFrameCount_) * recordSize_;
+        file_.ReleasePages(offset, static_cast<std::size_t>(frameCount - releasedFrameCount_) * recordSize_);
+        releasedFrameCount_ = frameCount;
+    }
+
+    const std::uint8_t* MatchReplayReader::GetRecord(Frame frame) const
+    {
+        assert(frame >= firstFrame_ && frame - firstFrame_ < frameCount_);
+        return file_.GetData() + MatchReplayWriter::headerSize + static_cast<std::size_t>(frame - firstFrame_) * recordSize_;
+    }
+
+    Frame FindFirstDivergentFrame(const MatchReplayReader& replay1, const MatchReplayReader& replay2)
+    {
+        if (replay1.GetFrameCount() == 0 || replay2.GetFrameCount() == 0)
+        {
+            return INVALID_FRAME;
+        }
+        const std::int64_t firstFrame = std::max(replay1.GetFirstFrame(), replay2.GetFirstFrame());
+        const std::int64_t lastFrame = std::min(
+            replay1.GetFirstFrame() + replay1.GetFrameCount(), replay2.GetFirstFrame() + replay2.GetFrameCount()) - 1;
+
+        Frame divergentFrame = INVALID_FRAME;
+        std::int64_t low = firstFrame;
+        std::int64_t high = lastFrame;
+        StateHash stateHash1;
+        StateHash stateHash2;
+        while (low <= high)
+        {
+            const auto middle = low + (high - low) / 2;
+            //Not every frame ends a validation, we look at the next one hashed by both replays
+            auto hashedFrame = middle;
+            while (hashedFrame <= high && !(replay1.ReadStateHash(static_cast<Frame>(hashedFrame), stateHash1) &&
+                replay2.ReadStateHash(static_cast<Frame>(hashedFrame), stateHash2)))
+            {
+                hashedFrame++;
+            }
+            if (hashedFrame > high)
+            {
+                high = middle - 1;
+            }
+            else if (stateHash1.full != stateHash2.full)
+            {
+                divergentFrame = static_cast<Frame>(hashedFrame);
+                high = middle - 1;
+            }
+            else
+            {
+                low = hashedFrame + 1;
+            }
+        }
+        return divergentFrame;
+    }
+}
@@ -1,84 +1,432 @@
 #include <game/physics_manager.h>
 #include "utils/log.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 namespace game
 {
+    namespace
+    {
+        /**
+         * \brief values[i] += rates[i] * dt, multiply then add like the scalar BoxBody integration
+         */
+        void IntegrateArray(float* values, const float* rates, std::size_t count, float dt)
+        {
+            std::size_t i = 0;
+#if defined(__AVX__)
+            const auto dt8 = _mm256_set1_ps(dt);
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto delta = _mm256_mul_ps(_mm256_loadu_ps(rates + i), dt8);
+                _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), delta));
+            }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+            const auto dt4 = _mm_set1_ps(dt);
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto delta = _mm_mul_ps(_mm_loadu_ps(rates + i), dt4);
+                _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), delta));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                values[i] += rates[i] * dt;
+            }
+        }
+#ifdef GAME_FIXED_POINT
+        /**
+         * \brief values[i] += rates[i] * dt in fixed point, a scalar loop is enough for the bodies of a match
+         */
+        void IntegrateArray(core::Fixed* values, const core::Fixed* rates, std::size_t count, core::Fixed dt)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                values[i] += rates[i] * dt;
+            }
+        }
+#endif
+
+        /**
+         * \brief True if integrating leaves every value bit for bit the same, without any velocity.
+         * In floating point -0.0f + 0.0f gives 0.0f, such a value has to be written.
+         * Branchless on the bits like IntegrateArray, it runs over every page every frame.
+         */
+        bool IsIntegrationIdentity(const float* values, const float* rates, std::size_t count)
+        {
+            constexpr std::uint32_t negativeZero = 0x80000000u;
+            std::size_t i = 0;
+            std::uint32_t changedBits = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+            const auto negativeZero4 = _mm_set1_epi32(static_cast<int>(negativeZero));
+            auto changedBits4 = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4)
+            {
+                //Both zeros only have the sign bit, shifted out
+                const auto rateBits = _mm_slli_epi32(_mm_castps_si128(_mm_loadu_ps(rates + i)), 1);
+                const auto isNegativeZero = _mm_cmpeq_epi32(_mm_castps_si128(_mm_loadu_ps(values + i)), negativeZero4);
+                changedBits4 = _mm_or_si128(changedBits4, _mm_or_si128(rateBits, isNegativeZero));
+            }
+            changedBits = _mm_movemask_epi8(_mm_cmpeq_epi32(changedBits4, _mm_setzero_si128())) != 0xFFFF;
+#endif
+            for (; i < count; i++)
+            {
+                changedBits |= std::bit_cast<std::uint32_t>(rates[i]) << 1u;
+                changedBits |= std::bit_cast<std::uint32_t>(values[i]) == negativeZero;
+            }
+            return changedBits == 0;
+        }
+#ifdef GAME_FIXED_POINT
+        bool IsIntegrationIdentity([[maybe_unused]] const core::Fixed* values, const core::Fixed* rates, std::size_t count)
+        {
+            std::int32_t rateBits = 0;
+            for (std::size_t i = 0; i < count; i++)
+            {
+                rateBits |= rates[i].GetRaw();
+            }
+            return rateBits == 0;
+        }
+#endif
+
+        /**
+         * \brief Integrates one page of values, the page stays shared with the snapshots when nothing moves in it
+         */
+        void IntegratePage(core::PagedArray<Scalar>& values, const core::PagedArray<Scalar>& rates, std::size_t page, Scalar dt)
+        {
+            const auto count = values.GetPageSize(page);
+            if (IsIntegrationIdentity(values.GetPage(page), rates.GetPage(page), count))
+                return;
+            IntegrateArray(values.WritePage(page), rates.GetPage(page), count, dt);
+        }
+    }
+
+    Aabb GetAabb(const BoxBody& body)
+    {
+        Aabb aabb;
+        aabb.minX = body.position.x - body.extends.x;
+        aabb.minY = body.position.y - body.extends.y;
+        aabb.maxX = aabb.minX + body.extends.x * Scalar(2);
+        aabb.maxY = aabb.minY + body.extends.y * Scalar(2);
+        return aabb;
+    }
+
+    bool Box2Box(const Aabb& aabb1, const Aabb& aabb2)
+    {
+        return aabb1.maxX >= aabb2.minX &&    // r1 right edge past r2 left
+            aabb1.minX <= aabb2.maxX &&    // r1 left edge past r2 right
+            aabb1.maxY >= aabb2.minY &&    // r1 top edge past r2 bottom
+            aabb1.minY <= aabb2.maxY;
+    }
+
+    CellRange GetCellRange(const Aabb& aabb, Scalar cellSize)
+    {
+        //Same bounds as Box2Box, so two intersecting bodies always share at least one cell
+        return {
+            core::FloorToInt(aabb.minX / cellSize),
+            core::FloorToInt(aabb.minY / cellSize),
+            core::FloorToInt(aabb.maxX / cellSize),
+            core::FloorToInt(aabb.maxY / cellSize)
+        };
+    }
+
+    std::uint64_t GetCellKey(std::int32_t x, std::int32_t y)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(y)) << 32u) | static_cast<std::uint32_t>(x);
+    }
+
+    BoxBodyManager::BoxBodyManager(core::EntityManager& entityManager) : entityManager_(entityManager)
+    {
+    }
 
-    PhysicsManager::PhysicsManager(core::EntityManager& entityManager) :
-        boxbodyManager_(entityManager), entityManager_(entityManager)
+    void BoxBodyManager::AddComponent(core::Entity entity)
     {
+        const auto index = sparseSet_.Add(entity);
+        if (index != core::SparseSet::INVALID_INDEX)
+        {
+            const auto insert = [index](auto& values, auto value)
+            {
+                values.Insert(index, value);
+            };
+            const BoxBody body;
+            insert(bodies_.positionX, body.position.x);
+            insert(bodies_.positionY, body.position.y);
+            insert(bodies_.velocityX, body.velocity.x);
+            insert(bodies_.velocityY, body.velocity.y);
+            insert(bodies_.angularVelocity, body.angularVelocity.value());
+            insert(bodies_.rotation, body.rotation.value());
+            insert(bodies_.extendX, body.extends.x);
+            insert(bodies_.extendY, body.extends.y);
+            insert(bodies_.bodyType, body.bodyType);
+        }
+        entityManager_.AddComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D));
+    }
 
+    void BoxBodyManager::RemoveComponent(core::Entity entity)
+    {
+        const auto index = sparseSet_.Remove(entity);
+        if (index != core::SparseSet::INVALID_INDEX)
+        {
+            const auto erase = [index](auto& values)
+            {
+                values.Erase(index);
+            };
+            erase(bodies_.positionX);
+            erase(bodies_.positionY);
+            erase(bodies_.velocityX);
+            erase(bodies_.velocityY);
+            erase(bodies_.angularVelocity);
+            erase(bodies_.rotation);
+            erase(bodies_.extendX);
+            erase(bodies_.extendY);
+            erase(bodies_.bodyType);
+        }
+        entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D));
     }
 
-    bool Box2Box(float r1x, float r1y, float r1w, float r1h, float r2x, float r2y, float r2w, float r2h)
+    BoxBody BoxBodyManager::GetComponent(core::Entity entity) const
     {
-        return r1x + r1w >= r2x &&    // r1 right edge past r2 left
-            r1x <= r2x + r2w &&    // r1 left edge past r2 right
-            r1y + r1h >= r2y &&    // r1 top edge past r2 bottom
-            r1y <= r2y + r2h;
+        const auto index = sparseSet_.GetIndex(entity);
+        BoxBody body;
+        body.position = SimVec2(bodies_.positionX[index], bodies_.positionY[index]);
+        body.velocity = SimVec2(bodies_.velocityX[index], bodies_.velocityY[index]);
+        body.angularVelocity = SimAngle(bodies_.angularVelocity[index]);
+        body.rotation = SimAngle(bodies_.rotation[index]);
+        body.bodyType = bodies_.bodyType[index];
+        body.extends = SimVec2(bodies_.extendX[index], bodies_.extendY[index]);
+        return body;
+    }
+
+    void BoxBodyManager::SetComponent(core::Entity entity, const BoxBody& body)
+    {
+        const auto index = sparseSet_.GetIndex(entity);
+        bodies_.positionX.Set(index, body.position.x);
+        bodies_.positionY.Set(index, body.position.y);
+        bodies_.velocityX.Set(index, body.velocity.x);
+        bodies_.velocityY.Set(index, body.velocity.y);
+        bodies_.angularVelocity.Set(index, body.angularVelocity.value());
+        bodies_.rotation.Set(index, body.rotation.value());
+        bodies_.bodyType.Set(index, body.bodyType);
+        bodies_.extendX.Set(index, body.extends.x);
+        bodies_.extendY.Set(index, body.extends.y);
+    }
+
+    void BoxBodyManager::CopyAllComponents(const BoxBodyArrays& bodies)
+    {
+        assert(bodies.positionX.size() == bodies_.positionX.size());
+        bodies_ = bodies;
+    }
+
+    void BoxBodyManager::Integrate(Scalar dt)
+    {
+        for (std::size_t page = 0; page < bodies_.positionX.GetPageCount(); page++)
+        {
+            IntegratePage(bodies_.positionX, bodies_.velocityX, page, dt);
+            IntegratePage(bodies_.positionY, bodies_.velocityY, page, dt);
+            IntegratePage(bodies_.rotation, bodies_.angularVelocity, page, dt);
+        }
+#ifdef GAME_FIXED_POINT
+        for (std::size_t index = 0; index < bodies_.rotation.size(); index++)
+        {
+            bodies_.rotation.Set(index, core::WrapDegrees(std::as_const(bodies_.rotation)[index]));
+        }
+#endif
+    }
+
+    void BoxBodyManager::ComputeAabbs(std::vector<Aabb>& aabbs) const
+    {
+        aabbs.resize(bodies_.positionX.size());
+        for (std::size_t page = 0; page < bodies_.positionX.GetPageCount(); page++)
+        {
+            const auto* positionX = bodies_.positionX.GetPage(page);
+            const auto* positionY = bodies_.positionY.GetPage(page);
+            const auto* extendX = bodies_.extendX.GetPage(page);
+            const auto* extendY = bodies_.extendY.GetPage(page);
+            auto* pageAabbs = aabbs.data() + page * core::PagedArray<Scalar>::pageSize;
+            for (std::size_t i = 0; i < bodies_.positionX.GetPageSize(page); i++)
+            {
+                pageAabbs[i].minX = positionX[i] - extendX[i];
+                pageAabbs[i].minY = positionY[i] - extendY[i];
+                pageAabbs[i].maxX = pageAabbs[i].minX + extendX[i] * Scalar(2);
+                pageAabbs[i].maxY = pageAabbs[i].minY + extendY[i] * Scalar(2);
+            }
+        }
+    }
+
+    void StaticCollisionSet::AddBody(core::Entity entity, const BoxBody& body)
+    {
+        const auto it = std::lower_bound(entities_.begin(), entities_.end(), entity);
+        const auto index = std::distance(entities_.begin(), it);
+        const auto aabb = game::GetAabb(body);
+        bodies_.insert(bodies_.begin() + index, body);
+        aabbs_.insert(aabbs_.begin() + index, aabb);
+        entities_.insert(it, entity);
+
+        const auto cellRange = GetCellRange(aabb, cellSize_);
+        for (auto y = cellRange.minY; y <= cellRange.maxY; y++)
+        {
+            for (auto x = cellRange.minX; x <= cellRange.maxX; x++)
+            {
+                cellEntries_.push_back({ GetCellKey(x, y), entity });
+            }
+        }
+        std::sort(cellEntries_.begin(), cellEntries_.end());
+    }
+
+    const BoxBody& StaticCollisionSet::GetBody(core::Entity entity) const
+    {
+        const auto it = std::lower_bound(entities_.begin(), entities_.end(), entity);
+        assert(it != entities_.end() && *it == entity);
+        return bodies_[std::distance(entities_.begin(), it)];
+    }
+
+    const Aabb& StaticCollisionSet::GetAabb(core::Entity entity) const
+    {
+        const auto it = std::lower_bound(entities_.begin(), entities_.end(), entity);
+        assert(it != entities_.end() && *it == entity);
+        return aabbs_[std::distance(entities_.begin(), it)];
+    }
+
+    void StaticCollisionSet::Query(const Aabb& aabb, std::vector<core::Entity>& entities) const
+    {
+        entities.clear();
+        const auto cellRange = GetCellRange(aabb, cellSize_);
+        for (auto y = cellRange.minY; y <= cellRange.maxY; y++)
+        {
+            for (auto x = cellRange.minX; x <= cellRange.maxX; x++)
+            {
+                const auto cell = GetCellKey(x, y);
+                auto entryIt = std::lower_bound(cellEntries_.begin(), cellEntries_.end(), CellEntry{ cell, 0 });
+                for (; entryIt != cellEntries_.end() && entryIt->cell == cell; ++entryIt)
+                {
+                    entities.push_back(entryIt->entity);
+                }
+            }
+        }
+        std::sort(entities.begin(), entities.end());
+        entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+    }
+
+    PhysicsManager::PhysicsManager(core::EntityManager& entityManager, StaticCollisionSet& staticCollisionSet) :
+        entityManager_(entityManager), boxbodyManager_(entityManager), staticCollisionSet_(staticCollisionSet)
+    {
+
     }
 
     void PhysicsManager::FixedUpdate(sf::Time dt)
     {
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        boxbodyManager_.Integrate(dt.asSeconds());
+        boxbodyManager_.ComputeAabbs(aabbs_);
+        const auto& entities = boxbodyManager_.GetEntities();
+        const auto& bodyTypes = boxbodyManager_.GetAllComponents().bodyType;
+
+        //Broadphase: register every dynamic body in the grid cells its AABB overlaps
+        cellEntries_.clear();
+        for (std::size_t index = 0; index < entities.size(); index++)
         {
-            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)))
+            if (!entityManager_.HasComponent(entities[index], static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)))
                 continue;
-            auto body = boxbodyManager_.GetComponent(entity);
-            body.position += body.velocity * dt.asSeconds();
-            body.rotation += body.angularVelocity * dt.asSeconds();
-            boxbodyManager_.SetComponent(entity, body);
+            const auto cellRange = GetCellRange(aabbs_[index], cellSize_);
+            for (auto y = cellRange.minY; y <= cellRange.maxY; y++)
+            {
+                for (auto x = cellRange.minX; x <= cellRange.maxX; x++)
+                {
+                    cellEntries_.push_back({ GetCellKey(x, y), entities[index] });
+                }
+            }
         }
+        std::sort(cellEntries_.begin(), cellEntries_.end());
 
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        //Gather the intersecting pairs, static bodies are only tested against the dynamic ones
+        contacts_.clear();
+        for (std::size_t index = 0; index < entities.size(); index++)
         {
-            if (!entityManager_.HasComponent(entity,
-                static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)) ||
-                entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+            const auto entity = entities[index];
+            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)))
                 continue;
-            for (core::Entity otherEntity = entity; otherEntity < entityManager_.GetEntitiesSize(); otherEntity++)
+            candidates_.clear();
+            const auto cellRange = GetCellRange(aabbs_[index], cellSize_);
+            for (auto y = cellRange.minY; y <= cellRange.maxY; y++)
             {
-                if (entity == otherEntity)
-                    continue;
-                if (!entityManager_.HasComponent(otherEntity,
-                    static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D)) ||
-                    entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-                    continue;
-                BoxBody& boxbody1 = boxbodyManager_.GetComponent(entity);
-
-                BoxBody& boxbody2 = boxbodyManager_.GetComponent(otherEntity);
-
-                if (boxbody1.bodyType == BodyType::STATIC && boxbody2.bodyType == BodyType::STATIC)
+                for (auto x = cellRange.minX; x <= cellRange.maxX; x++)
+                {
+                    const auto cell = GetCellKey(x, y);
+                    auto entryIt = std::upper_bound(cellEntries_.begin(), cellEntries_.end(), CellEntry{ cell, entity });
+                    for (; entryIt != cellEntries_.end() && entryIt->cell == cell; ++entryIt)
+                    {
+                        candidates_.push_back(entryIt->entity);
+                    }
+                }
+            }
+            std::sort(candidates_.begin(), candidates_.end());
+            candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+            for (const auto otherEntity : candidates_)
+            {
+                const auto otherIndex = boxbodyManager_.GetIndex(otherEntity);
+                if (bodyTypes[index] == BodyType::STATIC && bodyTypes[otherIndex] == BodyType::STATIC)
                     continue;
-
-                if (Box2Box(
-                    boxbody1.position.x - boxbody1.extends.x,
-                    boxbody1.position.y - boxbody1.extends.y,
-                    boxbody1.extends.x * 2.0f,
-                    boxbody1.extends.y * 2.0f,
-                    boxbody2.position.x - boxbody2.extends.x,
-                    boxbody2.position.y - boxbody2.extends.y,
-                    boxbody2.extends.x * 2.0f,
-                    boxbody2.extends.y * 2.0f))
+                if (Box2Box(aabbs_[index], aabbs_[otherIndex]))
                 {
-                    core::LogDebug("Intersect");
+                    contacts_.emplace_back(entity, otherEntity);
+                }
+            }
 
-                    ResolveCollision(boxbody1, boxbody2);
-                    //onTriggerAction_.Execute(entity, otherEntity);
+            if (bodyTypes[index] == BodyType::STATIC)
+                continue;
+            staticCollisionSet_.Query(aabbs_[index], candidates_);
+            for (const auto staticEntity : candidates_)
+            {
+                if (Box2Box(aabbs_[index], staticCollisionSet_.GetAabb(staticEntity)))
+                {
+                    contacts_.emplace_back(std::min(entity, staticEntity), std::max(entity, staticEntity));
                 }
+            }
+        }
+        //Resolving in the order of the full double loop keeps the simulation deterministic
+        std::sort(contacts_.begin(), contacts_.end());
 
+        for (const auto& [entity, otherEntity] : contacts_)
+        {
+            if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+                continue;
+            auto boxbody1 = GetBody(entity);
+            auto boxbody2 = GetBody(otherEntity);
 
+            core::LogDebug("Intersect");
+            ResolveCollision(boxbody1, boxbody2);
+            //Bodies of the static collision set are never modified by ResolveCollision
+            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::STATIC_BODY)))
+            {
+                boxbodyManager_.SetComponent(entity, boxbody1);
             }
+            if (!entityManager_.HasComponent(otherEntity, static_cast<core::EntityMask>(ComponentType::STATIC_BODY)))
+            {
+                boxbodyManager_.SetComponent(otherEntity, boxbody2);
+            }
+            //onTriggerAction_.Execute(entity, otherEntity);
         }
     }
 
     void PhysicsManager::SetBoxBody(core::Entity entity, const BoxBody& body)
     {
+        assert(!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::STATIC_BODY)));
         boxbodyManager_.SetComponent(entity, body);
     }
 
-    const BoxBody& PhysicsManager::GetBody(core::Entity entity) const
+    BoxBody PhysicsManager::GetBody(core::Entity entity) const
     {
+        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::STATIC_BODY)))
+        {
+            return staticCollisionSet_.GetBody(entity);
+        }
         return boxbodyManager_.GetComponent(entity);
     }
 
@@ -87,6 +435,12 @@ namespace game
         boxbodyManager_.AddComponent(entity);
     }
 
+    void PhysicsManager::AddStaticBody(core::Entity entity, const BoxBody& body)
+    {
+        staticCollisionSet_.AddBody(entity, body);
+        entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::STATIC_BODY));
+    }
+
     void PhysicsManager::RegisterTriggerListener(OnTriggerInterface& collisionInterface)
     {
         onTriggerAction_.RegisterCallback(
@@ -98,6 +452,16 @@ namespace game
         boxbodyManager_.CopyAllComponents(physicsManager.boxbodyManager_.GetAllComponents());
     }
 
+    const BoxBodyArrays& PhysicsManager::GetAllBodies() const
+    {
+        return boxbodyManager_.GetAllComponents();
+    }
+
+    void PhysicsManager::CopyAllBodies(const BoxBodyArrays& bodies)
+    {
+        boxbodyManager_.CopyAllComponents(bodies);
+    }
+
     void PhysicsManager::ResolveCollision(BoxBody& boxbody1, BoxBody& boxbody2)
     {
         //swap the velocity of both players if they collide 
@@ -112,22 +476,22 @@ namespace game
         if (boxbody1.bodyType == BodyType::STATIC && boxbody2.bodyType == BodyType::DYNAMIC)
         {
             core::LogDebug("Detection Static > Dynamic");
-            if (((boxbody1.position.x - boxbody2.position.x) - ((boxbody2.extends.x + boxbody1.extends.x) / 2)) < 0.1 )
+            if (((boxbody1.position.x - boxbody2.position.x) - ((boxbody2.extends.x + boxbody1.extends.x) / 2)) < Scalar(0.1f))
             {
                 boxbody2.velocity.x = -boxbody2.velocity.x;
             }
 
-            if (((boxbody2.position.x - boxbody1.position.x) - ((boxbody2.extends.x + boxbody1.extends.x) / 2)) < 0.1 )
+            if (((boxbody2.position.x - boxbody1.position.x) - ((boxbody2.extends.x + boxbody1.extends.x) / 2)) < Scalar(0.1f))
             {
                 boxbody2.velocity.x = -boxbody2.velocity.x;
             }
 
-            if (((boxbody1.position.y - boxbody2.position.y) - ((boxbody2.extends.y + boxbody1.extends.y) / 2)) < 0.1)
+            if (((boxbody1.position.y - boxbody2.position.y) - ((boxbody2.extends.y + boxbody1.extends.y) / 2)) < Scalar(0.1f))
             {
                 boxbody2.velocity.y = -boxbody2.velocity.y;
             }
 
-            if (((boxbody2.position.y - boxbody1.position.y) - ((boxbody2.extends.y + boxbody1.extends.y) / 2)) < 0.1)
+            if (((boxbody2.position.y - boxbody1.position.y) - ((boxbody2.extends.y + boxbody1.extends.y) / 2)) < Scalar(0.1f))
             {
                 boxbody2.velocity.y = -boxbody2.velocity.y;
             }
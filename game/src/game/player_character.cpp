@@ -3,6 +3,8 @@
 #include <game/physics_manager.h>
 #include <utils/log.h>
 
+#include <utility>
+
 namespace game
 {
     PlayerCharacterManager::PlayerCharacterManager(core::EntityManager& entityManager, PhysicsManager& physicsManager, GameManager& gameManager) :
@@ -16,33 +18,21 @@ namespace game
 
     void PlayerCharacterManager::FixedUpdate(sf::Time dt)
     {
-        for (core::Entity playerEntity = 0; playerEntity < entityManager_.GetEntitiesSize(); playerEntity++)
+        for (const auto playerEntity : components_.GetEntities())
         {
             if (!entityManager_.HasComponent(playerEntity, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
                 continue;
 
             auto playerBody = physicsManager_.GetBody(playerEntity);
-            auto playerCharacter = GetComponent(playerEntity);
+            //Read through the const access, the page is only duplicated if the player changes
+            auto playerCharacter = std::as_const(*this).GetComponent(playerEntity);
             const auto input = playerCharacter.input;
 
             //check if the player position exceed 100 in y to know if he win the game 
             if (playerBody.position.y >= 100)
             {
-                auto firstPlayerEntity = gameManager_.GetEntityFromPlayerNumber(0);
-                auto secondPlayerEntity = gameManager_.GetEntityFromPlayerNumber(1);
-
-                if (playerEntity == firstPlayerEntity)
-                {
-                    auto player = GetComponent(firstPlayerEntity);
-                    player.player1win++;
-                    SetComponent(firstPlayerEntity, player);
-                }
-                if (playerEntity == secondPlayerEntity)
-                {
-                    auto player = GetComponent(secondPlayerEntity);
-                    player.player2win++;
-                    SetComponent(secondPlayerEntity, player);
-                }
+                playerCharacter.winCount++;
+                SetComponent(playerEntity, playerCharacter);
             }
 
 
@@ -51,14 +41,14 @@ namespace game
             const bool up = input & PlayerInputEnum::PlayerInput::UP;
             const bool down = input & PlayerInputEnum::PlayerInput::DOWN;
 
-            const auto angularVelocity = ((left ? -1.5f : 0.0f) + (right ? 1.5f : 0.0f)) * playerAngularSpeed;
+            const auto angularVelocity = SimAngle(playerAngularSpeed) * Scalar((left ? -1.5f : 0.0f) + (right ? 1.5f : 0.0f));
 
             playerBody.angularVelocity = angularVelocity;
 
-            auto dir = core::Vec2f::up();
+            auto dir = SimVec2::up();
             dir = dir.Rotate(-(playerBody.rotation + playerBody.angularVelocity * dt.asSeconds()));
 
-            const auto acceleration = ((down ? -1.5f : 0.0f) + (up ? 1.5f : 0.0f)) * dir;
+            const auto acceleration = Scalar((down ? -1.5f : 0.0f) + (up ? 1.5f : 0.0f)) * dir;
 
             playerBody.velocity += acceleration * dt.asSeconds();
 
@@ -1,84 +1,93 @@
 #include <game/rollback_manager.h>
 #include <game/game_manager.h>
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
+#include <utility>
+#include <utils/hash.h>
 #include <utils/log.h>
 #include <fmt/format.h>
 
 namespace game
 {
+    namespace
+    {
+        /**
+         * \brief Hashes the values page after page, the same bytes in the same order as a contiguous array
+         */
+        template<typename T, std::size_t PageSize>
+        void UpdatePagedHash(core::Hasher& hasher, const core::PagedArray<T, PageSize>& values)
+        {
+            static_assert(std::has_unique_object_representations_v<T> || std::is_floating_point_v<T>);
+            for (std::size_t page = 0; page < values.GetPageCount(); page++)
+            {
+                hasher.Update(values.GetPage(page), values.GetPageSize(page) * sizeof(T));
+            }
+        }
+    }
 
     RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager& entityManager) :
         gameManager_(gameManager), entityManager_(entityManager),
         currentTransformManager_(entityManager),
-        currentPhysicsManager_(entityManager), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
-        lastValidatePhysicsManager_(entityManager),
+        currentPhysicsManager_(entityManager, staticCollisionSet_), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
+        lastValidatePhysicsManager_(entityManager, staticCollisionSet_),
         lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_),
         boxBodyManager_(entityManager)
     {
-        for (auto& input : inputs_)
-        {
-            std::fill(input.begin(), input.end(), 0u);
-        }
         currentPhysicsManager_.RegisterTriggerListener(*this);
     }
 
     void RollbackManager::SimulateToCurrentFrame()
     {
         const auto currentFrame = gameManager_.GetCurrentFrame();
-        const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-        //Destroying all created Entities after the last validated frame
-        for (const auto& createdEntity : createdEntities_)
+        Frame startFrame = lastSimulatedFrame_ + 1;
+        if (dirtyFrame_ > lastSimulatedFrame_)
         {
-            if (createdEntity.createdFrame > lastValidateFrame)
+            //Predicted inputs matched the received ones, only the new frames need to be simulated
+            dirtyFrame_ = INVALID_FRAME;
+            if (startFrame > currentFrame)
             {
-                entityManager_.DestroyEntity(createdEntity.entity);
+                return;
             }
+            rollbacksAvoided_++;
         }
-        createdEntities_.clear();
-        //Remove DESTROY flags
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        else
         {
-            if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+            //A late input changed an already simulated frame, we restart from the frame before it
+            const auto restoredFrame = RestoreSnapshot(dirtyFrame_ > lastValidateFrame_ ? dirtyFrame_ - 1 : lastValidateFrame_);
+            startFrame = restoredFrame + 1;
+            //Destroying all created Entities after the restored frame
+            for (const auto& createdEntity : createdEntities_)
             {
-                entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+                if (createdEntity.createdFrame > restoredFrame && entityManager_.IsAlive(createdEntity.handle))
+                {
+                    entityManager_.DestroyEntity(core::EntityManager::GetEntity(createdEntity.handle));
+                }
             }
+            createdEntities_.erase(std::remove_if(createdEntities_.begin(), createdEntities_.end(),
+                [restoredFrame](const CreatedEntity& createdEntity)
+                {
+                    return createdEntity.createdFrame > restoredFrame;
+                }), createdEntities_.end());
+            RestoreDestroyedEntities(restoredFrame);
+            dirtyFrame_ = INVALID_FRAME;
+            framesResimulated_ += lastSimulatedFrame_ - restoredFrame;
         }
-        
-        //Revert the current game state to the last validated game state
-        currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
-        currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
 
-        for (Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
+        for (Frame frame = startFrame; frame <= currentFrame; frame++)
         {
-            testedFrame_ = frame;
-            //Copy player inputs to player manager
-            for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-            {
-                const auto playerInput = GetInputAtFrame(playerNumber, frame);
-                const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-                if(playerEntity == core::EntityManager::INVALID_ENTITY)
-                {
-                    core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
-                    continue;
-                }
-                auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-                playerCharacter.input = playerInput;
-                currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-            }
-            //Simulate one frame of the game
-            currentPlayerManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
-            currentPhysicsManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
+            SimulateFrame(frame);
+            SaveSnapshot(frame);
+            lastSimulatedFrame_ = frame;
         }
         //Copy the physics states to the transforms
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        for (const auto entity : entityManager_.GetView(
+            static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D) |
+            static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
         {
-            if (!entityManager_.HasComponent(entity,
-                                             static_cast<core::EntityMask>(core::ComponentType::BOXBODY2D) |
-                                             static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
-                continue;
             const auto& body = currentPhysicsManager_.GetBody(entity);
-            currentTransformManager_.SetPosition(entity, body.position);
-            currentTransformManager_.SetRotation(entity, body.rotation);
+            currentTransformManager_.SetPosition(entity, core::ToVec2f(body.position));
+            currentTransformManager_.SetRotation(entity, core::ToDegree(body.rotation));
         }
     }
     void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame)
@@ -88,38 +97,40 @@ namespace game
         {
             StartNewFrame(inputFrame);
         }
-        inputs_[playerNumber][currentFrame_ - inputFrame] = playerInput;
-        if (lastReceivedFrame_[playerNumber] < inputFrame)
+        //Only a changed input invalidates the frames simulated with the predicted one
+        dirtyFrame_ = std::min(dirtyFrame_, inputs_[playerNumber].SetInput(inputFrame, playerInput));
+    }
+
+    void RollbackManager::SetPlayerInputs(PlayerNumber playerNumber, Frame newestFrame, const PlayerInput* playerInputs, std::size_t count)
+    {
+        if (currentFrame_ < newestFrame)
         {
-            lastReceivedFrame_[playerNumber] = inputFrame;
-            //Repeat the same inputs until currentFrame
-            for (size_t i = 0; i < currentFrame_ - inputFrame; i++)
-            {
-                inputs_[playerNumber][i] = playerInput;
-            }
+            StartNewFrame(newestFrame);
         }
+        dirtyFrame_ = std::min(dirtyFrame_, inputs_[playerNumber].SetInputs(newestFrame, playerInputs, count));
     }
 
-    void RollbackManager::StartNewFrame(Frame newFrame)
+    void RollbackManager::SetPlayerCount(PlayerNumber playerCount)
     {
-        if (currentFrame_ > newFrame)
-            return;
-        const auto delta = newFrame - currentFrame_;
-        if (delta == 0)
+        assert(playerCount <= maxPlayerNmb);
+        inputs_.resize(playerCount);
+        if (matchReplay_ != nullptr)
         {
-            return;
+            matchReplay_->SetPlayerCount(playerCount);
         }
         for (auto& inputs : inputs_)
         {
-            for (auto i = inputs.size() - 1; i >= delta; i--)
-            {
-                inputs[i] = inputs[i - delta];
-            }
+            inputs.StartNewFrame(currentFrame_);
+        }
+    }
 
-            for (Frame i = 0; i < delta; i++)
-            {
-                inputs[i] = inputs[delta];
-            }
+    void RollbackManager::StartNewFrame(Frame newFrame)
+    {
+        if (currentFrame_ > newFrame)
+            return;
+        for (auto& inputs : inputs_)
+        {
+            inputs.StartNewFrame(newFrame);
         }
         currentFrame_ = newFrame;
     }
@@ -127,34 +138,39 @@ namespace game
     void RollbackManager::ValidateFrame(Frame newValidateFrame)
     {
         const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
-        //Destroying all created Entities after the last validated frame
-        for (const auto& createdEntity : createdEntities_)
+        const auto firstValidateFrame = lastValidateFrame_ + 1;
+        //We check that we got all the inputs
+        for (PlayerNumber playerNumber = 0; playerNumber < GetPlayerCount(); playerNumber++)
         {
-            if (createdEntity.createdFrame > lastValidateFrame)
+            if (GetLastContiguousFrame(playerNumber) < newValidateFrame)
             {
-                entityManager_.DestroyEntity(createdEntity.entity);
+                assert(false && "We should not validate a frame if we did not receive all inputs!!!");
+                return;
             }
         }
-        createdEntities_.clear();
-        //Remove DESTROYED flag
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        //The new validate frame was already simulated with the right inputs, we only keep its snapshot
+        const auto& snapshot = frameSnapshots_[newValidateFrame % windowBufferSize];
+        if (snapshot.frame == newValidateFrame && newValidateFrame <= lastSimulatedFrame_ &&
+            newValidateFrame < dirtyFrame_ && createdEntities_.empty())
         {
-            if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-            {
-                entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
-            }
-
+            lastValidatePhysicsManager_.CopyAllBodies(snapshot.boxBodies);
+            lastValidatePlayerManager_.CopyAllComponents(snapshot.playerCharacters);
+            //The flags put after the new validate frame stay, these frames can still be simulated again
+            DestroyValidatedEntities(newValidateFrame);
+            lastValidateFrame_ = newValidateFrame;
+            RecordValidatedFrames(firstValidateFrame, newValidateFrame);
+            return;
         }
-        createdEntities_.clear();
-        //We check that we got all the inputs
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        //Destroying all created Entities after the last validated frame
+        for (const auto& createdEntity : createdEntities_)
         {
-            if (GetLastReceivedFrame(playerNumber) < newValidateFrame)
+            if (createdEntity.createdFrame > lastValidateFrame && entityManager_.IsAlive(createdEntity.handle))
             {
-                assert(false && "We should not validate a frame if we did not receive all inputs!!!");
-                return;
+                entityManager_.DestroyEntity(core::EntityManager::GetEntity(createdEntity.handle));
             }
         }
+        createdEntities_.clear();
+        RestoreDestroyedEntities(lastValidateFrame_);
         //We use the current game state as the temporary new validate game state
         currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
         currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
@@ -162,93 +178,155 @@ namespace game
         //We simulate the frames until the new validated frame
         for (Frame frame = lastValidateFrame_ + 1; frame <= newValidateFrame; frame++)
         {
-            testedFrame_ = frame;
-            //Copy the players inputs into the player manager
-            for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
-            {
-                const auto playerInput = GetInputAtFrame(playerNumber, frame);
-                const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-                auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-                playerCharacter.input = playerInput;
-                currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-            }
-            //We simulate one frame
-            currentPlayerManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
-            currentPhysicsManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
-        }
-        //Definitely remove DESTROY entities
-        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-        {
-            if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-            {
-                entityManager_.DestroyEntity(entity);
-            }
+            SimulateFrame(frame);
+            SaveSnapshot(frame);
         }
+        DestroyValidatedEntities(newValidateFrame);
         //Copy back the new validate game state to the last validated game state
         lastValidatePlayerManager_.CopyAllComponents(currentPlayerManager_.GetAllComponents());
         lastValidatePhysicsManager_.CopyAllComponents(currentPhysicsManager_);
         lastValidateFrame_ = newValidateFrame;
+        //The current game state is now at the new validate frame, the next frames need to be simulated again
+        lastSimulatedFrame_ = newValidateFrame;
+        dirtyFrame_ = INVALID_FRAME;
         createdEntities_.clear();
+        RecordValidatedFrames(firstValidateFrame, newValidateFrame);
     }
-    void RollbackManager::ConfirmFrame(Frame newValidateFrame, const std::array<PhysicsState, maxPlayerNmb>& serverPhysicsState)
+    void RollbackManager::ConfirmFrame(Frame newValidateFrame, const StateHash& serverStateHash, std::size_t serverPartCount)
     {
         ValidateFrame(newValidateFrame);
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        const auto stateHash = GetValidateStateHash();
+        if (stateHash.full != serverStateHash.full)
         {
-            const PhysicsState lastPhysicsState = GetValidatePhysicsState(playerNumber);
-            if (serverPhysicsState[playerNumber] != lastPhysicsState)
+            static constexpr std::array<const char*, StateHash::PART_COUNT> partNames{ "BoxBody", "PlayerCharacter" };
+            for (std::size_t part = 0; part < std::min<std::size_t>(serverPartCount, StateHash::PART_COUNT); part++)
             {
-                assert(false && "Physics State are not equal");
+                if (stateHash.parts[part] != serverStateHash.parts[part])
+                {
+                    core::LogError(fmt::format("[Rollback] {} state diverged from the server at frame {}",
+                        partNames[part], newValidateFrame));
+                }
             }
+            if (matchReplay_ != nullptr)
+            {
+                matchReplay_->Flush();
+            }
+            assert(false && "Physics State are not equal");
         }
     }
-    PhysicsState RollbackManager::GetValidatePhysicsState(PlayerNumber playerNumber) const
+
+    StateHash RollbackManager::GetValidateStateHash() const
     {
-        PhysicsState state = 0;
-        const core::Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
-        const auto& playerBody = lastValidatePhysicsManager_.GetBody(playerEntity);
-
-        const auto pos = playerBody.position;
-        const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
-        //Adding position
-        for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+        StateHash stateHash;
+        const auto& bodies = lastValidatePhysicsManager_.GetAllBodies();
+        core::Hasher bodyHasher;
+        UpdatePagedHash(bodyHasher, bodies.positionX);
+        UpdatePagedHash(bodyHasher, bodies.positionY);
+        UpdatePagedHash(bodyHasher, bodies.velocityX);
+        UpdatePagedHash(bodyHasher, bodies.velocityY);
+        UpdatePagedHash(bodyHasher, bodies.angularVelocity);
+        UpdatePagedHash(bodyHasher, bodies.rotation);
+        UpdatePagedHash(bodyHasher, bodies.extendX);
+        UpdatePagedHash(bodyHasher, bodies.extendY);
+        UpdatePagedHash(bodyHasher, bodies.bodyType);
+        stateHash.parts[StateHash::BOX_BODY] = bodyHasher.Digest();
+
+        core::Hasher playerHasher;
+        playerHasher.Update(lastValidatePlayerManager_.GetEntities());
+        //PlayerCharacter has padding, its fields are hashed one by one
+        const auto& playerCharacters = lastValidatePlayerManager_.GetAllComponents();
+        for (std::size_t index = 0; index < playerCharacters.size(); index++)
         {
-            state += posPtr[i];
+            const auto& playerCharacter = playerCharacters[index];
+            playerHasher.UpdateValue(playerCharacter.input);
+            playerHasher.UpdateValue(playerCharacter.playerNumber);
+            playerHasher.UpdateValue(playerCharacter.winCount);
         }
+        stateHash.parts[StateHash::PLAYER_CHARACTER] = playerHasher.Digest();
+
+        stateHash.full = core::Hash64(stateHash.parts.data(), sizeof(stateHash.parts));
+        return stateHash;
+    }
 
-        //Adding velocity
-        const auto velocity = playerBody.velocity;
-        const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-        for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
+    void RollbackManager::SetMatchReplay(MatchReplayWriter* matchReplay)
+    {
+        matchReplay_ = matchReplay;
+        if (matchReplay_ != nullptr)
         {
-            state += velocityPtr[i];
+            matchReplay_->SetPlayerCount(GetPlayerCount());
         }
-        //Adding rotation
-        const auto angle = playerBody.rotation.value();
-        const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-        for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+    }
+
+    void RollbackManager::RestoreDestroyedEntities(Frame frame)
+    {
+        for (const auto& destroyedEntity : destroyedEntities_)
         {
-            state += anglePtr[i];
+            if (destroyedEntity.destroyedFrame > frame && entityManager_.IsAlive(destroyedEntity.handle))
+            {
+                entityManager_.RemoveComponent(core::EntityManager::GetEntity(destroyedEntity.handle),
+                    static_cast<core::EntityMask>(ComponentType::DESTROYED));
+            }
         }
-        //Adding angular Velocity
-        const auto angularVelocity = playerBody.angularVelocity.value();
-        const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-        for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
+        destroyedEntities_.erase(std::remove_if(destroyedEntities_.begin(), destroyedEntities_.end(),
+            [frame](const DestroyedEntity& destroyedEntity)
+            {
+                return destroyedEntity.destroyedFrame > frame;
+            }), destroyedEntities_.end());
+    }
+
+    void RollbackManager::DestroyValidatedEntities(Frame validatedFrame)
+    {
+        for (const auto& destroyedEntity : destroyedEntities_)
+        {
+            if (destroyedEntity.destroyedFrame <= validatedFrame && entityManager_.IsAlive(destroyedEntity.handle))
+            {
+                entityManager_.DestroyEntity(core::EntityManager::GetEntity(destroyedEntity.handle));
+            }
+        }
+        destroyedEntities_.erase(std::remove_if(destroyedEntities_.begin(), destroyedEntities_.end(),
+            [validatedFrame](const DestroyedEntity& destroyedEntity)
+            {
+                return destroyedEntity.destroyedFrame <= validatedFrame;
+            }), destroyedEntities_.end());
+    }
+
+    void RollbackManager::RecordValidatedFrames(Frame firstFrame, Frame lastFrame)
+    {
+        if (matchReplay_ == nullptr)
+            return;
+        std::array<PlayerInput, maxPlayerNmb> inputs{};
+        for (Frame frame = firstFrame; frame <= lastFrame; frame++)
         {
-            state += angularVelPtr[i];
+            for (PlayerNumber playerNumber = 0; playerNumber < GetPlayerCount(); playerNumber++)
+            {
+                inputs[playerNumber] = GetInputAtFrame(playerNumber, frame);
+            }
+            //Only the state at the end of the validation is available without simulating again
+            if (frame == lastFrame && matchReplay_->HasStateHashes())
+            {
+                const auto stateHash = GetValidateStateHash();
+                matchReplay_->WriteFrame(frame, inputs.data(), &stateHash);
+            }
+            else
+            {
+                matchReplay_->WriteFrame(frame, inputs.data());
+            }
         }
-        return state;
     }
 
     void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::degree_t rotation)
     {
         BoxBody playerBoxBody;
-        playerBoxBody.position = position;
-        playerBoxBody.rotation = rotation;
-        playerBoxBody.extends = core::Vec2f(0.64, 0.55) / 2;
+        playerBoxBody.position = SimVec2(position);
+        playerBoxBody.rotation = SimAngle(rotation);
+        playerBoxBody.extends = SimVec2(0.64f, 0.55f) / 2;
 
         PlayerCharacter playerCharacter;
         playerCharacter.playerNumber = playerNumber;
+        if (matchReplay_ != nullptr)
+        {
+            matchReplay_->WriteSpawn(playerNumber, position, rotation);
+        }
 
         currentPlayerManager_.AddComponent(entity);
         currentPlayerManager_.SetComponent(entity, playerCharacter);
@@ -261,6 +339,7 @@ namespace game
 
         lastValidatePhysicsManager_.AddBoxBody(entity);
         lastValidatePhysicsManager_.SetBoxBody(entity, playerBoxBody);
+        InvalidateSnapshots();
       
         currentTransformManager_.AddComponent(entity);
         currentTransformManager_.SetPosition(entity, position);
@@ -270,16 +349,13 @@ namespace game
     void RollbackManager::SpawnBox(core::Entity entity, core::Vec2f position)
     {
         BoxBody boxBoxBody;
-        boxBoxBody.position = position;
-        boxBoxBody.extends = core::Vec2f(1.28, 0.32) / 2;
+        boxBoxBody.position = SimVec2(position);
+        boxBoxBody.extends = SimVec2(1.28f, 0.32f) / 2;
         boxBoxBody.bodyType = BodyType::STATIC;
         
        
-        currentPhysicsManager_.AddBoxBody(entity);
-        currentPhysicsManager_.SetBoxBody(entity, boxBoxBody);
-
-        lastValidatePhysicsManager_.AddBoxBody(entity);
-        lastValidatePhysicsManager_.SetBoxBody(entity, boxBoxBody);
+        //The static collision set is shared with lastValidatePhysicsManager_
+        currentPhysicsManager_.AddStaticBody(entity, boxBoxBody);
 
         currentTransformManager_.AddComponent(entity);
         currentTransformManager_.SetPosition(entity, position);
@@ -289,7 +365,7 @@ namespace game
     void RollbackManager::SpawnFlag(core::Entity entity, core::Vec2f position)
     {
         BoxBody flagBoxBody;
-        flagBoxBody.position = position;
+        flagBoxBody.position = SimVec2(position);
         flagBoxBody.bodyType = BodyType::STATIC;
         
 
@@ -300,7 +376,7 @@ namespace game
     void RollbackManager::SpawnTrack(core::Entity entity, core::Vec2f position)
     {
         BoxBody trackBoxBody;
-        trackBoxBody.position = position;
+        trackBoxBody.position = SimVec2(position);
         trackBoxBody.bodyType = BodyType::STATIC;
         
 
@@ -311,15 +387,12 @@ namespace game
     void RollbackManager::SpawnWall(core::Entity entity, core::Vec2f position)
     {
         BoxBody wallBoxBody;
-        wallBoxBody.position = position;
-        wallBoxBody.extends = core::Vec2f(0.32, 110) / 2;
+        wallBoxBody.position = SimVec2(position);
+        wallBoxBody.extends = SimVec2(0.32f, 110.0f) / 2;
         wallBoxBody.bodyType = BodyType::STATIC;
 
-        currentPhysicsManager_.AddBoxBody(entity);
-        currentPhysicsManager_.SetBoxBody(entity, wallBoxBody);
-
-        lastValidatePhysicsManager_.AddBoxBody(entity);
-        lastValidatePhysicsManager_.SetBoxBody(entity, wallBoxBody);
+        //The static collision set is shared with lastValidatePhysicsManager_
+        currentPhysicsManager_.AddStaticBody(entity, wallBoxBody);
 
         currentTransformManager_.AddComponent(entity);
         currentTransformManager_.SetPosition(entity, position);
@@ -328,16 +401,13 @@ namespace game
     void RollbackManager::SpawnGreatBox(core::Entity entity, core::Vec2f position)
     {
         BoxBody greatBoxBoxBody;
-        greatBoxBoxBody.position = position;
-        greatBoxBoxBody.extends = core::Vec2f(3.84, 0.32) / 2;
+        greatBoxBoxBody.position = SimVec2(position);
+        greatBoxBoxBody.extends = SimVec2(3.84f, 0.32f) / 2;
         greatBoxBoxBody.bodyType = BodyType::STATIC;
 
 
-        currentPhysicsManager_.AddBoxBody(entity);
-        currentPhysicsManager_.SetBoxBody(entity, greatBoxBoxBody);
-
-        lastValidatePhysicsManager_.AddBoxBody(entity);
-        lastValidatePhysicsManager_.SetBoxBody(entity, greatBoxBoxBody);
+        //The static collision set is shared with lastValidatePhysicsManager_
+        currentPhysicsManager_.AddStaticBody(entity, greatBoxBoxBody);
 
         currentTransformManager_.AddComponent(entity);
         currentTransformManager_.SetPosition(entity, position);
@@ -345,24 +415,76 @@ namespace game
 
     PlayerInput RollbackManager::GetInputAtFrame(PlayerNumber playerNumber, Frame frame)
     {
-        assert(currentFrame_ - frame < inputs_[playerNumber].size() &&
-            "Trying to get input too far in the past");
-        return inputs_[playerNumber][currentFrame_ - frame];
+        return inputs_[playerNumber].GetInput(frame);
+    }
+
+    void RollbackManager::SimulateFrame(Frame frame)
+    {
+        testedFrame_ = frame;
+        //Copy player inputs to player manager
+        for (PlayerNumber playerNumber = 0; playerNumber < GetPlayerCount(); playerNumber++)
+        {
+            const auto playerInput = GetInputAtFrame(playerNumber, frame);
+            const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
+            if (playerEntity == core::EntityManager::INVALID_ENTITY)
+            {
+                core::LogWarning(fmt::format("Invalid Entity in {}:line {}", __FILE__, __LINE__));
+                continue;
+            }
+            auto playerCharacter = std::as_const(currentPlayerManager_).GetComponent(playerEntity);
+            playerCharacter.input = playerInput;
+            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+        }
+        //Simulate one frame of the game
+        currentPlayerManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
+        currentPhysicsManager_.FixedUpdate(sf::seconds(GameManager::FixedPeriod));
+    }
+
+    void RollbackManager::SaveSnapshot(Frame frame)
+    {
+        auto& snapshot = frameSnapshots_[frame % windowBufferSize];
+        snapshot.frame = frame;
+        snapshot.boxBodies = currentPhysicsManager_.GetAllBodies();
+        snapshot.playerCharacters = currentPlayerManager_.GetAllComponents();
+    }
+
+    Frame RollbackManager::RestoreSnapshot(Frame frame)
+    {
+        const auto& snapshot = frameSnapshots_[frame % windowBufferSize];
+        if (frame <= lastValidateFrame_ || snapshot.frame != frame)
+        {
+            currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
+            currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+            return lastValidateFrame_;
+        }
+        currentPhysicsManager_.CopyAllBodies(snapshot.boxBodies);
+        currentPlayerManager_.CopyAllComponents(snapshot.playerCharacters);
+        return frame;
+    }
+
+    void RollbackManager::InvalidateSnapshots()
+    {
+        for (auto& snapshot : frameSnapshots_)
+        {
+            snapshot.frame = INVALID_FRAME;
+        }
     }
 
 
     void RollbackManager::DestroyEntity(core::Entity entity)
     {
         //we don't need to save a bullet that has been created in the time window
-        if (std::find_if(createdEntities_.begin(), createdEntities_.end(), [entity](auto newEntity)
+        const auto handle = entityManager_.GetHandle(entity);
+        if (std::find_if(createdEntities_.begin(), createdEntities_.end(), [handle](auto newEntity)
             {
-                return newEntity.entity == entity;
+                return newEntity.handle == handle;
             }) != createdEntities_.end())
         {
             entityManager_.DestroyEntity(entity);
             return;
         }
         entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+        destroyedEntities_.push_back({ handle, testedFrame_ });
     }
 
     void RollbackManager::OnTrigger(core::Entity entity1, core::Entity entity2)
@@ -0,0 +1,187 @@
+#include <network/batch_udp_socket.h>
+#include <network/socket_handle.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace game
+{
+#ifdef __linux__
+    struct BatchUdpSocket::SystemBatch
+    {
+        std::vector<mmsghdr> receiveHeaders;
+        std::vector<iovec> receiveVectors;
+        std::vector<sockaddr_in> receiveAddresses;
+        std::vector<mmsghdr> sendHeaders;
+        std::vector<iovec> sendVectors;
+        std::vector<sockaddr_in> sendAddresses;
+    };
+#else
+    struct BatchUdpSocket::SystemBatch
+    {
+    };
+#endif
+
+    BatchUdpSocket::BatchUdpSocket(std::size_t batchSize) :
+        batchSize_(batchSize),
+        receiveBuffer_(batchSize * maxDatagramSize),
+        receivedDatagrams_(batchSize),
+        sendBuffer_(batchSize * maxDatagramSize),
+        sendDatagrams_(batchSize),
+        systemBatch_(std::make_unique<SystemBatch>())
+    {
+        assert(batchSize > 0);
+#ifdef __linux__
+        auto& batch = *systemBatch_;
+        batch.receiveHeaders.resize(batchSize);
+        batch.receiveVectors.resize(batchSize);
+        batch.receiveAddresses.resize(batchSize);
+        batch.sendHeaders.resize(batchSize);
+        batch.sendVectors.resize(batchSize);
+        batch.sendAddresses.resize(batchSize);
+        //The headers point to the preallocated buffers once and for all, only the lengths change
+        for (std::size_t i = 0; i < batchSize; i++)
+        {
+            batch.receiveVectors[i].iov_base = receiveBuffer_.data() + i * maxDatagramSize;
+            batch.receiveVectors[i].iov_len = maxDatagramSize;
+            auto& receiveHeader = batch.receiveHeaders[i].msg_hdr;
+            receiveHeader.msg_iov = &batch.receiveVectors[i];
+            receiveHeader.msg_iovlen = 1;
+            receiveHeader.msg_name = &batch.receiveAddresses[i];
+
+            batch.sendVectors[i].iov_base = sendBuffer_.data() + i * maxDatagramSize;
+            auto& sendHeader = batch.sendHeaders[i].msg_hdr;
+            sendHeader.msg_iov = &batch.sendVectors[i];
+            sendHeader.msg_iovlen = 1;
+            sendHeader.msg_name = &batch.sendAddresses[i];
+            sendHeader.msg_namelen = sizeof(sockaddr_in);
+        }
+#endif
+    }
+
+    BatchUdpSocket::~BatchUdpSocket() = default;
+
+    std::size_t BatchUdpSocket::Receive()
+    {
+        std::size_t received = 0;
+#ifdef __linux__
+        auto& batch = *systemBatch_;
+        for (auto& header : batch.receiveHeaders)
+        {
+            header.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            header.msg_hdr.msg_flags = 0;
+        }
+        const auto count = recvmmsg(GetSocketHandle(socket_), batch.receiveHeaders.data(),
+            static_cast<unsigned int>(batchSize_), MSG_DONTWAIT, nullptr);
+        for (int i = 0; i < count; i++)
+        {
+            const auto& header = batch.receiveHeaders[i];
+            if (header.msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                continue;
+            }
+            const auto& address = batch.receiveAddresses[i];
+            auto& datagram = receivedDatagrams_[received];
+            datagram.data = static_cast<const std::uint8_t*>(batch.receiveVectors[i].iov_base);
+            datagram.size = header.msg_len;
+            datagram.address = sf::IpAddress(ntohl(address.sin_addr.s_addr));
+            datagram.port = ntohs(address.sin_port);
+            received++;
+        }
+#else
+        while (received < batchSize_)
+        {
+            auto& datagram = receivedDatagrams_[received];
+            auto* data = receiveBuffer_.data() + received * maxDatagramSize;
+            if (socket_.receive(data, maxDatagramSize, datagram.size, datagram.address, datagram.port) != sf::Socket::Done)
+            {
+                break;
+            }
+            datagram.data = data;
+            received++;
+        }
+#endif
+        return received;
+    }
+
+    void BatchUdpSocket::Send(const void* data, std::size_t size, const sf::IpAddress& address, unsigned short port)
+    {
+        if (size > maxDatagramSize)
+        {
+            socket_.send(data, size, address, port);
+            return;
+        }
+        if (sendCount_ == batchSize_)
+        {
+            Flush();
+        }
+        auto* slot = sendBuffer_.data() + sendCount_ * maxDatagramSize;
+        std::copy_n(static_cast<const std::uint8_t*>(data), size, slot);
+        auto& datagram = sendDatagrams_[sendCount_];
+        datagram.data = slot;
+        datagram.size = size;
+        datagram.address = address;
+        datagram.port = port;
+        sendCount_++;
+    }
+
+    std::size_t BatchUdpSocket::Flush()
+    {
+        std::size_t sent = 0;
+#ifdef __linux__
+        auto& batch = *systemBatch_;
+        for (std::size_t i = 0; i < sendCount_; i++)
+        {
+            const auto& datagram = sendDatagrams_[i];
+            batch.sendVectors[i].iov_len = datagram.size;
+            auto& address = batch.sendAddresses[i];
+            address = sockaddr_in{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(datagram.address.toInteger());
+            address.sin_port = htons(datagram.port);
+        }
+        std::size_t next = 0;
+        while (next < sendCount_)
+        {
+            const auto count = sendmmsg(GetSocketHandle(socket_), batch.sendHeaders.data() + next,
+                static_cast<unsigned int>(sendCount_ - next), MSG_DONTWAIT);
+            if (count > 0)
+            {
+                next += static_cast<std::size_t>(count);
+                sent += static_cast<std::size_t>(count);
+                continue;
+            }
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            //A full socket buffer refuses the rest of the batch too
+            if (count == 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            //Only the datagram at the front failed, for instance with an unreachable address
+            next++;
+        }
+#else
+        for (std::size_t i = 0; i < sendCount_; i++)
+        {
+            const auto& datagram = sendDatagrams_[i];
+            if (socket_.send(datagram.data, datagram.size, datagram.address, datagram.port) == sf::Socket::Done)
+            {
+                sent++;
+            }
+        }
+#endif
+        droppedCount_ += sendCount_ - sent;
+        sendCount_ = 0;
+        return sent;
+    }
+}
@@ -0,0 +1,34 @@
+#include <network/bot_client.h>
+
+#include "maths/basic.h"
+
+namespace game
+{
+    BotClient::BotClient(const sf::IpAddress& serverAddress, unsigned short serverPort, MatchId matchId) :
+        joinAddress_(serverAddress),
+        joinPort_(serverPort),
+        joinMatchId_(matchId)
+    {
+    }
+
+    void BotClient::Init()
+    {
+        ClientNetworkManager::Init();
+        Join(joinAddress_, joinPort_, joinMatchId_);
+    }
+
+    void BotClient::Update(sf::Time dt)
+    {
+        //Keeps its input for about a second on average, always driving forward
+        constexpr int inputChangeOdds = 50;
+        if (gameManager_.GetState() & ClientGameManager::STARTED)
+        {
+            if (core::RandomRange(0, inputChangeOdds) == 0)
+            {
+                input_ = static_cast<PlayerInput>((core::RandomRange(0, 15) & ~PlayerInputEnum::DOWN) | PlayerInputEnum::UP);
+            }
+            SetPlayerInput(input_);
+        }
+        ClientNetworkManager::Update(dt);
+    }
+}
@@ -38,20 +38,22 @@ namespace game
             const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet);
             const auto playerNumber = playerInputPacket->playerNumber;
             const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+            if (playerNumber >= gameManager_.GetPlayerCount())
+            {
+                break;
+            }
 
             if (playerNumber == gameManager_.GetPlayerNumber())
             {
                 //Verify the inputs coming back from the server
                 const auto& inputs = gameManager_.GetRollbackManager().GetInputs(playerNumber);
-                const auto currentFrame = gameManager_.GetRollbackManager().GetCurrentFrame();
-                for (size_t i = 0; i < playerInputPacket->inputs.size(); i++)
+                for (Frame i = 0; i < playerInputPacket->inputCount; i++)
                 {
-                    const auto index = currentFrame - inputFrame + i;
-                    if (index > inputs.size())
+                    if (!inputs.Contains(inputFrame - i))
                     {
                         break;
                     }
-                    if (inputs[index] != playerInputPacket->inputs[i])
+                    if (inputs.GetInput(inputFrame - i) != playerInputPacket->inputs[i])
                     {
                         assert(false && "Inputs coming back from server are not coherent!!!");
                     }
@@ -60,38 +62,26 @@ namespace game
                         break;
                     }
                 }
+                //The server replicates our inputs up to the last one it received without a hole
+                gameManager_.AcknowledgeInputs(inputFrame);
                 break;
             }
 
-            //discard delayed input packet
-            if (inputFrame < gameManager_.GetRollbackManager().GetLastReceivedFrame(playerNumber))
-            {
-                break;
-            }
-            for (Frame i = 0; i < playerInputPacket->inputs.size(); i++)
-            {
-                gameManager_.SetPlayerInput(playerNumber,
-                    playerInputPacket->inputs[i],
-                    inputFrame - i);
-
-                if (inputFrame - i == 0)
-                {
-                    break;
-                }
-            }
+            gameManager_.SetPlayerInputs(playerNumber, inputFrame,
+                playerInputPacket->inputs.data(), playerInputPacket->inputCount);
             break;
         }
         case PacketType::VALIDATE_STATE:
         {
             const auto* validateFramePacket = static_cast<const ValidateFramePacket*>(packet);
             const auto newValidateFrame = core::ConvertFromBinary<Frame>(validateFramePacket->newValidateFrame);
-            std::array<PhysicsState, maxPlayerNmb> physicsStates{};
-            for (size_t i = 0; i < validateFramePacket->physicsState.size(); i++)
+            StateHash stateHash;
+            stateHash.full = core::ConvertFromBinary<std::uint64_t>(validateFramePacket->stateHash);
+            for (std::size_t part = 0; part < validateFramePacket->partCount; part++)
             {
-                auto* statePtr = reinterpret_cast<std::uint8_t*>(physicsStates.data());
-                statePtr[i] = validateFramePacket->physicsState[i];
+                stateHash.parts[part] = core::ConvertFromBinary<std::uint64_t>(validateFramePacket->partHashes[part]);
             }
-            gameManager_.ConfirmValidateFrame(newValidateFrame, physicsStates);
+            gameManager_.ConfirmValidateFrame(newValidateFrame, stateHash, validateFramePacket->partCount);
             //logDebug("Client received validate frame " + std::to_string(newValidateFrame));
             break;
         }
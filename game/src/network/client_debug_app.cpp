@@ -16,6 +16,7 @@ namespace game
         for (auto& client : clients_)
         {
             client.SetWindowSize(sf::Vector2u(windowSize_.x / 2u, windowSize_.y));
+            client.LoadResources();
             client.Init();
         }
     }
@@ -63,7 +64,7 @@ namespace game
 
     void NetworkDebugApp::Draw(sf::RenderTarget& renderTarget)
     {
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        for (PlayerNumber playerNumber = 0; playerNumber < clients_.size(); playerNumber++)
         {
             clientsFramebuffers_[playerNumber].clear(sf::Color::Black);
             clients_[playerNumber].Draw(clientsFramebuffers_[playerNumber]);
@@ -45,6 +45,7 @@ namespace game
         for(auto& client : clients_)
         {
             client->SetWindowSize(sf::Vector2u(windowSize_.x / 2u, windowSize_.y));
+            client->LoadResources();
             client->Init();
         }
         server_.Init();
@@ -101,7 +102,7 @@ namespace game
 
     void SimulationDebugApp::Draw(sf::RenderTarget& renderTarget)
     {
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb; playerNumber++)
+        for (PlayerNumber playerNumber = 0; playerNumber < clients_.size(); playerNumber++)
         {
             clientsFramebuffers_[playerNumber].clear(sf::Color::Black);
             clients_[playerNumber]->Draw(clientsFramebuffers_[playerNumber]);
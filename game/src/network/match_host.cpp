@@ -0,0 +1,610 @@
+#include <network/match_host.h>
+#include <utils/conversion.h>
+#include <utils/log.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <utility>
+
+namespace game
+{
+    namespace
+    {
+        constexpr SocketPoller::Key udpKey = 0;
+        constexpr std::size_t matchQueueCapacity = 4096;
+        //Datagrams of new addresses above this number of connections without a join packet are dropped
+        constexpr std::size_t maxPendingConnections = 64;
+        constexpr auto pendingConnectionTimeout = std::chrono::seconds(2);
+        //A full match validating no frame for this long in seconds has a player that stopped sending inputs
+        constexpr float stalledMatchTimeout = 10.0f;
+
+        [[nodiscard]] bool IsJoinPacket(const sf::Packet& packet)
+        {
+            return packet.getDataSize() > 0 &&
+                static_cast<const std::uint8_t*>(packet.getData())[0] == static_cast<std::uint8_t>(PacketType::JOIN);
+        }
+
+        //Used for the messages that cannot be dropped, the other side is always draining the queue
+        void PushBlocking(MatchQueue& queue, MatchMessage&& message)
+        {
+            while (!queue.Push(std::move(message)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    MatchSession::MatchSession(MatchId matchId, PlayerNumber playerCount, unsigned short udpPort, MatchQueue& outbox) :
+        matchId_(matchId), udpPort_(udpPort), outbox_(outbox)
+    {
+        SetPlayerCount(playerCount);
+    }
+
+    void MatchSession::Init()
+    {
+        Server::Init();
+    }
+
+    void MatchSession::Update(sf::Time dt)
+    {
+        //The connections of the players are kept alive by the network thread, only the match progress is checked here
+        if (!isOpen_ || lastPlayerNumber_ < playerCount_)
+            return;
+        const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
+        if (lastValidateFrame != lastValidateFrame_)
+        {
+            lastValidateFrame_ = lastValidateFrame;
+            stalledTime_ = sf::Time::Zero;
+            return;
+        }
+        stalledTime_ += dt;
+        if (stalledTime_.asSeconds() > stalledMatchTimeout)
+        {
+            core::LogWarning(fmt::format("[Match {}] No frame validated for {}s, ending the match", matchId_, stalledMatchTimeout));
+            Disconnect();
+        }
+    }
+
+    void MatchSession::Destroy()
+    {
+    }
+
+    void MatchSession::SendReliablePacket(std::unique_ptr<Packet> packet)
+    {
+        Send(std::move(packet), MatchMessage::Type::SEND_RELIABLE);
+    }
+
+    void MatchSession::SendUnreliablePacket(std::unique_ptr<Packet> packet)
+    {
+        Send(std::move(packet), MatchMessage::Type::SEND_UNRELIABLE);
+    }
+
+    void MatchSession::ReceivePacket(sf::Packet& packet, bool reliable)
+    {
+        auto receivedPacket = GenerateReceivedPacket(packet);
+        if (receivedPacket == nullptr)
+            return;
+        if (receivedPacket->packetType != PacketType::JOIN)
+        {
+            Server::ReceivePacket(std::move(receivedPacket));
+            return;
+        }
+        const auto clientId = core::ConvertFromBinary<ClientId>(
+            static_cast<const JoinPacket*>(receivedPacket.get())->clientId);
+        const auto joined = std::find(clientMap_.begin(), clientMap_.begin() + lastPlayerNumber_, clientId) !=
+            clientMap_.begin() + lastPlayerNumber_;
+        if (!joined && lastPlayerNumber_ == playerCount_)
+        {
+            core::LogWarning(fmt::format("[Match {}] Client {} tried to join a full match", matchId_, clientId));
+            return;
+        }
+        Server::ReceivePacket(std::move(receivedPacket));
+
+        auto joinAckPacket = std::make_unique<JoinAckPacket>();
+        joinAckPacket->clientId = core::ConvertToBinary(clientId);
+        joinAckPacket->udpPort = core::ConvertToBinary(udpPort_);
+        if (reliable)
+        {
+            SendReliablePacket(std::move(joinAckPacket));
+        }
+        else
+        {
+            SendUnreliablePacket(std::move(joinAckPacket));
+        }
+    }
+
+    void MatchSession::Disconnect()
+    {
+        if (!isOpen_)
+            return;
+        SendReliablePacket(std::make_unique<WinGamePacket>());
+        isOpen_ = false;
+    }
+
+    void MatchSession::Send(std::unique_ptr<Packet> packet, MatchMessage::Type type)
+    {
+        MatchMessage message;
+        message.type = type;
+        message.matchId = matchId_;
+        message.sharedPacket = SharedPacket(*packet);
+        PushBlocking(outbox_, std::move(message));
+    }
+
+    MatchWorker::MatchWorker(unsigned short udpPort, std::size_t queueCapacity, std::string replayDirectory) :
+        inbox_(queueCapacity), outbox_(queueCapacity), udpPort_(udpPort), replayDirectory_(std::move(replayDirectory))
+    {
+    }
+
+    void MatchWorker::Start()
+    {
+        running_ = true;
+        thread_ = std::thread(&MatchWorker::Run, this);
+    }
+
+    void MatchWorker::Stop()
+    {
+        running_ = false;
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    void MatchWorker::Run()
+    {
+        using namespace std::chrono;
+        //The inbox is checked at this period, the matches are ticked at the fixed period
+        constexpr auto pollPeriod = milliseconds(1);
+        const auto period = duration_cast<steady_clock::duration>(duration<float>(GameManager::FixedPeriod));
+        const auto dt = sf::seconds(GameManager::FixedPeriod);
+
+        auto deadline = steady_clock::now() + period;
+        MatchMessage message;
+        while (running_)
+        {
+            while (inbox_.Pop(message))
+            {
+                ProcessMessage(message);
+            }
+            const auto now = steady_clock::now();
+            if (now >= deadline)
+            {
+                for (auto it = sessions_.begin(); it != sessions_.end();)
+                {
+                    it->second->Update(dt);
+                    it = it->second->IsOpen() ? std::next(it) : CloseSession(it);
+                }
+                deadline += period;
+                if (deadline < now)
+                {
+                    deadline = now + period;
+                }
+            }
+            std::this_thread::sleep_until(std::min<steady_clock::time_point>(now + pollPeriod, deadline));
+        }
+        for (auto& [matchId, session] : sessions_)
+        {
+            session->Destroy();
+        }
+        sessions_.clear();
+    }
+
+    void MatchWorker::ProcessMessage(MatchMessage& message)
+    {
+        if (message.type == MatchMessage::Type::CREATE_MATCH)
+        {
+            auto session = std::make_unique<MatchSession>(message.matchId, message.playerCount, udpPort_, outbox_);
+            if (!replayDirectory_.empty())
+            {
+                session->StartMatchReplay(fmt::format("{}/match_{}_{}.replay", replayDirectory_, message.matchId, createdMatchCount_));
+            }
+            createdMatchCount_++;
+            session->Init();
+            sessions_[message.matchId] = std::move(session);
+            return;
+        }
+        const auto it = sessions_.find(message.matchId);
+        if (it == sessions_.end())
+            return;
+        auto& session = *it->second;
+        switch (message.type)
+        {
+        case MatchMessage::Type::RELIABLE_PACKET:
+            session.ReceivePacket(message.packet, true);
+            break;
+        case MatchMessage::Type::UNRELIABLE_PACKET:
+            session.ReceivePacket(message.packet, false);
+            break;
+        case MatchMessage::Type::DISCONNECT:
+            session.Disconnect();
+            break;
+        default:
+            break;
+        }
+        if (!session.IsOpen())
+        {
+            CloseSession(it);
+        }
+    }
+
+    MatchWorker::SessionMap::iterator MatchWorker::CloseSession(SessionMap::iterator it)
+    {
+        MatchMessage closedMessage;
+        closedMessage.type = MatchMessage::Type::MATCH_CLOSED;
+        closedMessage.matchId = it->first;
+        it->second->Destroy();
+        const auto nextIt = sessions_.erase(it);
+        PushBlocking(outbox_, std::move(closedMessage));
+        return nextIt;
+    }
+
+    MatchHost::MatchHost(std::size_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            const auto hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+        workers_.resize(workerCount);
+    }
+
+    void MatchHost::Init()
+    {
+        auto status = sf::Socket::Error;
+        while (status != sf::Socket::Done)
+        {
+            status = udpSocket_.GetSocket().bind(udpPort_);
+            if (status != sf::Socket::Done)
+            {
+                core::LogWarning(fmt::format("[MatchHost] Udp port {} is not available, trying the next one", udpPort_));
+                udpPort_++;
+            }
+        }
+        //Port 0 lets the system choose a free port
+        udpPort_ = udpSocket_.GetSocket().getLocalPort();
+        udpSocket_.GetSocket().setBlocking(false);
+        core::LogDebug(fmt::format("[MatchHost] Udp Socket on port: {}", udpPort_));
+
+        poller_.Add(udpSocket_.GetSocket(), udpKey);
+
+        for (auto& worker : workers_)
+        {
+            worker = std::make_unique<MatchWorker>(udpPort_, matchQueueCapacity, replayDirectory_);
+            worker->Start();
+        }
+        core::LogDebug(fmt::format("[MatchHost] Running {} match workers", workers_.size()));
+    }
+
+    void MatchHost::Run()
+    {
+        running_ = true;
+        while (running_)
+        {
+            //The timeout also paces the resend timers of the channels
+            poller_.Wait(sf::milliseconds(1), readyKeys_);
+            if (!readyKeys_.empty())
+            {
+                ReceiveUdp();
+            }
+            for (auto& worker : workers_)
+            {
+                ProcessOutbox(*worker);
+            }
+            UpdateConnections();
+            FlushUdp();
+        }
+    }
+
+    void MatchHost::Destroy()
+    {
+        for (auto& worker : workers_)
+        {
+            worker->Stop();
+        }
+        for (std::size_t i = 0; i < connections_.size(); i++)
+        {
+            if (connections_[i].connected)
+            {
+                CloseConnection(i);
+            }
+        }
+        matches_.clear();
+        connectionRoutes_.clear();
+    }
+
+    void MatchHost::ReceiveUdp()
+    {
+        const auto now = ReliableChannel::Clock::now();
+        std::size_t receivedCount = 0;
+        while ((receivedCount = udpSocket_.Receive()) > 0)
+        {
+            for (std::size_t i = 0; i < receivedCount; i++)
+            {
+                const auto& datagram = udpSocket_.GetDatagram(i);
+                const auto routeIt = connectionRoutes_.find(GetEndpointKey(datagram.address, datagram.port));
+                if (ReliableChannel::IsChannelDatagram(datagram.data, datagram.size))
+                {
+                    const auto connectionIndex = routeIt != connectionRoutes_.end() ?
+                        routeIt->second : OpenConnection(datagram.address, datagram.port, now);
+                    if (connectionIndex == connections_.size())
+                        continue;
+                    connections_[connectionIndex].channel.ReceiveDatagram(datagram.data, datagram.size, now);
+                    ReceiveReliable(connectionIndex);
+                    continue;
+                }
+                //Only the players of a match can send unreliable packets
+                if (routeIt == connectionRoutes_.end())
+                    continue;
+                const auto matchId = connections_[routeIt->second].matchId;
+                if (matchId == INVALID_MATCH)
+                    continue;
+                MatchMessage message;
+                message.type = MatchMessage::Type::UNRELIABLE_PACKET;
+                message.matchId = matchId;
+                message.packet.append(datagram.data, datagram.size);
+                //A player only joins with the reliable join packet of its connection
+                if (IsJoinPacket(message.packet))
+                    continue;
+                if (!workers_[matches_[matchId].worker]->GetInbox().Push(std::move(message)))
+                {
+                    core::LogWarning(fmt::format("[MatchHost] Match {} inbox is full, dropping udp packet", matchId));
+                }
+            }
+        }
+    }
+
+    void MatchHost::ReceiveReliable(std::size_t connectionIndex)
+    {
+        while (connections_[connectionIndex].connected)
+        {
+            auto& connection = connections_[connectionIndex];
+            MatchMessage message;
+            if (!connection.channel.PopPacket(message.packet))
+                return;
+
+            if (connection.matchId == INVALID_MATCH)
+            {
+                //The first packet of a connection has to be a join packet telling the match
+                JoinPacket joinPacket;
+                const auto isJoinPacket = ReadJoinPacket(message.packet, joinPacket);
+                const auto matchId = isJoinPacket ? core::ConvertFromBinary<MatchId>(joinPacket.matchId) : INVALID_MATCH;
+                const auto clientId = core::ConvertFromBinary<ClientId>(joinPacket.clientId);
+                auto* route = matchId == INVALID_MATCH ? nullptr : JoinMatch(matchId, clientId);
+                if (route == nullptr)
+                {
+                    core::LogWarning(fmt::format("[MatchHost] Refused connection to match {}", matchId));
+                    CloseConnection(connectionIndex);
+                    return;
+                }
+                connection.matchId = matchId;
+                pendingConnectionCount_--;
+                route->connections.push_back(connectionIndex);
+                route->clientIds.push_back(clientId);
+            }
+            else if (IsJoinPacket(message.packet))
+            {
+                //A connection joins once, another join would give it a second player
+                continue;
+            }
+            message.type = MatchMessage::Type::RELIABLE_PACKET;
+            message.matchId = connection.matchId;
+            PushToWorker(matches_[connection.matchId].worker, std::move(message));
+        }
+    }
+
+    void MatchHost::UpdateConnections()
+    {
+        const auto now = ReliableChannel::Clock::now();
+        for (std::size_t i = 0; i < connections_.size(); i++)
+        {
+            auto& connection = connections_[i];
+            if (!connection.connected)
+                continue;
+            if (connection.matchId == INVALID_MATCH)
+            {
+                //Not answered, so that a forged address does not get any datagram
+                if (now - connection.openTime > pendingConnectionTimeout)
+                {
+                    CloseConnection(i);
+                }
+                continue;
+            }
+            if (connection.channel.IsTimedOut(now) || connection.channel.IsOverflowed())
+            {
+                //An overflowed channel stopped being fed, the player left like on a timeout
+                if (connection.channel.IsOverflowed())
+                {
+                    core::LogWarning(fmt::format("[MatchHost] Reliable queue of a player of match {} is full", connection.matchId));
+                }
+                DisconnectConnection(i);
+                continue;
+            }
+            SendChannelDatagrams(connection, now);
+        }
+    }
+
+    void MatchHost::SendChannelDatagrams(Connection& connection, ReliableChannel::Clock::time_point now)
+    {
+        const auto datagramCount = connection.channel.Update(now);
+        for (std::size_t i = 0; i < datagramCount; i++)
+        {
+            const auto& datagram = connection.channel.GetDatagram(i);
+            udpSocket_.Send(datagram.data(), datagram.size(), connection.address, connection.port);
+        }
+    }
+
+    void MatchHost::ProcessOutbox(MatchWorker& worker)
+    {
+        MatchMessage message;
+        while (worker.GetOutbox().Pop(message))
+        {
+            const auto matchIt = matches_.find(message.matchId);
+            if (matchIt == matches_.end())
+                continue;
+            auto& route = matchIt->second;
+            switch (message.type)
+            {
+            case MatchMessage::Type::SEND_RELIABLE:
+                for (const auto connectionIndex : route.connections)
+                {
+                    connections_[connectionIndex].channel.Send(message.sharedPacket);
+                }
+                break;
+            case MatchMessage::Type::SEND_UNRELIABLE:
+                for (const auto connectionIndex : route.connections)
+                {
+                    const auto& connection = connections_[connectionIndex];
+                    udpSocket_.Send(message.sharedPacket.GetData(), message.sharedPacket.GetSize(),
+                        connection.address, connection.port);
+                }
+                break;
+            case MatchMessage::Type::MATCH_CLOSED:
+                CloseMatch(message.matchId);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void MatchHost::FlushUdp()
+    {
+        const auto pendingCount = udpSocket_.GetPendingCount();
+        const auto sentCount = udpSocket_.Flush();
+        if (sentCount < pendingCount)
+        {
+            core::LogWarning(fmt::format("[MatchHost] Error while sending UDP packets, {} dropped", pendingCount - sentCount));
+        }
+    }
+
+    std::size_t MatchHost::OpenConnection(const sf::IpAddress& address, unsigned short port,
+        ReliableChannel::Clock::time_point now)
+    {
+        if (pendingConnectionCount_ == maxPendingConnections)
+            return connections_.size();
+        if (freeConnections_.empty())
+        {
+            freeConnections_.push_back(connections_.size());
+            connections_.emplace_back();
+        }
+        const auto index = freeConnections_.back();
+        freeConnections_.pop_back();
+        auto& connection = connections_[index];
+        connection.address = address;
+        connection.port = port;
+        connection.openTime = now;
+        connection.matchId = INVALID_MATCH;
+        connection.connected = true;
+        connectionRoutes_.emplace(GetEndpointKey(address, port), index);
+        pendingConnectionCount_++;
+        return index;
+    }
+
+    void MatchHost::DisconnectConnection(std::size_t connectionIndex)
+    {
+        const auto& connection = connections_[connectionIndex];
+        const auto matchIt = matches_.find(connection.matchId);
+        if (matchIt != matches_.end())
+        {
+            auto& route = matchIt->second;
+            const auto routeIt = std::find(route.connections.begin(), route.connections.end(), connectionIndex);
+            if (routeIt != route.connections.end())
+            {
+                route.clientIds.erase(route.clientIds.begin() + std::distance(route.connections.begin(), routeIt));
+                route.connections.erase(routeIt);
+            }
+            route.closing = true;
+            MatchMessage message;
+            message.type = MatchMessage::Type::DISCONNECT;
+            message.matchId = connection.matchId;
+            PushToWorker(route.worker, std::move(message));
+        }
+        if (connections_[connectionIndex].connected)
+        {
+            CloseConnection(connectionIndex);
+        }
+    }
+
+    void MatchHost::CloseConnection(std::size_t connectionIndex)
+    {
+        auto& connection = connections_[connectionIndex];
+        if (connection.matchId == INVALID_MATCH)
+        {
+            pendingConnectionCount_--;
+        }
+        connectionRoutes_.erase(GetEndpointKey(connection.address, connection.port));
+        //A reused connection starts its sequences again
+        connection.channel = ReliableChannel();
+        connection.connected = false;
+        connection.matchId = INVALID_MATCH;
+        freeConnections_.push_back(connectionIndex);
+    }
+
+    void MatchHost::CloseMatch(MatchId matchId)
+    {
+        const auto matchIt = matches_.find(matchId);
+        if (matchIt == matches_.end())
+            return;
+        const auto now = ReliableChannel::Clock::now();
+        for (const auto connectionIndex : matchIt->second.connections)
+        {
+            //The last packets of the match, like the end of the game, are sent once before closing
+            SendChannelDatagrams(connections_[connectionIndex], now);
+            CloseConnection(connectionIndex);
+        }
+        matches_.erase(matchIt);
+        core::LogDebug(fmt::format("[MatchHost] Match {} closed, {} matches running", matchId, matches_.size()));
+    }
+
+    MatchHost::MatchRoute* MatchHost::JoinMatch(MatchId matchId, ClientId clientId)
+    {
+        auto matchIt = matches_.find(matchId);
+        if (matchIt == matches_.end())
+        {
+            MatchRoute route;
+            route.worker = matchId % workers_.size();
+            route.playerCount = playerCount_;
+            matchIt = matches_.emplace(matchId, std::move(route)).first;
+
+            MatchMessage message;
+            message.type = MatchMessage::Type::CREATE_MATCH;
+            message.matchId = matchId;
+            message.playerCount = playerCount_;
+            PushToWorker(matchIt->second.worker, std::move(message));
+            core::LogDebug(fmt::format("[MatchHost] Match {} created, {} matches running", matchId, matches_.size()));
+        }
+        auto& route = matchIt->second;
+        if (route.closing || route.connections.size() >= route.playerCount)
+            return nullptr;
+        //Another address claiming a client of the match
+        if (std::find(route.clientIds.begin(), route.clientIds.end(), clientId) != route.clientIds.end())
+            return nullptr;
+        return &route;
+    }
+
+    void MatchHost::PushToWorker(std::size_t worker, MatchMessage&& message)
+    {
+        auto& inbox = workers_[worker]->GetInbox();
+        while (!inbox.Push(std::move(message)))
+        {
+            //The worker may itself be waiting on a full outbox
+            std::this_thread::yield();
+            ProcessOutbox(*workers_[worker]);
+        }
+    }
+
+    MatchId MatchHost::ReadJoinMatchId(const sf::Packet& packet)
+    {
+        JoinPacket joinPacket;
+        if (!ReadJoinPacket(packet, joinPacket))
+            return INVALID_MATCH;
+        return core::ConvertFromBinary<MatchId>(joinPacket.matchId);
+    }
+
+    std::uint64_t MatchHost::GetEndpointKey(const sf::IpAddress& address, unsigned short port)
+    {
+        return (static_cast<std::uint64_t>(address.toInteger()) << 16u) | port;
+    }
+}
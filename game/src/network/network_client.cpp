@@ -1,3 +1,6 @@
+#include <algorithm>
+
+#include <fmt/format.h>
 #include <imgui.h>
 #include <network/network_client.h>
 
@@ -15,88 +18,61 @@ namespace game
                                       std::numeric_limits<ClientId>::max());
         //JOIN packet
         gameManager_.Init();
-        tcpSocket_.setBlocking(false);
-        udpSocket_.setBlocking(true);
+        auto& udpSocket = udpSocket_.GetSocket();
+        udpSocket.setBlocking(true);
         auto status = sf::Socket::Error;
         while (status != sf::Socket::Done)
         {
-            status = udpSocket_.bind(sf::Socket::AnyPort);
+            status = udpSocket.bind(sf::Socket::AnyPort);
         }
-        udpSocket_.setBlocking(false);
+        udpSocket.setBlocking(false);
     }
 
     void ClientNetworkManager::Update(sf::Time dt)
     {
 
+        const auto now = ReliableChannel::Clock::now();
         if (currentState_ != State::NONE)
         {
-            auto status = sf::Socket::Done;
-            //Receive TCP Packet
-            while (status == sf::Socket::Done)
+            std::size_t receivedCount = 0;
+            while ((receivedCount = udpSocket_.Receive()) > 0)
             {
-                sf::Packet packet;
-                status = tcpSocket_.receive(packet);
-                switch (status)
+                for (std::size_t i = 0; i < receivedCount; i++)
                 {
-                case sf::Socket::Done:
-                    ReceivePacket(packet, PacketSource::TCP);
-                    break;
-                case sf::Socket::NotReady:
-                    //core::LogDebug("[Client] Error while receiving tcp socket is not ready");
-                    break;
-                case sf::Socket::Partial:
-                    core::LogDebug("[Client] Error while receiving TCP packet, PARTIAL");
-                    break;
-                case sf::Socket::Disconnected: break;
-                case sf::Socket::Error: break;
-                default:;
+                    const auto& datagram = udpSocket_.GetDatagram(i);
+                    if (ReliableChannel::IsChannelDatagram(datagram.data, datagram.size))
+                    {
+                        reliableChannel_.ReceiveDatagram(datagram.data, datagram.size, now);
+                        continue;
+                    }
+                    receivedPacket_.clear();
+                    receivedPacket_.append(datagram.data, datagram.size);
+                    ReceivePacket(receivedPacket_, PacketSource::UNRELIABLE);
                 }
             }
-            //Receive UDP packet
-            status = sf::Socket::Done;
-            while (status == sf::Socket::Done)
+            while (reliableChannel_.PopPacket(receivedPacket_))
             {
-                sf::Packet packet;
-                sf::IpAddress sender;
-                unsigned short port;
-                status = udpSocket_.receive(packet, sender, port);
-                switch (status)
-                {
-                case sf::Socket::Done:
-                    ReceivePacket(packet, PacketSource::UDP);
-                    break;
-                case sf::Socket::NotReady: break;
-                case sf::Socket::Partial:
-                    core::LogDebug("[Client] Error while receiving UDP packet, PARTIAL");
-                    break;
-                case sf::Socket::Disconnected:
-                    core::LogDebug("[Client] Error while receiving UDP packet, DISCONNECTED");
-                    break;
-                case sf::Socket::Error:
-                    core::LogDebug("[Client] Error while receiving UDP packet, ERROR");
-                    break;
-                default:;
-                }
-            }
-            switch (currentState_)
-            {
-            case State::JOINING:
-            {
-                if (serverUdpPort_ != 0)
-                {
-                    //Need to send a join packet on the unreliable channel
-                    auto joinPacket = std::make_unique<JoinPacket>();
-                    joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-                    SendUnreliablePacket(std::move(joinPacket));
-                }
-                break;
-            }
-            default:
-                break;
+                ReceivePacket(receivedPacket_, PacketSource::RELIABLE);
             }
         }
 
         gameManager_.Update(dt);
+        if (currentState_ != State::NONE)
+        {
+            //Resends and acks leave with the inputs of the frame
+            const auto datagramCount = reliableChannel_.Update(now);
+            for (std::size_t i = 0; i < datagramCount; i++)
+            {
+                const auto& datagram = reliableChannel_.GetDatagram(i);
+                udpSocket_.Send(datagram.data(), datagram.size(), serverIpAddress_, serverPort_);
+            }
+        }
+        const auto pendingCount = udpSocket_.GetPendingCount();
+        const auto sentCount = udpSocket_.Flush();
+        if (sentCount < pendingCount)
+        {
+            core::LogDebug(fmt::format("[Client] Error sending UDP to server, {} dropped", pendingCount - sentCount));
+        }
     }
 
     void ClientNetworkManager::Destroy()
@@ -115,35 +91,21 @@ namespace game
         {
             serverAddress_ = hostBuffer;
         }
-        int portBuffer = serverTcpPort_;
+        int portBuffer = serverPort_;
         if (ImGui::InputInt("Port", &portBuffer))
         {
-            serverTcpPort_ = static_cast<unsigned short>(portBuffer);
+            serverPort_ = static_cast<unsigned short>(portBuffer);
+        }
+        int matchBuffer = static_cast<int>(matchId_);
+        if (currentState_ == State::NONE && ImGui::InputInt("Match", &matchBuffer))
+        {
+            matchId_ = static_cast<MatchId>(std::max(matchBuffer, 0));
         }
         if (currentState_ == State::NONE &&
             ImGui::Button("Join"))
         {
-            tcpSocket_.setBlocking(true);
-            const auto status = tcpSocket_.connect(serverAddress_, serverTcpPort_);
-            tcpSocket_.setBlocking(false);
-            if (status == sf::Socket::Done)
-            {
-                core::LogDebug("[Client] Connect to server " + serverAddress_ + " with port: " + std::to_string(serverTcpPort_));
-                auto joinPacket = std::make_unique<JoinPacket>();
-                joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-                using namespace std::chrono;
-                const unsigned long clientTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count();
-                joinPacket->startTime = core::ConvertToBinary<unsigned long>(clientTime);
-                SendReliablePacket(std::move(joinPacket));
-                currentState_ = State::JOINING;
-            }
-            else
-            {
-                core::LogDebug("[Client] Error trying to connect to " + serverAddress_ + " with port: " +
-                    std::to_string(serverTcpPort_) + " with status: " + std::to_string(status));
-            }
+            Join(sf::IpAddress(serverAddress_), serverPort_, matchId_);
         }
-        ImGui::Text("Server UDP port: %u", serverUdpPort_);
         gameManager_.DrawImGui();
         ImGui::End();
     }
@@ -155,44 +117,17 @@ namespace game
 
     void ClientNetworkManager::SendReliablePacket(std::unique_ptr<Packet> packet)
     {
-
-        //core::LogDebug("[Client] Sending reliable packet to server");
-        sf::Packet tcpPacket;
-        GeneratePacket(tcpPacket, *packet);
-        auto status = sf::Socket::Partial;
-        while (status == sf::Socket::Partial)
-        {
-            status = tcpSocket_.send(tcpPacket);
-        }
+        //Queued in the channel, sent at the end of the update
+        reliableChannel_.Send(SharedPacket(*packet));
     }
 
     void ClientNetworkManager::SendUnreliablePacket(std::unique_ptr<Packet> packet)
     {
 
-        sf::Packet udpPacket;
-        GeneratePacket(udpPacket, *packet);
-        const auto status = udpSocket_.send(udpPacket, serverAddress_, serverUdpPort_);
-        switch (status)
-        {
-        case sf::Socket::Done:
-            //core::LogDebug("[Client] Sending UDP packet to server at host: " +
-            //	serverAddress_.toString() + " port: " + std::to_string(serverUdpPort_));
-            break;
-        case sf::Socket::NotReady:
-            core::LogDebug("[Client] Error sending UDP to server, NOT READY");
-            break;
-        case sf::Socket::Partial:
-            core::LogDebug("[Client] Error sending UDP to server, PARTIAL");
-            break;
-        case sf::Socket::Disconnected:
-            core::LogDebug("[Client] Error sending UDP to server, DISCONNECTED");
-            break;
-        case sf::Socket::Error:
-            core::LogDebug("[Client] Error sending UDP to server, ERROR");
-            break;
-        default:
-            break;
-        }
+        sendingPacket_.clear();
+        GeneratePacket(sendingPacket_, *packet);
+        //Sent with the other datagrams of the frame at the end of the update
+        udpSocket_.Send(sendingPacket_.getData(), sendingPacket_.getDataSize(), serverIpAddress_, serverPort_);
     }
 
     void ClientNetworkManager::SetPlayerInput(PlayerInput input)
@@ -204,6 +139,23 @@ namespace game
             currentFrame);
     }
 
+    void ClientNetworkManager::Join(const sf::IpAddress& serverAddress, unsigned short serverPort, MatchId matchId)
+    {
+        //No connection to wait for, the join packet is resent by the reliable channel until the server acks it
+        core::LogDebug(fmt::format("[Client] Joining server {} with port: {}", serverAddress.toString(), serverPort));
+        serverIpAddress_ = serverAddress;
+        serverPort_ = serverPort;
+        matchId_ = matchId;
+        auto joinPacket = std::make_unique<JoinPacket>();
+        joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
+        joinPacket->matchId = core::ConvertToBinary<MatchId>(matchId_);
+        using namespace std::chrono;
+        const unsigned long clientTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch())).count();
+        joinPacket->startTime = core::ConvertToBinary<unsigned long>(clientTime);
+        SendReliablePacket(std::move(joinPacket));
+        currentState_ = State::JOINING;
+    }
+
     void ClientNetworkManager::ReceivePacket(sf::Packet& packet, PacketSource source)
     {
         const auto receivePacket = GenerateReceivedPacket(packet);
@@ -212,26 +164,14 @@ namespace game
         {
         case PacketType::JOIN_ACK:
         {
-            core::LogDebug("[Client] Receive " + std::string(source == PacketSource::UDP ? "UDP" : "TCP") + " Join ACK Packet");
-            auto* joinAckPacket = static_cast<JoinAckPacket*>(receivePacket.get());
-
-            serverUdpPort_ = core::ConvertFromBinary<unsigned short>(joinAckPacket->udpPort);
+            core::LogDebug("[Client] Receive " + std::string(source == PacketSource::UNRELIABLE ? "unreliable" : "reliable") + " Join ACK Packet");
+            const auto* joinAckPacket = static_cast<const JoinAckPacket*>(receivePacket.get());
             const auto clientId = core::ConvertFromBinary<ClientId>(joinAckPacket->clientId);
             if (clientId != clientId_)
                 return;
-            if (source == PacketSource::TCP)
-            {
-                //Need to send a join packet on the unreliable channel
-                auto joinPacket = std::make_unique<JoinPacket>();
-                joinPacket->clientId = core::ConvertToBinary<ClientId>(clientId_);
-                SendUnreliablePacket(std::move(joinPacket));
-            }
-            else
+            if (currentState_ == State::JOINING)
             {
-                if (currentState_ == State::JOINING)
-                {
-                    currentState_ = State::JOINED;
-                }
+                currentState_ = State::JOINED;
             }
             break;
         }
@@ -2,6 +2,7 @@
 #include <utils/log.h>
 #include <fmt/format.h>
 #include <utils/conversion.h>
+#include <algorithm>
 #include <cassert>
 
 namespace game
@@ -9,29 +10,15 @@ namespace game
     void ServerNetworkManager::SendReliablePacket(
         std::unique_ptr<Packet> packet)
     {
-        core::LogDebug(fmt::format("[Server] Sending TCP packet: {}",
+        core::LogDebug(fmt::format("[Server] Sending reliable packet: {}",
             std::to_string(static_cast<int>(packet->packetType))));
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
-            playerNumber++)
+        //Serialized once for all the players, the channels only queue it
+        const SharedPacket sharedPacket(*packet);
+        for (std::uint32_t connectionIndex = 0; connectionIndex < lastConnectionIndex_; connectionIndex++)
         {
-            sf::Packet sendingPacket;
-            GeneratePacket(sendingPacket, *packet);
-
-            auto status = sf::Socket::Partial;
-            while (status == sf::Socket::Partial)
+            if (connections_[connectionIndex].connected)
             {
-                status = tcpSockets_[playerNumber].send(sendingPacket);
-                switch (status)
-                {
-                case sf::Socket::NotReady:
-                    core::LogDebug(fmt::format(
-                        "[Server] Error trying to send packet to Player: {} socket is not ready",
-                        playerNumber));
-                    break;
-                case sf::Socket::Disconnected:
-
-                    break;
-                }
+                connections_[connectionIndex].channel.Send(sharedPacket);
             }
         }
     }
@@ -39,7 +26,8 @@ namespace game
     void ServerNetworkManager::SendUnreliablePacket(
         std::unique_ptr<Packet> packet)
     {
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
+        const SharedPacket sharedPacket(*packet);
+        for (PlayerNumber playerNumber = 0; playerNumber < playerCount_;
             playerNumber++)
         {
             if (clientInfoMap_[playerNumber].udpRemotePort == 0)
@@ -47,35 +35,18 @@ namespace game
                 core::LogDebug(fmt::format("[Warning] Trying to send UDP packet, but missing port!"));
                 continue;
             }
-
-            sf::Packet sendingPacket;
-            GeneratePacket(sendingPacket, *packet);
-            const auto status = udpSocket_.send(sendingPacket, clientInfoMap_[playerNumber].udpRemoteAddress,
-                clientInfoMap_[playerNumber].udpRemotePort);
-            switch (status)
+            const auto connectionIndex = clientInfoMap_[playerNumber].connectionIndex;
+            if (connectionIndex < lastConnectionIndex_ &&
+                connections_[connectionIndex].channel.GetQueuedBytes() > highWaterMark_)
             {
-            case sf::Socket::Done:
-                //core::LogDebug("[Server] Sending UDP packet: " +
-                    //std::to_string(static_cast<int>(packet->packetType)));
-                break;
-
-            case sf::Socket::Disconnected:
-            {
-                core::LogDebug("[Server] Error while sending UDP packet, DISCONNECTED");
-                break;
-            }
-            case sf::Socket::NotReady:
-                core::LogDebug("[Server] Error while sending UDP packet, NOT READY");
-
-                break;
-
-            case sf::Socket::Error:
-                core::LogDebug("[Server] Error while sending UDP packet, DISCONNECTED");
-                break;
-            default:
-                break;
+                //The next unreliable packets supersede this one, the reliable ones of the congested client go first
+                sendQueueStats_.shedPackets++;
+                continue;
             }
 
+            //Sent with the other datagrams of the batch when the socket is drained
+            udpSocket_.Send(sharedPacket.GetData(), sharedPacket.GetSize(),
+                clientInfoMap_[playerNumber].udpRemoteAddress, clientInfoMap_[playerNumber].udpRemotePort);
         }
 
     }
@@ -85,123 +56,242 @@ namespace game
         sf::Socket::Status status = sf::Socket::Error;
         while (status != sf::Socket::Done)
         {
-            // bind the listener to a port
-            status = tcpListener_.listen(tcpPort_);
-            if (status != sf::Socket::Done)
-            {
-                tcpPort_++;
-            }
-        }
-        tcpListener_.setBlocking(false);
-        for (auto& socket : tcpSockets_)
-        {
-            socket.setBlocking(false);
-        }
-        core::LogDebug(fmt::format("[Server] Tcp Socket on port: {}", tcpPort_));
-
-        status = sf::Socket::Error;
-        while (status != sf::Socket::Done)
-        {
-            status = udpSocket_.bind(udpPort_);
+            status = udpSocket_.GetSocket().bind(udpPort_);
             if (status != sf::Socket::Done)
             {
+                core::LogWarning(fmt::format("[Server] Udp port {} is not available, trying the next one", udpPort_));
                 udpPort_++;
             }
         }
-        udpSocket_.setBlocking(false);
+        //Port 0 lets the system choose a free port
+        udpPort_ = udpSocket_.GetSocket().getLocalPort();
+        udpSocket_.GetSocket().setBlocking(false);
         core::LogDebug(fmt::format("[Server] Udp Socket on port: {}", udpPort_));
 
+        socketPoller_.Add(udpSocket_.GetSocket(), 0);
+        readySockets_.reserve(1);
+
         status_ = status_ | OPEN;
         Server::Init();
     }
 
-    void ServerNetworkManager::Update(sf::Time dt)
+    void ServerNetworkManager::Update([[maybe_unused]] sf::Time dt)
+    {
+        ReceivePackets();
+    }
+
+    void ServerNetworkManager::ReceivePackets()
     {
-        if (lastSocketIndex_ < maxPlayerNmb)
+        const auto now = ReliableChannel::Clock::now();
+        //Drain the udp socket, the scheduler only wakes up when something is waiting
+        std::size_t receivedCount = 0;
+        while ((receivedCount = udpSocket_.Receive()) > 0)
         {
-            const sf::Socket::Status status = tcpListener_.accept(
-                tcpSockets_[lastSocketIndex_]);
-            if (status == sf::Socket::Done)
+            for (std::size_t i = 0; i < receivedCount; i++)
             {
-                const auto remoteAddress = tcpSockets_[lastSocketIndex_].
-                    getRemoteAddress();
-                core::LogDebug(fmt::format("[Server] New player connection with address: {} and port: {}",
-                    remoteAddress.toString(), tcpSockets_[lastSocketIndex_].getRemotePort()));
-                status_ = status_ | (FIRST_PLAYER_CONNECT << lastSocketIndex_);
-                lastSocketIndex_++;
+                const auto& datagram = udpSocket_.GetDatagram(i);
+                if (ReliableChannel::IsChannelDatagram(datagram.data, datagram.size))
+                {
+                    ReceiveReliableDatagram(datagram, now);
+                    continue;
+                }
+                receivedPacket_.clear();
+                receivedPacket_.append(datagram.data, datagram.size);
+                ReceivePacket(receivedPacket_, PacketSocketSource::UNRELIABLE, datagram.address, datagram.port);
             }
         }
 
-        for (PlayerNumber playerNumber = 0; playerNumber < maxPlayerNmb;
-            playerNumber++)
+        ExpirePendingConnections(now);
+        for (std::uint32_t connectionIndex = 0; connectionIndex < lastConnectionIndex_; connectionIndex++)
         {
-            sf::Packet tcpPacket;
-            const auto status = tcpSockets_[playerNumber].receive(
-                tcpPacket);
-            switch (status)
+            auto& connection = connections_[connectionIndex];
+            if (!connection.connected)
+                continue;
+            if (connection.channel.IsTimedOut(now))
             {
-            case sf::Socket::Done:
-                ReceivePacket(tcpPacket, PacketSocketSource::TCP);
-                break;
-            case sf::Socket::Disconnected:
+                core::LogDebug(fmt::format("[Error] Player connection {} timed out", connectionIndex + 1));
+                Disconnect(connectionIndex);
+                continue;
+            }
+            if (connection.channel.IsOverflowed())
             {
-                core::LogDebug(fmt::format(
-                    "[Error] Player Number {} is disconnected when receiving",
-                    playerNumber + 1));
-                status_ = status_ & ~(FIRST_PLAYER_CONNECT << playerNumber);
-                auto endGame = std::make_unique<WinGamePacket>();
-                SendReliablePacket(std::move(endGame));
-                status_ = status_ & ~OPEN; //Close the server
-                break;
+                //The client stopped acknowledging, its queue is not fed anymore and the stream has a hole
+                core::LogDebug(fmt::format("[Error] Player connection {} reliable queue is full", connectionIndex + 1));
+                sendQueueStats_.overflowDisconnects++;
+                Disconnect(connectionIndex);
+                continue;
             }
-            default: break;
+            while (connection.channel.PopPacket(receivedPacket_))
+            {
+                ReceivePacket(receivedPacket_, PacketSocketSource::RELIABLE, connection.address, connection.port);
             }
         }
-        sf::Packet udpPacket;
-        sf::IpAddress address;
-        unsigned short port;
-        const auto status = udpSocket_.receive(udpPacket, address, port);
-        if (status == sf::Socket::Done)
+        //The channels are updated once all the packets were processed, to carry the answers in the same datagrams
+        FlushConnections(now);
+    }
+
+    void ServerNetworkManager::FlushConnections(ReliableChannel::Clock::time_point now)
+    {
+        const auto flushStart = ReliableChannel::Clock::now();
+        std::size_t queuedBytes = 0;
+        for (std::uint32_t connectionIndex = 0; connectionIndex < lastConnectionIndex_; connectionIndex++)
         {
-            ReceivePacket(udpPacket, PacketSocketSource::UDP, address, port);
+            auto& connection = connections_[connectionIndex];
+            if (!connection.connected)
+                continue;
+            const auto datagramCount = connection.channel.Update(now);
+            for (std::size_t i = 0; i < datagramCount; i++)
+            {
+                const auto& datagram = connection.channel.GetDatagram(i);
+                udpSocket_.Send(datagram.data(), datagram.size(), connection.address, connection.port);
+            }
+            queuedBytes += connection.channel.GetQueuedBytes();
+            if (connection.channel.IsWindowFull())
+            {
+                sendQueueStats_.stallsAvoided++;
+            }
+        }
+        //The answers of the whole drain leave in as few system calls as possible
+        const auto pendingCount = udpSocket_.GetPendingCount();
+        const auto sentCount = udpSocket_.Flush();
+        if (sentCount < pendingCount)
+        {
+            core::LogDebug(fmt::format("[Server] Error while sending UDP packets, {} dropped", pendingCount - sentCount));
         }
+
+        using namespace std::chrono;
+        const auto flushTime = duration_cast<microseconds>(ReliableChannel::Clock::now() - flushStart);
+        sendQueueStats_.queuedBytes = queuedBytes;
+        sendQueueStats_.maxQueuedBytes = std::max(sendQueueStats_.maxQueuedBytes, queuedBytes);
+        sendQueueStats_.flushCount++;
+        sendQueueStats_.droppedDatagrams = udpSocket_.GetDroppedCount();
+        sendQueueStats_.totalFlushTime += flushTime;
+        sendQueueStats_.maxFlushTime = std::max(sendQueueStats_.maxFlushTime, flushTime);
     }
 
-    void ServerNetworkManager::Destroy()
+    std::uint32_t ServerNetworkManager::FindConnection(const sf::IpAddress& address, unsigned short port) const
     {
-
+        const auto connectionIt = std::find_if(connections_.begin(), connections_.begin() + lastConnectionIndex_,
+            [&address, port](const Connection& connection)
+            {
+                return connection.connected && connection.port == port && connection.address == address;
+            });
+        return static_cast<std::uint32_t>(std::distance(connections_.begin(), connectionIt));
     }
 
-    void ServerNetworkManager::SetTcpPort(unsigned short i)
+    void ServerNetworkManager::ReceiveReliableDatagram(const BatchUdpSocket::Datagram& datagram,
+        ReliableChannel::Clock::time_point now)
     {
-        tcpPort_ = i;
+        const auto connectionIndex = FindConnection(datagram.address, datagram.port);
+        if (connectionIndex != lastConnectionIndex_)
+        {
+            connections_[connectionIndex].channel.ReceiveDatagram(datagram.data, datagram.size, now);
+            return;
+        }
+        if (lastConnectionIndex_ == playerCount_)
+            return;
+        ReceivePendingDatagram(datagram, now);
     }
 
-    bool ServerNetworkManager::IsOpen() const
+    void ServerNetworkManager::ReceivePendingDatagram(const BatchUdpSocket::Datagram& datagram,
+        ReliableChannel::Clock::time_point now)
     {
-        return status_ & OPEN;
+        const auto pendingIt = std::find_if(pendingConnections_.begin(), pendingConnections_.end(),
+            [&datagram](const Connection& connection)
+            {
+                return connection.connected && connection.port == datagram.port && connection.address == datagram.address;
+            });
+        auto freeIt = pendingIt;
+        if (freeIt == pendingConnections_.end())
+        {
+            freeIt = std::find_if(pendingConnections_.begin(), pendingConnections_.end(),
+                [](const Connection& connection) { return !connection.connected; });
+            if (freeIt == pendingConnections_.end())
+                return;
+            //A reused pending connection starts its sequences again
+            freeIt->channel = ReliableChannel();
+            freeIt->channel.SetMaxQueuedBytes(maxQueuedBytes_);
+            freeIt->address = datagram.address;
+            freeIt->port = datagram.port;
+            freeIt->openTime = now;
+            freeIt->connected = true;
+        }
+        auto& pendingConnection = *freeIt;
+        pendingConnection.channel.ReceiveDatagram(datagram.data, datagram.size, now);
+        if (!pendingConnection.channel.PopPacket(receivedPacket_))
+            return;
+
+        pendingConnection.connected = false;
+        JoinPacket joinPacket;
+        if (!ReadJoinPacket(receivedPacket_, joinPacket))
+        {
+            core::LogWarning(fmt::format("[Server] Refused connection from port {} not starting with a join packet",
+                datagram.port));
+            return;
+        }
+        const auto clientId = core::ConvertFromBinary<ClientId>(joinPacket.clientId);
+        const auto joinedEnd = clientMap_.begin() + lastPlayerNumber_;
+        if (std::find(clientMap_.begin(), joinedEnd, clientId) != joinedEnd)
+        {
+            core::LogWarning(fmt::format("[Server] Refused connection of client {} already in the match", clientId));
+            return;
+        }
+        core::LogDebug(fmt::format("[Server] New player connection with address: {} and port: {}",
+            datagram.address.toString(), datagram.port));
+        auto& connection = connections_[lastConnectionIndex_];
+        connection.channel = std::move(pendingConnection.channel);
+        connection.address = datagram.address;
+        connection.port = datagram.port;
+        connection.openTime = pendingConnection.openTime;
+        connection.connected = true;
+        status_ = status_ | (FIRST_PLAYER_CONNECT << lastConnectionIndex_);
+        lastConnectionIndex_++;
+        ReceivePacket(receivedPacket_, PacketSocketSource::RELIABLE, datagram.address, datagram.port);
     }
 
-    void ServerNetworkManager::SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber)
+    void ServerNetworkManager::ExpirePendingConnections(ReliableChannel::Clock::time_point now)
     {
-        //Spawning the new player in the arena
-        for (PlayerNumber p = 0; p <= lastPlayerNumber_; p++)
+        for (auto& pendingConnection : pendingConnections_)
         {
-            auto spawnPlayer = std::make_unique<SpawnPlayerPacket>();
-            spawnPlayer->clientId = core::ConvertToBinary(clientMap_[p]);
-            spawnPlayer->playerNumber = p;
+            if (pendingConnection.connected && now - pendingConnection.openTime > pendingConnectionTimeout)
+            {
+                core::LogDebug(fmt::format("[Server] Pending connection from port {} did not join in time",
+                    pendingConnection.port));
+                pendingConnection.connected = false;
+            }
+        }
+    }
 
-            const auto pos = spawnPositions[p] * 3.0f;
-            spawnPlayer->pos = ConvertToBinary(pos);
+    void ServerNetworkManager::Disconnect(std::size_t connectionIndex)
+    {
+        connections_[connectionIndex].connected = false;
+        status_ = status_ & ~(FIRST_PLAYER_CONNECT << connectionIndex);
+        //Only sent once by the update following it, the server closes right after
+        auto endGame = std::make_unique<WinGamePacket>();
+        SendReliablePacket(std::move(endGame));
+        status_ = status_ & ~OPEN; //Close the server
+    }
 
-            const auto rotation = spawnRotations[p];
-            spawnPlayer->angle = core::ConvertToBinary(rotation);
-            gameManager_.SpawnPlayer(p, pos, rotation);
+    bool ServerNetworkManager::WaitForPackets(sf::Time timeout)
+    {
+        socketPoller_.Wait(timeout, readySockets_);
+        return !readySockets_.empty();
+    }
+
+    void ServerNetworkManager::Destroy()
+    {
 
-            SendReliablePacket(std::move(spawnPlayer));
-        }
     }
 
+    void ServerNetworkManager::SetPort(unsigned short port)
+    {
+        udpPort_ = port;
+    }
+
+    bool ServerNetworkManager::IsOpen() const
+    {
+        return status_ & OPEN;
+    }
 
     void ServerNetworkManager::ProcessReceivePacket(
         std::unique_ptr<Packet> packet,
@@ -215,11 +305,16 @@ namespace game
         {
         case PacketType::JOIN:
         {
+            //Only the join packet binding a new connection gives a player, the connection of each player is its player number
+            if (packetSource == PacketSocketSource::UNRELIABLE || FindConnection(address, port) != lastPlayerNumber_)
+            {
+                core::LogWarning(fmt::format("[Server] Ignored join packet from port {}", port));
+                break;
+            }
             const auto joinPacket = *static_cast<JoinPacket*>(packet.get());
             Server::ReceivePacket(std::move(packet));
             auto clientId = core::ConvertFromBinary<ClientId>(joinPacket.clientId);
-            core::LogDebug(fmt::format("[Server] Received Join Packet from: {} {}", clientId,
-                (packetSource == PacketSocketSource::UDP ? fmt::format(" UDP with port: {}", port) : " TCP")));
+            core::LogDebug(fmt::format("[Server] Received Join Packet from: {} with port: {}", clientId, port));
             const auto it = std::find(clientMap_.begin(), clientMap_.end(), clientId);
             PlayerNumber playerNumber;
             if (it != clientMap_.end())
@@ -235,23 +330,18 @@ namespace game
             auto joinAckPacket = std::make_unique<JoinAckPacket>();
             joinAckPacket->clientId = core::ConvertToBinary(clientId);
             joinAckPacket->udpPort = core::ConvertToBinary(udpPort_);
-            if (packetSource == PacketSocketSource::UDP)
-            {
-                auto& clientInfo = clientInfoMap_[playerNumber];
-                clientInfo.udpRemoteAddress = address;
-                clientInfo.udpRemotePort = port;
-                SendUnreliablePacket(std::move(joinAckPacket));
-            }
-            else
-            {
-                SendReliablePacket(std::move(joinAckPacket));
-                //Calculate time difference
-                const auto clientTime = core::ConvertFromBinary<unsigned long>(joinPacket.startTime);
-                using namespace std::chrono;
-                const unsigned long deltaTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()) - clientTime;
-                core::LogDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
-                clientInfoMap_[playerNumber].timeDifference = deltaTime;
-            }
+            //The reliable channel shares the udp socket of the client, the unreliable packets go to the same address
+            auto& clientInfo = clientInfoMap_[playerNumber];
+            clientInfo.udpRemoteAddress = address;
+            clientInfo.udpRemotePort = port;
+            clientInfo.connectionIndex = FindConnection(address, port);
+            SendReliablePacket(std::move(joinAckPacket));
+            //Calculate time difference
+            const auto clientTime = core::ConvertFromBinary<unsigned long>(joinPacket.startTime);
+            using namespace std::chrono;
+            const unsigned long deltaTime = (duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()) - clientTime;
+            core::LogDebug(fmt::format("[Server] Client Server deltaTime: {}", deltaTime));
+            clientInfoMap_[playerNumber].timeDifference = deltaTime;
             break;
         }
         default:
@@ -0,0 +1,88 @@
+#include <network/packet_type.h>
+
+#include <array>
+#include <new>
+
+namespace game
+{
+    namespace
+    {
+        constexpr std::size_t packetSlotSize = 64;
+        //Slots of 64, 128, 192 and 256 bytes, bigger packets use the heap
+        constexpr std::size_t packetSlotClassNmb = 4;
+
+        struct FreePacketSlot
+        {
+            FreePacketSlot* next = nullptr;
+        };
+
+        /**
+         * \brief Free lists of the released packet slots, one per slot size
+         */
+        class PacketSlotPool
+        {
+        public:
+            ~PacketSlotPool()
+            {
+                for (auto* freeSlot : freeSlots_)
+                {
+                    while (freeSlot != nullptr)
+                    {
+                        auto* next = freeSlot->next;
+                        ::operator delete(freeSlot);
+                        freeSlot = next;
+                    }
+                }
+            }
+
+            void* Allocate(std::size_t size)
+            {
+                const auto slotClass = SlotClass(size);
+                if (slotClass >= packetSlotClassNmb)
+                {
+                    return ::operator new(size);
+                }
+                auto*& freeSlot = freeSlots_[slotClass];
+                if (freeSlot == nullptr)
+                {
+                    return ::operator new((slotClass + 1) * packetSlotSize);
+                }
+                auto* slot = freeSlot;
+                freeSlot = slot->next;
+                return slot;
+            }
+
+            void Deallocate(void* ptr, std::size_t size)
+            {
+                const auto slotClass = SlotClass(size);
+                if (slotClass >= packetSlotClassNmb)
+                {
+                    ::operator delete(ptr);
+                    return;
+                }
+                auto* slot = new(ptr) FreePacketSlot{ freeSlots_[slotClass] };
+                freeSlots_[slotClass] = slot;
+            }
+        private:
+            static constexpr std::size_t SlotClass(std::size_t size)
+            {
+                return (size + packetSlotSize - 1) / packetSlotSize - 1;
+            }
+
+            std::array<FreePacketSlot*, packetSlotClassNmb> freeSlots_{};
+        };
+
+        //Packets are released by the thread that consumes them, which is the one that created them in steady state
+        thread_local PacketSlotPool packetSlotPool;
+    }
+
+    void* Packet::operator new(std::size_t size)
+    {
+        return packetSlotPool.Allocate(size);
+    }
+
+    void Packet::operator delete(void* ptr, std::size_t size) noexcept
+    {
+        packetSlotPool.Deallocate(ptr, size);
+    }
+}
@@ -0,0 +1,202 @@
+#include <network/reliable_channel.h>
+#include <network/batch_udp_socket.h>
+#include <utils/log.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        //Every field is written in network byte order
+        template<typename T>
+        void WriteBigEndian(std::vector<std::uint8_t>& datagram, T value)
+        {
+            for (std::size_t i = 0; i < sizeof(T); i++)
+            {
+                datagram.push_back(static_cast<std::uint8_t>(value >> (8u * (sizeof(T) - 1 - i))));
+            }
+        }
+
+        template<typename T>
+        T ReadBigEndian(const std::uint8_t* data)
+        {
+            T value = 0;
+            for (std::size_t i = 0; i < sizeof(T); i++)
+            {
+                value = static_cast<T>((value << 8u) | data[i]);
+            }
+            return value;
+        }
+    }
+
+    bool ReliableChannel::Send(const SharedPacket& packet)
+    {
+        if (headerSize + messageHeaderSize + packet.GetSize() > BatchUdpSocket::maxDatagramSize)
+        {
+            core::LogError(fmt::format("[ReliableChannel] Packet of {} bytes does not fit in a datagram", packet.GetSize()));
+            return false;
+        }
+        if (overflowed_ || queuedBytes_ + packet.GetSize() > maxQueuedBytes_)
+        {
+            overflowed_ = true;
+            return false;
+        }
+        OutgoingMessage message;
+        message.sequence = nextSendSequence_++;
+        message.packet = packet;
+        outgoing_.push_back(std::move(message));
+        queuedBytes_ += packet.GetSize();
+        return true;
+    }
+
+    void ReliableChannel::ReceiveDatagram(const std::uint8_t* data, std::size_t size, Clock::time_point now)
+    {
+        if (!IsChannelDatagram(data, size))
+            return;
+        lastReceiveTime_ = now;
+        ReceiveAck(ReadBigEndian<Sequence>(data + 1), ReadBigEndian<std::uint32_t>(data + 1 + sizeof(Sequence)));
+
+        std::size_t offset = headerSize;
+        while (offset + messageHeaderSize <= size)
+        {
+            const auto sequence = ReadBigEndian<Sequence>(data + offset);
+            const auto messageSize = ReadBigEndian<std::uint16_t>(data + offset + sizeof(Sequence));
+            offset += messageHeaderSize;
+            if (offset + messageSize > size)
+                break;
+            ReceiveMessage(sequence, data + offset, messageSize);
+            offset += messageSize;
+        }
+    }
+
+    bool ReliableChannel::PopPacket(sf::Packet& packet)
+    {
+        const auto index = nextReceiveSequence_ % windowSize;
+        if (!received_[index])
+            return false;
+        packet.clear();
+        packet.append(receiveWindow_[index].data(), receiveWindow_[index].size());
+        received_[index] = false;
+        nextReceiveSequence_++;
+        return true;
+    }
+
+    std::size_t ReliableChannel::Update(Clock::time_point now)
+    {
+        if (lastReceiveTime_ == Clock::time_point{})
+        {
+            //The timeout starts with the first update
+            lastReceiveTime_ = now;
+        }
+        datagramCount_ = 0;
+        std::vector<std::uint8_t>* datagram = nullptr;
+        const auto sendCount = std::min<std::size_t>(outgoing_.size(), windowSize);
+        for (std::size_t i = 0; i < sendCount; i++)
+        {
+            auto& message = outgoing_[i];
+            if (message.acked || (message.sent && now - message.lastSendTime < resendDelay_))
+                continue;
+            const auto size = message.packet.GetSize();
+            if (datagram == nullptr || datagram->size() + messageHeaderSize + size > BatchUdpSocket::maxDatagramSize)
+            {
+                datagram = &StartDatagram();
+            }
+            WriteBigEndian(*datagram, message.sequence);
+            WriteBigEndian(*datagram, static_cast<std::uint16_t>(size));
+            datagram->insert(datagram->end(), message.packet.GetData(), message.packet.GetData() + size);
+            if (message.sent)
+            {
+                resendCount_++;
+            }
+            message.sent = true;
+            message.lastSendTime = now;
+        }
+        if (datagramCount_ == 0 && (ackPending_ || now - lastSendTime_ >= keepAlivePeriod_))
+        {
+            StartDatagram();
+        }
+        if (datagramCount_ > 0)
+        {
+            lastSendTime_ = now;
+            ackPending_ = false;
+        }
+        return datagramCount_;
+    }
+
+    bool ReliableChannel::IsTimedOut(Clock::time_point now) const
+    {
+        return lastReceiveTime_ != Clock::time_point{} && now - lastReceiveTime_ > timeout_;
+    }
+
+    std::vector<std::uint8_t>& ReliableChannel::StartDatagram()
+    {
+        if (datagramCount_ == datagrams_.size())
+        {
+            datagrams_.emplace_back();
+        }
+        auto& datagram = datagrams_[datagramCount_++];
+        datagram.clear();
+
+        //The ack is the last message received in order, the bit i tells if the message ack + 2 + i was received
+        Sequence contiguousCount = 0;
+        while (contiguousCount < windowSize && received_[(nextReceiveSequence_ + contiguousCount) % windowSize])
+        {
+            contiguousCount++;
+        }
+        const Sequence ack = nextReceiveSequence_ + contiguousCount - 1;
+        std::uint32_t ackBits = 0;
+        for (Sequence i = 0; i < 32; i++)
+        {
+            const Sequence sequence = ack + 2 + i;
+            const Sequence distance = sequence - nextReceiveSequence_;
+            if (distance < windowSize && received_[sequence % windowSize])
+            {
+                ackBits |= 1u << i;
+            }
+        }
+        datagram.push_back(datagramTag);
+        WriteBigEndian(datagram, ack);
+        WriteBigEndian(datagram, ackBits);
+        return datagram;
+    }
+
+    void ReliableChannel::ReceiveAck(Sequence ack, std::uint32_t ackBits)
+    {
+        for (auto& message : outgoing_)
+        {
+            if (!message.sent || message.acked)
+                continue;
+            const Sequence ahead = message.sequence - ack;
+            //The sent messages are always close to the ack, a message behind it wraps to a negative distance
+            if (static_cast<std::int16_t>(ahead) <= 0)
+            {
+                message.acked = true;
+            }
+            else if (ahead >= 2 && ahead - 2 < 32 && (ackBits >> (ahead - 2)) & 1u)
+            {
+                message.acked = true;
+            }
+        }
+        while (!outgoing_.empty() && outgoing_.front().acked)
+        {
+            queuedBytes_ -= outgoing_.front().packet.GetSize();
+            outgoing_.pop_front();
+        }
+    }
+
+    void ReliableChannel::ReceiveMessage(Sequence sequence, const std::uint8_t* data, std::size_t size)
+    {
+        //Even a duplicate is acknowledged again, the previous ack may have been lost
+        ackPending_ = true;
+        const Sequence distance = sequence - nextReceiveSequence_;
+        if (distance >= windowSize)
+            return;
+        const auto index = sequence % windowSize;
+        if (received_[index])
+            return;
+        receiveWindow_[index].assign(data, data + size);
+        received_[index] = true;
+    }
+}
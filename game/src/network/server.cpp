@@ -2,6 +2,8 @@
 #include <utils/log.h>
 #include <fmt/format.h>
 #include <utils/conversion.h>
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 
 namespace game
@@ -16,26 +18,33 @@ namespace game
         {
             const auto* joinPacket = static_cast<const JoinPacket*>(packet.get());
             const auto clientId = core::ConvertFromBinary<ClientId>(joinPacket->clientId);
-            if (std::find(clientMap_.begin(), clientMap_.end(), clientId) != clientMap_.end())
+            const auto joinedEnd = clientMap_.begin() + lastPlayerNumber_;
+            if (std::find(clientMap_.begin(), joinedEnd, clientId) != joinedEnd)
             {
                 //Player joined twice!
                 return;
             }
+            if (lastPlayerNumber_ == playerCount_)
+            {
+                //The match is full
+                return;
+            }
             core::LogDebug("Managing Received Packet Join from: " + std::to_string(clientId));
             clientMap_[lastPlayerNumber_] = clientId;
             SpawnNewPlayer(clientId, lastPlayerNumber_);
 
             lastPlayerNumber_++;
 
-            if (lastPlayerNumber_ == maxPlayerNmb)
+            if (lastPlayerNumber_ == playerCount_)
             {
                 auto startGamePacket = std::make_unique<StartGamePacket>();
                 startGamePacket->packetType = PacketType::START_GAME;
                 using namespace std::chrono;
                 const auto ms = (duration_cast<duration<unsigned long long, std::milli>>(
                     system_clock::now().time_since_epoch()
-                    ) + milliseconds(3000)).count();
+                    ) + startDelay_).count();
                 startGamePacket->startTime = core::ConvertToBinary(ms);
+                gameManager_.SetMatchReplayStartTime(ms);
                 SendReliablePacket(std::move(startGamePacket));
             }
 
@@ -47,25 +56,26 @@ namespace game
             const auto* playerInputPacket = static_cast<const PlayerInputPacket*>(packet.get());
             const auto playerNumber = playerInputPacket->playerNumber;
             const auto inputFrame = core::ConvertFromBinary<Frame>(playerInputPacket->currentFrame);
+            if (playerNumber >= playerCount_)
+            {
+                break;
+            }
 
-            for (std::uint32_t i = 0; i < playerInputPacket->inputs.size(); i++)
+            gameManager_.SetPlayerInputs(playerNumber, inputFrame,
+                playerInputPacket->inputs.data(), playerInputPacket->inputCount);
+            auto& receivedFrames = receivedFrames_[playerNumber];
+            for (PlayerNumber i = 0; i < std::min(playerInputPacket->receivedCount, playerCount_); i++)
             {
-                gameManager_.SetPlayerInput(playerNumber,
-                    playerInputPacket->inputs[i],
-                    inputFrame - i);
-                if (inputFrame - i == 0)
-                {
-                    break;
-                }
+                receivedFrames[i] = std::max(receivedFrames[i], playerInputPacket->receivedFrames[i]);
             }
 
-            SendUnreliablePacket(std::move(packet));
+            SendPlayerInputs(playerNumber);
 
-            //Validate new frame if needed
-            std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(0);
-            for (PlayerNumber i = 1; i < maxPlayerNmb; i++)
+            //Validate new frame if needed, only the contiguous inputs are not predicted
+            std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastContiguousFrame(0);
+            for (PlayerNumber i = 1; i < playerCount_; i++)
             {
-                const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(i);
+                const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastContiguousFrame(i);
                 if (playerLastFrame < lastReceiveFrame)
                 {
                     lastReceiveFrame = playerLastFrame;
@@ -78,15 +88,14 @@ namespace game
 
                 auto validatePacket = std::make_unique<ValidateFramePacket>();
                 validatePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
-
-                //copy physics state
-                for (PlayerNumber i = 0; i < maxPlayerNmb; i++)
+                const auto stateHash = gameManager_.GetRollbackManager().GetValidateStateHash();
+                validatePacket->stateHash = core::ConvertToBinary(stateHash.full);
+                if (sendStateParts_)
                 {
-                    auto physicsState = gameManager_.GetRollbackManager().GetValidatePhysicsState(i);
-                    const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-                    for (size_t j = 0; j < sizeof(PhysicsState); j++)
+                    validatePacket->partCount = StateHash::PART_COUNT;
+                    for (std::size_t part = 0; part < StateHash::PART_COUNT; part++)
                     {
-                        validatePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
+                        validatePacket->partHashes[part] = core::ConvertToBinary(stateHash.parts[part]);
                     }
                 }
                 SendUnreliablePacket(std::move(validatePacket));
@@ -106,8 +115,59 @@ namespace game
         default: break;
         }
     }
+    void Server::SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber)
+    {
+        //Spawning the new player in the arena
+        for (PlayerNumber p = 0; p <= playerNumber; p++)
+        {
+            auto spawnPlayer = std::make_unique<SpawnPlayerPacket>();
+            spawnPlayer->clientId = core::ConvertToBinary(p == playerNumber ? clientId : clientMap_[p]);
+            spawnPlayer->playerNumber = p;
+
+            const auto pos = spawnPositions[p] * 3.0f;
+            spawnPlayer->pos = ConvertToBinary(pos);
+
+            const auto rotation = spawnRotations[p];
+            spawnPlayer->angle = core::ConvertToBinary(rotation);
+            gameManager_.SpawnPlayer(p, pos, rotation);
+
+            SendReliablePacket(std::move(spawnPlayer));
+        }
+    }
+
+    void Server::SendPlayerInputs(PlayerNumber playerNumber)
+    {
+        const auto& inputs = gameManager_.GetRollbackManager().GetInputs(playerNumber);
+        const auto ackFrame = inputs.GetLastContiguousFrame();
+        //The other clients only need the inputs after the oldest frame one of them holds
+        Frame oldestHeldFrame = ackFrame;
+        for (PlayerNumber i = 0; i < playerCount_; i++)
+        {
+            if (i != playerNumber)
+            {
+                oldestHeldFrame = std::min(oldestHeldFrame, receivedFrames_[i][playerNumber]);
+            }
+        }
+        //A client lagging more than a packet can hold gets the oldest missing inputs first
+        const auto newestFrame = std::min<Frame>(ackFrame, oldestHeldFrame + static_cast<Frame>(maxInputNmb));
+
+        auto playerInputPacket = std::make_unique<PlayerInputPacket>();
+        playerInputPacket->playerNumber = playerNumber;
+        playerInputPacket->currentFrame = core::ConvertToBinary(newestFrame);
+        playerInputPacket->inputCount = static_cast<std::uint8_t>(
+            inputs.CopyInputs(newestFrame, playerInputPacket->inputs.data(), newestFrame - oldestHeldFrame));
+        SendUnreliablePacket(std::move(playerInputPacket));
+    }
+
+    void Server::SetPlayerCount(PlayerNumber playerCount)
+    {
+        assert(playerCount > 0 && playerCount <= maxPlayerNmb);
+        playerCount_ = playerCount;
+    }
+
     void Server::Init()
     {
+        gameManager_.SetPlayerCount(playerCount_);
         gameManager_.SpawnLevel();
     }
 }
@@ -0,0 +1,59 @@
+#include <network/server_tick_scheduler.h>
+#include <network/network_server.h>
+#include <utils/log.h>
+#include <fmt/format.h>
+
+namespace game
+{
+    ServerTickScheduler::ServerTickScheduler(float period) : HeadlessEngine(1.0f / period)
+    {
+    }
+
+    void ServerTickScheduler::Run(ServerNetworkManager& server)
+    {
+        server_ = &server;
+        systems_.clear();
+        RegisterSystem(&server);
+        HeadlessEngine::Run();
+        LogStats();
+        server_ = nullptr;
+    }
+
+    void ServerTickScheduler::WaitUntil(Clock::time_point deadline)
+    {
+        using namespace std::chrono;
+        if (reportPeriod_ != 0 && stats_.tickCount != 0 && stats_.tickCount % reportPeriod_ == 0)
+        {
+            LogStats();
+        }
+        auto now = Clock::now();
+        while (now < deadline && server_->IsOpen())
+        {
+            const auto timeout = duration_cast<microseconds>(deadline - now);
+            if (server_->WaitForPackets(sf::microseconds(timeout.count())))
+            {
+                server_->ReceivePackets();
+            }
+            now = Clock::now();
+        }
+        if (!server_->IsOpen())
+        {
+            Stop();
+        }
+    }
+
+    void ServerTickScheduler::LogStats() const
+    {
+        const auto averageOverrun = stats_.overrunCount == 0 ? 0 :
+            stats_.totalOverrun.count() / static_cast<long long>(stats_.overrunCount);
+        core::LogDebug(fmt::format("[Server] Ticks: {} overruns: {} average overrun: {}us max overrun: {}us",
+            stats_.tickCount, stats_.overrunCount, averageOverrun, stats_.maxOverrun.count()));
+        const auto& sendStats = server_->GetSendQueueStats();
+        const auto averageFlush = sendStats.flushCount == 0 ? 0 :
+            sendStats.totalFlushTime.count() / static_cast<long long>(sendStats.flushCount);
+        core::LogDebug(fmt::format("[Server] Queued bytes: {} max queued bytes: {} average flush: {}us max flush: {}us "
+            "stalls avoided: {} shed packets: {} overflow disconnects: {} dropped datagrams: {}",
+            sendStats.queuedBytes, sendStats.maxQueuedBytes, averageFlush, sendStats.maxFlushTime.count(),
+            sendStats.stallsAvoided, sendStats.shedPackets, sendStats.overflowDisconnects, sendStats.droppedDatagrams));
+    }
+}
@@ -0,0 +1,242 @@
+#include <network/shared_packet.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace game
+{
+    class SharedPacketPool;
+
+    struct SharedPacketBuffer
+    {
+        std::atomic<std::uint32_t> refCount{ 0 };
+        std::vector<std::uint8_t> bytes;
+        //Pool of the thread that built the buffer, it gets the buffer back when released
+        SharedPacketPool* pool = nullptr;
+        SharedPacketBuffer* nextFree = nullptr;
+    };
+
+    /**
+     * \brief Released buffers of one thread. The owning thread takes and gives back its buffers without synchronization,
+     * the other threads, like the network thread releasing the buffers of a match worker, push them on a lock-free list
+     * that the owner takes whole when it runs out of buffers
+     */
+    class SharedPacketPool
+    {
+    public:
+        ~SharedPacketPool()
+        {
+            DeleteBuffers(freeBuffers_);
+            DeleteBuffers(remoteFreeBuffers_.exchange(nullptr, std::memory_order_acquire));
+        }
+
+        SharedPacketBuffer* Acquire()
+        {
+            if (freeBuffers_ == nullptr)
+            {
+                freeBuffers_ = remoteFreeBuffers_.exchange(nullptr, std::memory_order_acquire);
+            }
+            if (freeBuffers_ != nullptr)
+            {
+                return std::exchange(freeBuffers_, freeBuffers_->nextFree);
+            }
+            auto* buffer = new SharedPacketBuffer();
+            buffer->pool = this;
+            return buffer;
+        }
+
+        /**
+         * \brief Only called by the thread owning the pool
+         */
+        void Release(SharedPacketBuffer* buffer)
+        {
+            buffer->nextFree = freeBuffers_;
+            freeBuffers_ = buffer;
+        }
+
+        /**
+         * \brief Called by the other threads. They only push and the owner takes the whole list, so there is no ABA problem
+         */
+        void ReleaseRemote(SharedPacketBuffer* buffer)
+        {
+            auto* head = remoteFreeBuffers_.load(std::memory_order_relaxed);
+            do
+            {
+                buffer->nextFree = head;
+            } while (!remoteFreeBuffers_.compare_exchange_weak(head, buffer,
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+    private:
+        static void DeleteBuffers(SharedPacketBuffer* buffer)
+        {
+            while (buffer != nullptr)
+            {
+                delete std::exchange(buffer, buffer->nextFree);
+            }
+        }
+
+        SharedPacketBuffer* freeBuffers_ = nullptr;
+        std::atomic<SharedPacketBuffer*> remoteFreeBuffers_{ nullptr };
+    };
+
+    namespace
+    {
+        /**
+         * \brief Owns the pools of all the threads. The pool of a finished thread is kept for the next thread,
+         * its buffers still in flight are given back to it. Only locked when a thread starts or ends
+         */
+        class SharedPacketPoolRegistry
+        {
+        public:
+            SharedPacketPool* Adopt()
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!abandonedPools_.empty())
+                {
+                    auto* pool = abandonedPools_.back();
+                    abandonedPools_.pop_back();
+                    return pool;
+                }
+                auto* pool = pools_.emplace_back(std::make_unique<SharedPacketPool>()).get();
+                abandonedPools_.reserve(pools_.size());
+                return pool;
+            }
+
+            void Abandon(SharedPacketPool* pool)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                abandonedPools_.push_back(pool);
+            }
+        private:
+            std::mutex mutex_;
+            std::vector<std::unique_ptr<SharedPacketPool>> pools_;
+            std::vector<SharedPacketPool*> abandonedPools_;
+        };
+
+        SharedPacketPoolRegistry& GetSharedPacketPoolRegistry()
+        {
+            static SharedPacketPoolRegistry registry;
+            return registry;
+        }
+
+        class ThreadSharedPacketPool
+        {
+        public:
+            ThreadSharedPacketPool() : pool_(GetSharedPacketPoolRegistry().Adopt())
+            {
+            }
+
+            ~ThreadSharedPacketPool()
+            {
+                GetSharedPacketPoolRegistry().Abandon(pool_);
+            }
+
+            ThreadSharedPacketPool(const ThreadSharedPacketPool&) = delete;
+            ThreadSharedPacketPool& operator=(const ThreadSharedPacketPool&) = delete;
+
+            [[nodiscard]] SharedPacketPool& Get() const { return *pool_; }
+        private:
+            SharedPacketPool* pool_;
+        };
+
+        SharedPacketPool& GetSharedPacketPool()
+        {
+            thread_local ThreadSharedPacketPool threadPool;
+            return threadPool.Get();
+        }
+
+        //Scratch packet the broadcasts are serialized in before being copied in their shared buffer
+        thread_local sf::Packet serializedPacket;
+    }
+
+    SharedPacket::SharedPacket(Packet& packet)
+    {
+        serializedPacket.clear();
+        GeneratePacket(serializedPacket, packet);
+        const auto size = serializedPacket.getDataSize();
+        const auto* data = static_cast<const std::uint8_t*>(serializedPacket.getData());
+
+        buffer_ = GetSharedPacketPool().Acquire();
+        buffer_->refCount.store(1, std::memory_order_relaxed);
+        buffer_->bytes.assign(data, data + size);
+    }
+
+    SharedPacket::SharedPacket(const SharedPacket& other) noexcept : buffer_(other.buffer_)
+    {
+        if (buffer_ != nullptr)
+        {
+            buffer_->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedPacket::SharedPacket(SharedPacket&& other) noexcept : buffer_(std::exchange(other.buffer_, nullptr))
+    {
+    }
+
+    SharedPacket& SharedPacket::operator=(const SharedPacket& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            buffer_ = other.buffer_;
+            if (buffer_ != nullptr)
+            {
+                buffer_->refCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return *this;
+    }
+
+    SharedPacket& SharedPacket::operator=(SharedPacket&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            buffer_ = std::exchange(other.buffer_, nullptr);
+        }
+        return *this;
+    }
+
+    SharedPacket::~SharedPacket()
+    {
+        Release();
+    }
+
+    const std::uint8_t* SharedPacket::GetData() const
+    {
+        return buffer_->bytes.data();
+    }
+
+    std::size_t SharedPacket::GetSize() const
+    {
+        return buffer_->bytes.size();
+    }
+
+    sf::Socket::Status SharedPacket::Send(sf::UdpSocket& socket, const sf::IpAddress& address, unsigned short port) const
+    {
+        return socket.send(GetData(), GetSize(), address, port);
+    }
+
+    void SharedPacket::Release()
+    {
+        if (buffer_ == nullptr)
+            return;
+        if (buffer_->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            auto& threadPool = GetSharedPacketPool();
+            if (buffer_->pool == &threadPool)
+            {
+                threadPool.Release(buffer_);
+            }
+            else
+            {
+                buffer_->pool->ReleaseRemote(buffer_);
+            }
+        }
+        buffer_ = nullptr;
+    }
+}
@@ -7,8 +7,9 @@
 
 namespace game
 {
-    SimulationServer::SimulationServer(std::array<std::unique_ptr<SimulationClient>, 2>& clients) : clients_(clients)
+    SimulationServer::SimulationServer(std::array<std::unique_ptr<SimulationClient>, defaultPlayerNmb>& clients) : clients_(clients)
     {
+        SetPlayerCount(static_cast<PlayerNumber>(clients_.size()));
     }
 
     void SimulationServer::Init()
@@ -0,0 +1,88 @@
+#include <network/socket_poller.h>
+#include <network/socket_handle.h>
+#include <utils/log.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace game
+{
+#ifdef __linux__
+    SocketPoller::SocketPoller() : epollFd_(epoll_create1(0))
+    {
+        assert(epollFd_ >= 0);
+    }
+
+    SocketPoller::~SocketPoller()
+    {
+        close(epollFd_);
+    }
+
+    void SocketPoller::Add(sf::Socket& socket, Key key)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = key;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, GetSocketHandle(socket), &event) != 0)
+        {
+            core::LogError("[SocketPoller] Could not add socket");
+        }
+    }
+
+    void SocketPoller::Remove(sf::Socket& socket)
+    {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, GetSocketHandle(socket), nullptr);
+    }
+
+    void SocketPoller::Wait(sf::Time timeout, std::vector<Key>& readyKeys)
+    {
+        constexpr int maxEvents = 256;
+        std::array<epoll_event, maxEvents> events{};
+        readyKeys.clear();
+        const auto timeoutMs = std::max<std::int64_t>(0, (timeout.asMicroseconds() + 999) / 1000);
+        const auto count = epoll_wait(epollFd_, events.data(), maxEvents, static_cast<int>(timeoutMs));
+        for (int i = 0; i < count; i++)
+        {
+            readyKeys.push_back(events[i].data.u64);
+        }
+    }
+#else
+    SocketPoller::SocketPoller() = default;
+
+    SocketPoller::~SocketPoller() = default;
+
+    void SocketPoller::Add(sf::Socket& socket, Key key)
+    {
+        selector_.add(socket);
+        entries_.push_back({ &socket, key });
+    }
+
+    void SocketPoller::Remove(sf::Socket& socket)
+    {
+        selector_.remove(socket);
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+            [&socket](const Entry& entry) { return entry.socket == &socket; }), entries_.end());
+    }
+
+    void SocketPoller::Wait(sf::Time timeout, std::vector<Key>& readyKeys)
+    {
+        readyKeys.clear();
+        //A zero timeout would make the selector wait forever
+        if (!selector_.wait(std::max(timeout, sf::microseconds(1))))
+            return;
+        for (const auto& entry : entries_)
+        {
+            if (selector_.isReady(*entry.socket))
+            {
+                readyKeys.push_back(entry.key);
+            }
+        }
+    }
+#endif
+}
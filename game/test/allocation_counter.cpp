@@ -0,0 +1,37 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::size_t> allocationCount{ 0 };
+}
+
+//The array and nothrow forms forward to these ones, the aligned forms keep their default implementation
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace game
+{
+    std::size_t GetAllocationCount()
+    {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game
+{
+    /**
+     * \brief Number of calls to the global operator new since the start of the test program.
+     * The replaced operators live in their own translation unit so the compiler never sees the default
+     * new and the replaced delete of the same pointer together.
+     */
+    std::size_t GetAllocationCount();
+}
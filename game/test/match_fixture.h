@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include <game/game_manager.h>
+
+namespace game
+{
+    /**
+     * \brief Spawns the level and the players at their spawn positions, like the server does when the match is full
+     */
+    inline void SpawnMatch(GameManager& gameManager, PlayerNumber playerCount)
+    {
+        gameManager.SetPlayerCount(playerCount);
+        gameManager.SpawnLevel();
+        for (PlayerNumber playerNumber = 0; playerNumber < playerCount; playerNumber++)
+        {
+            gameManager.SpawnPlayer(playerNumber, spawnPositions[playerNumber] * 3.0f, spawnRotations[playerNumber]);
+        }
+    }
+
+    /**
+     * \brief Scripted input of the tests and benchmarks, it changes every few frames so that the predicted inputs are sometimes wrong
+     */
+    inline PlayerInput ScriptedInput(Frame frame, PlayerNumber playerNumber = 0)
+    {
+        return ((frame / 7u + playerNumber) % 3u == 0) ? PlayerInputEnum::UP : PlayerInputEnum::UP | PlayerInputEnum::LEFT;
+    }
+
+    /**
+     * \brief Path with a unique name in the temporary directory, the file or the directory is removed when it goes
+     * out of scope, so it must outlive the readers and writers of the file
+     */
+    class TemporaryFile
+    {
+    public:
+        explicit TemporaryFile(const std::string& extension)
+        {
+            std::random_device randomDevice;
+            const auto name = "rollback_test_" + std::to_string(randomDevice()) + "_" + std::to_string(randomDevice()) + extension;
+            path_ = (std::filesystem::temp_directory_path() / name).string();
+        }
+        ~TemporaryFile()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(path_, error);
+        }
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        [[nodiscard]] const std::string& GetPath() const { return path_; }
+    private:
+        std::string path_;
+    };
+}
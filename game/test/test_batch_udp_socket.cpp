@@ -0,0 +1,45 @@
+#include <network/batch_udp_socket.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+TEST(BatchUdpSocket, RefusedDatagramDoesNotDropTheRestOfTheBatch)
+{
+    game::BatchUdpSocket sender;
+    game::BatchUdpSocket receiver;
+    ASSERT_EQ(sender.GetSocket().bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost), sf::Socket::Done);
+    ASSERT_EQ(receiver.GetSocket().bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost), sf::Socket::Done);
+    receiver.GetSocket().setBlocking(false);
+    const auto receiverPort = receiver.GetSocket().getLocalPort();
+
+    const std::string first = "first";
+    const std::string last = "last";
+    sender.Send(first.data(), first.size(), sf::IpAddress::LocalHost, receiverPort);
+    //The broadcast address is refused on a socket without SO_BROADCAST
+    sender.Send(first.data(), first.size(), sf::IpAddress(0xFFFFFFFFu), receiverPort);
+    sender.Send(last.data(), last.size(), sf::IpAddress::LocalHost, receiverPort);
+    EXPECT_EQ(sender.Flush(), 2u);
+    EXPECT_EQ(sender.GetDroppedCount(), 1u);
+    EXPECT_EQ(sender.GetPendingCount(), 0u);
+
+    std::vector<std::string> received;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received.size() < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        const auto count = receiver.Receive();
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto& datagram = receiver.GetDatagram(i);
+            received.emplace_back(reinterpret_cast<const char*>(datagram.data), datagram.size);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], first);
+    EXPECT_EQ(received[1], last);
+}
+#endif
@@ -0,0 +1,108 @@
+#include <game/physics_manager.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t broadphaseBodyCount = 48;
+    constexpr int broadphaseStepCount = 60;
+
+    struct BroadphaseWorld
+    {
+        core::EntityManager entityManager;
+        game::StaticCollisionSet staticCollisionSet;
+        game::PhysicsManager physicsManager{ entityManager, staticCollisionSet };
+    };
+
+    /**
+     * \brief Bodies crowded around the origin so that they overlap several cells, on the negative side too, over a static floor
+     */
+    std::unique_ptr<BroadphaseWorld> MakeBroadphaseWorld(float cellSize)
+    {
+        auto world = std::make_unique<BroadphaseWorld>();
+        world->physicsManager.SetCellSize(game::Scalar(cellSize));
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int> position(-60, 60);
+        std::uniform_int_distribution<int> velocity(-20, 20);
+        for (std::size_t i = 0; i < broadphaseBodyCount; i++)
+        {
+            const auto entity = world->entityManager.CreateEntity();
+            game::BoxBody body;
+            body.position = game::SimVec2(game::Scalar(position(generator) / 10.0f), game::Scalar(position(generator) / 10.0f));
+            body.velocity = game::SimVec2(game::Scalar(velocity(generator) / 10.0f), game::Scalar(velocity(generator) / 10.0f));
+            body.extends = game::SimVec2(0.32f, 0.275f);
+            world->physicsManager.AddBoxBody(entity);
+            world->physicsManager.SetBoxBody(entity, body);
+        }
+        const auto floor = world->entityManager.CreateEntity();
+        game::BoxBody floorBody;
+        floorBody.position = game::SimVec2(0.0f, -7.0f);
+        floorBody.extends = game::SimVec2(8.0f, 0.5f);
+        floorBody.bodyType = game::BodyType::STATIC;
+        world->physicsManager.AddStaticBody(floor, floorBody);
+        return world;
+    }
+}
+
+TEST(Broadphase, CellRangeFloorsNegativeCoordinates)
+{
+    game::Aabb aabb;
+    aabb.minX = game::Scalar(-2.5f);
+    aabb.minY = game::Scalar(-0.5f);
+    aabb.maxX = game::Scalar(1.0f);
+    aabb.maxY = game::Scalar(0.5f);
+    const auto cellRange = game::GetCellRange(aabb, game::Scalar(1.0f));
+    EXPECT_EQ(cellRange.minX, -3);
+    EXPECT_EQ(cellRange.minY, -1);
+    EXPECT_EQ(cellRange.maxX, 1);
+    EXPECT_EQ(cellRange.maxY, 0);
+
+    EXPECT_NE(game::GetCellKey(-1, 0), game::GetCellKey(0, -1));
+    EXPECT_NE(game::GetCellKey(-1, -1), game::GetCellKey(1, 1));
+}
+
+TEST(Broadphase, TouchingBodiesShareACell)
+{
+    //Box2Box includes the bounds, the cell ranges have to include them too
+    game::Aabb aabb1;
+    aabb1.minX = game::Scalar(0.0f);
+    aabb1.minY = game::Scalar(0.0f);
+    aabb1.maxX = game::Scalar(2.0f);
+    aabb1.maxY = game::Scalar(1.0f);
+    game::Aabb aabb2 = aabb1;
+    aabb2.minX = game::Scalar(2.0f);
+    aabb2.maxX = game::Scalar(3.0f);
+    ASSERT_TRUE(game::Box2Box(aabb1, aabb2));
+    const auto cellRange1 = game::GetCellRange(aabb1, game::Scalar(2.0f));
+    const auto cellRange2 = game::GetCellRange(aabb2, game::Scalar(2.0f));
+    EXPECT_GE(cellRange1.maxX, cellRange2.minX);
+}
+
+TEST(Broadphase, SameResultForEveryCellSize)
+{
+    //A single cell holding every body is the full double loop
+    const auto reference = MakeBroadphaseWorld(1000.0f);
+    const auto smallCells = MakeBroadphaseWorld(0.5f);
+    const auto defaultCells = MakeBroadphaseWorld(game::physicsCellSize);
+    for (int step = 0; step < broadphaseStepCount; step++)
+    {
+        reference->physicsManager.FixedUpdate(sf::seconds(0.02f));
+        smallCells->physicsManager.FixedUpdate(sf::seconds(0.02f));
+        defaultCells->physicsManager.FixedUpdate(sf::seconds(0.02f));
+    }
+    const auto& entities = reference->physicsManager.GetEntities();
+    ASSERT_EQ(entities.size(), broadphaseBodyCount);
+    for (const auto entity : entities)
+    {
+        const auto body = reference->physicsManager.GetBody(entity);
+        for (const auto* world : { smallCells.get(), defaultCells.get() })
+        {
+            const auto otherBody = world->physicsManager.GetBody(entity);
+            EXPECT_TRUE(body.position.x == otherBody.position.x && body.position.y == otherBody.position.y) << "entity " << entity;
+            EXPECT_TRUE(body.velocity.x == otherBody.velocity.x && body.velocity.y == otherBody.velocity.y) << "entity " << entity;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include <game/match_playback.h>
+#include <game/match_replay.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace
+{
+    /**
+     * \brief Two player match recorded by the server with StartMatchReplay, over the simulated network of the debug app:
+     * random inputs, delays and rollbacks, 1400 validated frames
+     */
+    const std::string recordedMatchPath = std::string(GAME_TEST_DATA_DIR) + "/recorded_match.replay";
+
+    game::StateHash ReplayRecordedMatch()
+    {
+        game::MatchReplayReader replay;
+        if (!replay.Open(recordedMatchPath))
+        {
+            ADD_FAILURE() << "Could not open " << recordedMatchPath;
+            return {};
+        }
+        EXPECT_EQ(replay.GetPlayerCount(), 2);
+        EXPECT_EQ(replay.GetFirstFrame(), 1u);
+        for (game::PlayerNumber playerNumber = 0; playerNumber < replay.GetPlayerCount(); playerNumber++)
+        {
+            EXPECT_TRUE(replay.GetSpawn(playerNumber).spawned);
+        }
+        game::MatchPlayback playback(replay);
+        playback.Play();
+        EXPECT_EQ(playback.GetFrame(), replay.GetFirstFrame() + replay.GetFrameCount() - 1);
+        return playback.GetRollbackManager().GetValidateStateHash();
+    }
+}
+
+TEST(Determinism, ReplayIsRepeatable)
+{
+    EXPECT_EQ(ReplayRecordedMatch().full, ReplayRecordedMatch().full);
+}
+
+TEST(Determinism, FixedPointReplayMatchesEveryBuild)
+{
+#ifdef GAME_FIXED_POINT
+    //Hash of the recorded match, the same for every compiler, flag and CPU
+    EXPECT_EQ(ReplayRecordedMatch().full, 0x5c02725c4ed5e89dull);
+#else
+    GTEST_SKIP() << "Only the fixed point simulation is deterministic across builds";
+#endif
+}
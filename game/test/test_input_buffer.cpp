@@ -0,0 +1,156 @@
+#include <game/input_buffer.h>
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace
+{
+    constexpr game::PlayerInput up = game::PlayerInputEnum::UP;
+    constexpr game::PlayerInput left = game::PlayerInputEnum::LEFT;
+    constexpr game::PlayerInput down = game::PlayerInputEnum::DOWN;
+}
+
+TEST(PlayerInputBuffer, PredictsTheLastReceivedInput)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(10);
+    //A new input differing from the predicted one dirties its frame
+    EXPECT_EQ(buffer.SetInput(3, up), 3u);
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 3u);
+    EXPECT_EQ(buffer.GetInput(3), up);
+    EXPECT_EQ(buffer.GetInput(10), up);
+    //The same input as the predicted one does not
+    EXPECT_EQ(buffer.SetInput(4, up), game::INVALID_FRAME);
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 4u);
+}
+
+TEST(PlayerInputBuffer, FillsTheGapWithThePrediction)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(10);
+    buffer.SetInput(3, up);
+    EXPECT_EQ(buffer.SetInput(6, left), 6u);
+    EXPECT_EQ(buffer.GetInput(4), up);
+    EXPECT_EQ(buffer.GetInput(5), up);
+    EXPECT_EQ(buffer.GetInput(6), left);
+    EXPECT_EQ(buffer.GetInput(9), left);
+    //A single input comes from the local player, the skipped frames count as received
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 6u);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 6u);
+}
+
+TEST(PlayerInputBuffer, DuplicateAndOutOfOrderInputs)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(10);
+    buffer.SetInput(3, up);
+    buffer.SetInput(6, left);
+    EXPECT_EQ(buffer.SetInput(6, left), game::INVALID_FRAME);
+
+    //An older input arriving late only changes its own frame
+    EXPECT_EQ(buffer.SetInput(4, down), 4u);
+    EXPECT_EQ(buffer.GetInput(4), down);
+    EXPECT_EQ(buffer.GetInput(5), up);
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 6u);
+    EXPECT_EQ(buffer.SetInput(4, down), game::INVALID_FRAME);
+}
+
+TEST(PlayerInputBuffer, IgnoresFramesOlderThanTheWindow)
+{
+    game::PlayerInputBuffer buffer;
+    constexpr auto currentFrame = static_cast<game::Frame>(game::windowBufferSize + 20);
+    buffer.StartNewFrame(currentFrame);
+    EXPECT_EQ(buffer.GetOldestFrame(), 21u);
+    EXPECT_FALSE(buffer.Contains(20));
+    EXPECT_TRUE(buffer.Contains(21));
+    EXPECT_EQ(buffer.SetInput(20, up), game::INVALID_FRAME);
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 0u);
+}
+
+TEST(PlayerInputBuffer, CopiesTheInputsAcrossTheWrapAround)
+{
+    game::PlayerInputBuffer buffer;
+    constexpr auto lastReceivedFrame = static_cast<game::Frame>(game::windowBufferSize + 5);
+    const auto frameInput = [](game::Frame frame)
+    {
+        return static_cast<game::PlayerInput>(frame % 16u);
+    };
+    for (game::Frame frame = 1; frame <= lastReceivedFrame; frame++)
+    {
+        buffer.StartNewFrame(frame);
+        buffer.SetInput(frame, frameInput(frame));
+    }
+    buffer.StartNewFrame(lastReceivedFrame + 2);
+
+    //Newest first, the two predicted frames repeat the last received input
+    std::array<game::PlayerInput, 20> inputs{};
+    ASSERT_EQ(buffer.CopyInputs(lastReceivedFrame + 2, inputs.data(), inputs.size()), inputs.size());
+    EXPECT_EQ(inputs[0], frameInput(lastReceivedFrame));
+    EXPECT_EQ(inputs[1], frameInput(lastReceivedFrame));
+    for (std::size_t i = 2; i < inputs.size(); i++)
+    {
+        EXPECT_EQ(inputs[i], frameInput(lastReceivedFrame + 2 - static_cast<game::Frame>(i)));
+    }
+    //Not further than the oldest frame held
+    EXPECT_EQ(buffer.CopyInputs(buffer.GetOldestFrame() + 2, inputs.data(), inputs.size()), 3u);
+}
+
+TEST(PlayerInputBuffer, PacketsAfterAHoleAreNotContiguous)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(20);
+    //Packets hold the inputs from their frame to the past, newest first
+    const std::array<game::PlayerInput, 5> firstInputs = { left, left, up, up, up };
+    EXPECT_EQ(buffer.SetInputs(5, firstInputs.data(), firstInputs.size()), 1u);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 5u);
+
+    //The packet of the frames 6 and 7 is lost
+    const std::array<game::PlayerInput, 3> lateInputs = { down, down, down };
+    buffer.SetInputs(10, lateInputs.data(), lateInputs.size());
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 10u);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 5u);
+    //The hole stays predicted
+    EXPECT_EQ(buffer.GetInput(6), left);
+    EXPECT_EQ(buffer.GetInput(7), left);
+
+    //The next packet covers the hole
+    const std::array<game::PlayerInput, 6> nextInputs = { down, down, down, down, up, down };
+    EXPECT_EQ(buffer.SetInputs(11, nextInputs.data(), nextInputs.size()), 6u);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 11u);
+    EXPECT_EQ(buffer.GetInput(6), down);
+    EXPECT_EQ(buffer.GetInput(7), up);
+}
+
+TEST(PlayerInputBuffer, DuplicateAndOutOfOrderPackets)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(20);
+    const std::array<game::PlayerInput, 4> inputs = { up, up, left, left };
+    ASSERT_NE(buffer.SetInputs(4, inputs.data(), inputs.size()), game::INVALID_FRAME);
+    EXPECT_EQ(buffer.SetInputs(4, inputs.data(), inputs.size()), game::INVALID_FRAME);
+
+    const std::array<game::PlayerInput, 2> newInputs = { down, down };
+    EXPECT_EQ(buffer.SetInputs(6, newInputs.data(), newInputs.size()), 5u);
+    //An older packet arriving after is already held and skipped, even if its inputs differ
+    const std::array<game::PlayerInput, 3> oldInputs = { down, down, down };
+    EXPECT_EQ(buffer.SetInputs(3, oldInputs.data(), oldInputs.size()), game::INVALID_FRAME);
+    EXPECT_EQ(buffer.GetInput(3), up);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 6u);
+    EXPECT_EQ(buffer.GetLastReceivedFrame(), 6u);
+}
+
+TEST(PlayerInputBuffer, AckedPacketsOnlyApplyTheNewFrames)
+{
+    game::PlayerInputBuffer buffer;
+    buffer.StartNewFrame(20);
+    const std::array<game::PlayerInput, 3> inputs = { up, up, up };
+    buffer.SetInputs(3, inputs.data(), inputs.size());
+    //A packet overlapping the held frames only changes the frames after the last contiguous one
+    const std::array<game::PlayerInput, 4> overlappingInputs = { left, up, down, down };
+    EXPECT_EQ(buffer.SetInputs(5, overlappingInputs.data(), overlappingInputs.size()), 5u);
+    EXPECT_EQ(buffer.GetInput(2), up);
+    EXPECT_EQ(buffer.GetInput(3), up);
+    EXPECT_EQ(buffer.GetInput(4), up);
+    EXPECT_EQ(buffer.GetInput(5), left);
+    EXPECT_EQ(buffer.GetLastContiguousFrame(), 5u);
+}
@@ -0,0 +1,107 @@
+#include <network/packet_type.h>
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace
+{
+    std::unique_ptr<game::PlayerInputPacket> RoundTrip(game::PlayerInputPacket& playerInputPacket, std::size_t removedBytes = 0)
+    {
+        sf::Packet packet;
+        game::GeneratePacket(packet, playerInputPacket);
+        sf::Packet receivedPacket;
+        receivedPacket.append(packet.getData(), packet.getDataSize() - removedBytes);
+        auto receivedPacketPtr = game::GenerateReceivedPacket(receivedPacket);
+        if (receivedPacketPtr == nullptr || receivedPacketPtr->packetType != game::PacketType::INPUT)
+            return nullptr;
+        return std::unique_ptr<game::PlayerInputPacket>(static_cast<game::PlayerInputPacket*>(receivedPacketPtr.release()));
+    }
+}
+
+TEST(InputPacket, VarFrameRoundTrip)
+{
+    constexpr std::array<std::pair<game::Frame, std::size_t>, 8> frames = { {
+        { 0u, 1u }, { 1u, 1u }, { 127u, 1u }, { 128u, 2u }, { 16383u, 2u }, { 16384u, 3u },
+        { 123456789u, 4u }, { 0xFFFFFFFFu, 5u } } };
+    for (const auto& [frame, size] : frames)
+    {
+        sf::Packet packet;
+        game::WriteVarFrame(packet, frame);
+        EXPECT_EQ(packet.getDataSize(), size) << frame;
+        EXPECT_EQ(game::ReadVarFrame(packet), frame);
+        EXPECT_TRUE(packet.endOfPacket());
+    }
+}
+
+TEST(InputPacket, RelativeFrameRoundTrip)
+{
+    constexpr game::Frame referenceFrame = 100000;
+    //A client can hold inputs of another player newer than its own current frame
+    for (const game::Frame frame : { referenceFrame, referenceFrame - 1, referenceFrame + 1, referenceFrame - 63,
+        referenceFrame + 64, game::Frame(0), game::INVALID_FRAME })
+    {
+        sf::Packet packet;
+        game::WriteRelativeFrame(packet, referenceFrame, frame);
+        EXPECT_EQ(game::ReadRelativeFrame(packet, referenceFrame), frame);
+    }
+    sf::Packet packet;
+    game::WriteRelativeFrame(packet, referenceFrame, referenceFrame - 10);
+    EXPECT_EQ(packet.getDataSize(), 1u);
+}
+
+TEST(InputPacket, RunLengthRoundTrip)
+{
+    game::PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = 3;
+    playerInputPacket.currentFrame = core::ConvertToBinary<game::Frame>(5000);
+    playerInputPacket.inputCount = static_cast<std::uint8_t>(game::maxInputNmb);
+    //A run longer than 16 inputs, single inputs, and the 4 bits of every input
+    for (std::size_t i = 0; i < game::maxInputNmb; i++)
+    {
+        playerInputPacket.inputs[i] = i < 20 ? static_cast<game::PlayerInput>(game::PlayerInputEnum::UP) : static_cast<game::PlayerInput>(i % 16u);
+    }
+    playerInputPacket.receivedCount = 2;
+    playerInputPacket.receivedFrames[0] = 4990;
+    playerInputPacket.receivedFrames[1] = 5003;
+
+    const auto receivedPacket = RoundTrip(playerInputPacket);
+    ASSERT_NE(receivedPacket, nullptr);
+    EXPECT_EQ(receivedPacket->playerNumber, 3);
+    EXPECT_EQ(core::ConvertFromBinary<game::Frame>(receivedPacket->currentFrame), 5000u);
+    ASSERT_EQ(receivedPacket->inputCount, game::maxInputNmb);
+    EXPECT_EQ(receivedPacket->inputs, playerInputPacket.inputs);
+    ASSERT_EQ(receivedPacket->receivedCount, 2);
+    EXPECT_EQ(receivedPacket->receivedFrames[0], 4990u);
+    EXPECT_EQ(receivedPacket->receivedFrames[1], 5003u);
+}
+
+TEST(InputPacket, TruncatedPacketKeepsTheWholeRuns)
+{
+    game::PlayerInputPacket playerInputPacket;
+    playerInputPacket.playerNumber = 0;
+    playerInputPacket.currentFrame = core::ConvertToBinary<game::Frame>(60);
+    playerInputPacket.inputCount = 4;
+    playerInputPacket.inputs = { game::PlayerInputEnum::UP, game::PlayerInputEnum::LEFT,
+        game::PlayerInputEnum::LEFT, game::PlayerInputEnum::DOWN };
+    playerInputPacket.receivedCount = 0;
+
+    //Without the received count and the last run
+    const auto receivedPacket = RoundTrip(playerInputPacket, 2);
+    ASSERT_NE(receivedPacket, nullptr);
+    ASSERT_EQ(receivedPacket->inputCount, 3);
+    EXPECT_EQ(receivedPacket->inputs[0], game::PlayerInputEnum::UP);
+    EXPECT_EQ(receivedPacket->inputs[2], game::PlayerInputEnum::LEFT);
+    EXPECT_EQ(receivedPacket->receivedCount, 0);
+}
+
+TEST(InputPacket, OtherVersionIsIgnored)
+{
+    sf::Packet packet;
+    packet << static_cast<std::uint8_t>(game::PacketType::INPUT) << static_cast<std::uint8_t>(game::playerInputPacketVersion + 1);
+    packet << static_cast<std::uint8_t>(0) << static_cast<std::uint8_t>(1);
+    const auto receivedPacket = game::GenerateReceivedPacket(packet);
+    ASSERT_NE(receivedPacket, nullptr);
+    const auto* playerInputPacket = static_cast<const game::PlayerInputPacket*>(receivedPacket.get());
+    EXPECT_EQ(playerInputPacket->playerNumber, game::INVALID_PLAYER);
+    EXPECT_EQ(playerInputPacket->inputCount, 0);
+}
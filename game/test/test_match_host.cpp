@@ -0,0 +1,200 @@
+#include <network/match_host.h>
+#include <network/network_client.h>
+#include <utils/conversion.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "match_fixture.h"
+
+namespace
+{
+    constexpr game::MatchId hostTestMatchId = 7;
+
+    sf::Packet MakeJoinPacket(game::ClientId clientId, game::MatchId matchId)
+    {
+        game::JoinPacket joinPacket;
+        joinPacket.clientId = core::ConvertToBinary(clientId);
+        joinPacket.matchId = core::ConvertToBinary(matchId);
+        sf::Packet packet;
+        game::GeneratePacket(packet, joinPacket);
+        return packet;
+    }
+
+    //Type of the packets a match session asked the network thread to send
+    std::vector<game::PacketType> PopSentPackets(game::MatchQueue& outbox)
+    {
+        std::vector<game::PacketType> packetTypes;
+        game::MatchMessage message;
+        while (outbox.Pop(message))
+        {
+            EXPECT_EQ(message.matchId, hostTestMatchId);
+            if (!message.sharedPacket.IsEmpty())
+            {
+                packetTypes.push_back(static_cast<game::PacketType>(message.sharedPacket.GetData()[0]));
+            }
+        }
+        return packetTypes;
+    }
+}
+
+TEST(MatchHost, ReadJoinMatchIdRefusesMalformedPackets)
+{
+    const auto joinPacket = MakeJoinPacket(3, hostTestMatchId);
+    EXPECT_EQ(game::MatchHost::ReadJoinMatchId(joinPacket), hostTestMatchId);
+
+    EXPECT_EQ(game::MatchHost::ReadJoinMatchId(sf::Packet()), game::INVALID_MATCH);
+    sf::Packet truncatedPacket;
+    truncatedPacket.append(joinPacket.getData(), joinPacket.getDataSize() - 1);
+    EXPECT_EQ(game::MatchHost::ReadJoinMatchId(truncatedPacket), game::INVALID_MATCH);
+
+    game::WinGamePacket winGamePacket;
+    sf::Packet otherPacket;
+    game::GeneratePacket(otherPacket, winGamePacket);
+    EXPECT_EQ(game::MatchHost::ReadJoinMatchId(otherPacket), game::INVALID_MATCH);
+}
+
+TEST(MatchHost, SessionStartsWhenFullAndRefusesMorePlayers)
+{
+    game::MatchQueue outbox(64);
+    game::MatchSession session(hostTestMatchId, 2, 12345, outbox);
+    session.Init();
+
+    auto joinPacket = MakeJoinPacket(1, hostTestMatchId);
+    session.ReceivePacket(joinPacket, true);
+    EXPECT_EQ(PopSentPackets(outbox),
+        (std::vector<game::PacketType>{ game::PacketType::SPAWN_PLAYER, game::PacketType::JOIN_ACK }));
+
+    joinPacket = MakeJoinPacket(2, hostTestMatchId);
+    session.ReceivePacket(joinPacket, true);
+    EXPECT_EQ(PopSentPackets(outbox),
+        (std::vector<game::PacketType>{ game::PacketType::SPAWN_PLAYER, game::PacketType::SPAWN_PLAYER,
+            game::PacketType::START_GAME, game::PacketType::JOIN_ACK }));
+
+    joinPacket = MakeJoinPacket(3, hostTestMatchId);
+    session.ReceivePacket(joinPacket, true);
+    EXPECT_TRUE(PopSentPackets(outbox).empty());
+
+    session.Disconnect();
+    EXPECT_FALSE(session.IsOpen());
+    EXPECT_EQ(PopSentPackets(outbox), (std::vector<game::PacketType>{ game::PacketType::WIN_GAME }));
+}
+
+TEST(MatchHost, StalledSessionEndsTheMatch)
+{
+    game::MatchQueue outbox(64);
+    game::MatchSession session(hostTestMatchId, 2, 12345, outbox);
+    session.Init();
+    //A match waiting for its players is not stalled
+    auto joinPacket = MakeJoinPacket(1, hostTestMatchId);
+    session.ReceivePacket(joinPacket, true);
+    for (int i = 0; i < 20; i++)
+    {
+        session.Update(sf::seconds(1.0f));
+    }
+    EXPECT_TRUE(session.IsOpen());
+
+    joinPacket = MakeJoinPacket(2, hostTestMatchId);
+    session.ReceivePacket(joinPacket, true);
+    PopSentPackets(outbox);
+    //No input comes, so no frame is validated
+    for (int i = 0; i < 9; i++)
+    {
+        session.Update(sf::seconds(1.0f));
+    }
+    EXPECT_TRUE(session.IsOpen());
+    for (int i = 0; i < 2; i++)
+    {
+        session.Update(sf::seconds(1.0f));
+    }
+    EXPECT_FALSE(session.IsOpen());
+    EXPECT_EQ(PopSentPackets(outbox), (std::vector<game::PacketType>{ game::PacketType::WIN_GAME }));
+}
+
+TEST(MatchHost, DatagramsWithoutJoinDoNotTakeAPlayerSlot)
+{
+    using namespace std::chrono_literals;
+    game::MatchHost host(1);
+    host.SetPort(sf::Socket::AnyPort);
+    host.SetPlayerCount(2);
+    host.Init();
+    const auto hostPort = host.GetPort();
+    std::thread hostThread(&game::MatchHost::Run, &host);
+
+    //A connection sending two join packets, and datagrams not starting with a join packet
+    sf::UdpSocket spoofedSocket;
+    ASSERT_EQ(spoofedSocket.bind(sf::Socket::AnyPort), sf::Socket::Done);
+    game::ReliableChannel spoofedChannel;
+    for (int i = 0; i < 2; i++)
+    {
+        game::JoinPacket joinPacket;
+        joinPacket.clientId = core::ConvertToBinary<game::ClientId>(i + 1);
+        joinPacket.matchId = core::ConvertToBinary(hostTestMatchId);
+        spoofedChannel.Send(game::SharedPacket(joinPacket));
+    }
+    std::vector<std::unique_ptr<sf::UdpSocket>> otherSockets;
+    for (int i = 0; i < 3; i++)
+    {
+        game::ReliableChannel channel;
+        game::WinGamePacket winGamePacket;
+        channel.Send(game::SharedPacket(winGamePacket));
+        auto& socket = otherSockets.emplace_back(std::make_unique<sf::UdpSocket>());
+        ASSERT_EQ(socket->bind(sf::Socket::AnyPort), sf::Socket::Done);
+        const auto datagramCount = channel.Update(game::ReliableChannel::Clock::now());
+        for (std::size_t j = 0; j < datagramCount; j++)
+        {
+            socket->send(channel.GetDatagram(j).data(), channel.GetDatagram(j).size(), sf::IpAddress::LocalHost, hostPort);
+        }
+    }
+    //Only the first join of the spoofed connection counts, the match keeps a slot for the second client
+    const auto spoofedCount = spoofedChannel.Update(game::ReliableChannel::Clock::now());
+    for (std::size_t j = 0; j < spoofedCount; j++)
+    {
+        spoofedSocket.send(spoofedChannel.GetDatagram(j).data(), spoofedChannel.GetDatagram(j).size(),
+            sf::IpAddress::LocalHost, hostPort);
+    }
+    std::this_thread::sleep_for(10ms);
+
+    game::ClientNetworkManager client;
+    client.Init();
+    client.Join(sf::IpAddress::LocalHost, hostPort, hostTestMatchId);
+    for (int step = 0; step < 500 && client.GetGameManager().GetPlayerNumber() == game::INVALID_PLAYER; step++)
+    {
+        client.Update(sf::seconds(game::GameManager::FixedPeriod));
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(client.GetGameManager().GetPlayerNumber(), 1);
+
+    host.Stop();
+    hostThread.join();
+    host.Destroy();
+}
+
+TEST(MatchHost, WorkerRecordsItsMatches)
+{
+    using namespace std::chrono_literals;
+    const game::TemporaryFile replayDirectory("");
+    ASSERT_TRUE(std::filesystem::create_directory(replayDirectory.GetPath()));
+    const auto replayPath = std::filesystem::path(replayDirectory.GetPath()) / "match_7_0.replay";
+    {
+        game::MatchWorker worker(12345, 64, replayDirectory.GetPath());
+        worker.Start();
+        game::MatchMessage message;
+        message.type = game::MatchMessage::Type::CREATE_MATCH;
+        message.matchId = hostTestMatchId;
+        message.playerCount = 2;
+        ASSERT_TRUE(worker.GetInbox().Push(std::move(message)));
+        for (int i = 0; i < 1000 && !std::filesystem::exists(replayPath); i++)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        worker.Stop();
+    }
+    EXPECT_TRUE(std::filesystem::exists(replayPath));
+}
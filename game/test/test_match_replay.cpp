@@ -0,0 +1,165 @@
+#include <game/game_manager.h>
+#include <game/match_playback.h>
+#include <game/match_replay.h>
+#include <gtest/gtest.h>
+
+#include "match_fixture.h"
+
+namespace
+{
+    constexpr game::PlayerNumber replayPlayerCount = 2;
+
+    void SpawnTracedMatch(game::GameManager& gameManager, const std::string& path)
+    {
+        ASSERT_TRUE(gameManager.StartMatchReplay(path, game::MatchReplayWriter::STATE_HASHES));
+        game::SpawnMatch(gameManager, replayPlayerCount);
+    }
+
+    game::PlayerInput TraceInput(game::Frame frame, game::PlayerNumber playerNumber)
+    {
+        return ((frame / 5u + playerNumber) % 2u == 0) ? game::PlayerInputEnum::UP : game::PlayerInputEnum::UP | game::PlayerInputEnum::RIGHT;
+    }
+}
+
+TEST(MatchReplay, ReplaysTheRecordedMatch)
+{
+    const game::TemporaryFile replayFile(".replay");
+    const auto& path = replayFile.GetPath();
+    constexpr game::Frame frameCount = 300;
+    constexpr unsigned long long startTime = 1700000000000ull;
+    game::StateHash recordedStateHash;
+    {
+        game::GameManager gameManager;
+        ASSERT_TRUE(gameManager.StartMatchReplay(path));
+        game::SpawnMatch(gameManager, replayPlayerCount);
+        gameManager.SetMatchReplayStartTime(startTime);
+        for (game::Frame frame = 1; frame <= frameCount; frame++)
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < replayPlayerCount; playerNumber++)
+            {
+                gameManager.SetPlayerInput(playerNumber, game::ScriptedInput(frame, playerNumber), frame);
+            }
+            //The server validates several frames at once when the inputs arrive together
+            if (frame % 3 == 0)
+            {
+                gameManager.Validate(frame);
+            }
+        }
+        recordedStateHash = gameManager.GetRollbackManager().GetValidateStateHash();
+    }
+
+    game::MatchReplayReader replay;
+    ASSERT_TRUE(replay.Open(path));
+    EXPECT_EQ(replay.GetPlayerCount(), replayPlayerCount);
+    EXPECT_EQ(replay.GetStartTime(), startTime);
+    EXPECT_TRUE(replay.GetSpawn(1).spawned);
+    EXPECT_FALSE(replay.GetSpawn(2).spawned);
+    EXPECT_FLOAT_EQ(replay.GetSpawn(1).position.x, game::spawnPositions[1].x * 3.0f);
+    EXPECT_FLOAT_EQ(replay.GetSpawn(1).rotation.value(), game::spawnRotations[1].value());
+    ASSERT_EQ(replay.GetFrameCount(), frameCount);
+    ASSERT_EQ(replay.GetFirstFrame(), 1u);
+
+    EXPECT_FALSE(replay.HasStateHashes());
+    for (game::Frame frame = 1; frame <= frameCount; frame++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < replayPlayerCount; playerNumber++)
+        {
+            ASSERT_EQ(replay.GetInputs(frame)[playerNumber], game::ScriptedInput(frame, playerNumber));
+        }
+    }
+
+    game::MatchPlayback playback(replay);
+    playback.Play();
+    EXPECT_EQ(playback.GetFrame(), frameCount);
+    //The released frames are read again from the disk
+    replay.ReleaseFramesBefore(frameCount + 1);
+    EXPECT_EQ(replay.GetInputs(1)[0], game::ScriptedInput(1, 0));
+    EXPECT_EQ(playback.GetRollbackManager().GetValidateStateHash().full, recordedStateHash.full);
+}
+
+TEST(MatchReplay, RecordsTheStateHashOfEveryValidation)
+{
+    const game::TemporaryFile traceFile(".trace");
+    const auto& path = traceFile.GetPath();
+    constexpr game::Frame frameCount = 20;
+    game::StateHash lastStateHash;
+    {
+        game::GameManager gameManager;
+        SpawnTracedMatch(gameManager, path);
+        for (game::Frame frame = 1; frame <= frameCount; frame++)
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < replayPlayerCount; playerNumber++)
+            {
+                gameManager.SetPlayerInput(playerNumber, TraceInput(frame, playerNumber), frame);
+            }
+            //Validating two frames at once only hashes the second one
+            if (frame % 2 == 0)
+            {
+                gameManager.Validate(frame);
+            }
+        }
+        lastStateHash = gameManager.GetRollbackManager().GetValidateStateHash();
+    }
+
+    game::MatchReplayReader trace;
+    ASSERT_TRUE(trace.Open(path));
+    EXPECT_TRUE(trace.HasStateHashes());
+    EXPECT_EQ(trace.GetPlayerCount(), replayPlayerCount);
+    EXPECT_TRUE(trace.GetSpawn(1).spawned);
+    EXPECT_FALSE(trace.GetSpawn(2).spawned);
+    EXPECT_FLOAT_EQ(trace.GetSpawn(1).position.x, game::spawnPositions[1].x * 3.0f);
+    EXPECT_FLOAT_EQ(trace.GetSpawn(1).position.y, game::spawnPositions[1].y * 3.0f);
+    ASSERT_EQ(trace.GetFrameCount(), frameCount);
+    EXPECT_EQ(trace.GetFirstFrame(), 1u);
+    game::StateHash stateHash;
+    for (game::Frame frame = 1; frame <= frameCount; frame++)
+    {
+        EXPECT_EQ(trace.ReadStateHash(frame, stateHash), frame % 2 == 0);
+        EXPECT_EQ(trace.GetInputs(frame)[0], TraceInput(frame, 0));
+        EXPECT_EQ(trace.GetInputs(frame)[1], TraceInput(frame, 1));
+    }
+    EXPECT_FALSE(trace.ReadStateHash(frameCount + 1, stateHash));
+    ASSERT_TRUE(trace.ReadStateHash(frameCount, stateHash));
+    EXPECT_EQ(stateHash.full, lastStateHash.full);
+    EXPECT_EQ(stateHash.parts, lastStateHash.parts);
+}
+
+TEST(MatchReplay, FindsTheFirstDivergentFrame)
+{
+    const game::TemporaryFile traceFile1(".trace");
+    const game::TemporaryFile traceFile2(".trace");
+    const auto& path1 = traceFile1.GetPath();
+    const auto& path2 = traceFile2.GetPath();
+    constexpr game::Frame frameCount = 500;
+    constexpr game::Frame wrongInputFrame = 124;
+    {
+        game::GameManager gameManager1;
+        game::GameManager gameManager2;
+        SpawnTracedMatch(gameManager1, path1);
+        SpawnTracedMatch(gameManager2, path2);
+        for (game::Frame frame = 1; frame <= frameCount; frame++)
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < replayPlayerCount; playerNumber++)
+            {
+                const auto input = TraceInput(frame, playerNumber);
+                gameManager1.SetPlayerInput(playerNumber, input, frame);
+                gameManager2.SetPlayerInput(playerNumber,
+                    frame == wrongInputFrame ? static_cast<game::PlayerInput>(input ^ game::PlayerInputEnum::LEFT) : input, frame);
+            }
+            gameManager1.Validate(frame);
+            //The second trace only hashes every third frame
+            if (frame % 3 == 0 || frame == frameCount)
+            {
+                gameManager2.Validate(frame);
+            }
+        }
+    }
+
+    game::MatchReplayReader trace1;
+    game::MatchReplayReader trace2;
+    ASSERT_TRUE(trace1.Open(path1));
+    ASSERT_TRUE(trace2.Open(path2));
+    //The first frame hashed by both traces after the wrong input
+    EXPECT_EQ(game::FindFirstDivergentFrame(trace1, trace2), 126u);
+    EXPECT_EQ(game::FindFirstDivergentFrame(trace1, trace1), game::INVALID_FRAME);
+}
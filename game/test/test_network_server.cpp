@@ -0,0 +1,161 @@
+#include <engine/headless_engine.h>
+#include <network/bot_client.h>
+#include <network/network_client.h>
+#include <network/network_server.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * \brief Sends the first datagram of a reliable channel carrying a packet that is not a join packet
+     */
+    void SendSpoofedDatagram(sf::UdpSocket& socket, unsigned short serverPort)
+    {
+        game::ReliableChannel channel;
+        game::WinGamePacket winGamePacket;
+        channel.Send(game::SharedPacket(winGamePacket));
+        const auto datagramCount = channel.Update(game::ReliableChannel::Clock::now());
+        for (std::size_t i = 0; i < datagramCount; i++)
+        {
+            const auto& datagram = channel.GetDatagram(i);
+            socket.send(datagram.data(), datagram.size(), sf::IpAddress::LocalHost, serverPort);
+        }
+    }
+
+    /**
+     * \brief Receives the packets of the server every tick and ends the run once every bot has started its match
+     */
+    class BotMatchMonitor : public core::SystemInterface
+    {
+    public:
+        BotMatchMonitor(core::HeadlessEngine& engine, game::ServerNetworkManager& server,
+            const std::vector<std::unique_ptr<game::BotClient>>& bots) :
+            engine_(engine), server_(server), bots_(bots)
+        {
+        }
+        void Init() override {}
+        void Update([[maybe_unused]] sf::Time dt) override
+        {
+            server_.ReceivePackets();
+            if (IsStarted())
+            {
+                engine_.Stop();
+            }
+        }
+        void Destroy() override {}
+        [[nodiscard]] bool IsStarted() const
+        {
+            return std::all_of(bots_.begin(), bots_.end(), [](const auto& bot)
+            {
+                return (bot->GetGameManager().GetState() & game::ClientGameManager::STARTED) != 0;
+            });
+        }
+    private:
+        core::HeadlessEngine& engine_;
+        game::ServerNetworkManager& server_;
+        const std::vector<std::unique_ptr<game::BotClient>>& bots_;
+    };
+}
+
+TEST(NetworkServer, DatagramsWithoutJoinDoNotTakeAPlayerSlot)
+{
+    using namespace std::chrono_literals;
+    game::ServerNetworkManager server;
+    server.SetPort(sf::Socket::AnyPort);
+    server.SetStartDelay(0ms);
+    server.Init();
+
+    //More spoofed addresses than the match has players
+    std::vector<std::unique_ptr<sf::UdpSocket>> spoofedSockets;
+    for (game::PlayerNumber i = 0; i < game::defaultPlayerNmb + 1; i++)
+    {
+        auto& socket = spoofedSockets.emplace_back(std::make_unique<sf::UdpSocket>());
+        ASSERT_EQ(socket->bind(sf::Socket::AnyPort), sf::Socket::Done);
+        SendSpoofedDatagram(*socket, server.GetPort());
+    }
+    std::this_thread::sleep_for(10ms);
+    server.ReceivePackets();
+    EXPECT_TRUE(server.IsOpen());
+
+    std::vector<std::unique_ptr<game::ClientNetworkManager>> clients;
+    for (game::PlayerNumber i = 0; i < game::defaultPlayerNmb; i++)
+    {
+        auto& client = clients.emplace_back(std::make_unique<game::ClientNetworkManager>());
+        client->Init();
+        client->Join(sf::IpAddress::LocalHost, server.GetPort());
+    }
+    const auto isStarted = [](const auto& client)
+    {
+        return (client->GetGameManager().GetState() & game::ClientGameManager::STARTED) != 0;
+    };
+    for (int step = 0; step < 500 && !std::all_of(clients.begin(), clients.end(), isStarted); step++)
+    {
+        for (auto& client : clients)
+        {
+            client->Update(sf::seconds(game::GameManager::FixedPeriod));
+        }
+        server.ReceivePackets();
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_TRUE(std::all_of(clients.begin(), clients.end(), isStarted));
+    EXPECT_TRUE(server.IsOpen());
+}
+
+TEST(NetworkServer, BotsStartTheMatchOnTheHeadlessEngine)
+{
+    using namespace std::chrono_literals;
+    game::ServerNetworkManager server;
+    server.SetPort(sf::Socket::AnyPort);
+    server.SetStartDelay(0ms);
+    server.Init();
+
+    core::HeadlessEngine engine(1.0f / game::GameManager::FixedPeriod);
+    engine.SetRealTime(false);
+    engine.SetRunLimit(500);
+    std::vector<std::unique_ptr<game::BotClient>> bots;
+    for (game::PlayerNumber i = 0; i < game::defaultPlayerNmb; i++)
+    {
+        engine.RegisterSystem(bots.emplace_back(std::make_unique<game::BotClient>(sf::IpAddress::LocalHost, server.GetPort())).get());
+    }
+    BotMatchMonitor monitor(engine, server, bots);
+    engine.RegisterSystem(&monitor);
+    engine.Run();
+
+    EXPECT_TRUE(monitor.IsStarted());
+    EXPECT_LT(engine.GetTickCount(), 500u);
+    EXPECT_TRUE(server.IsOpen());
+}
+
+TEST(NetworkServer, ClientNotAcknowledgingIsDisconnected)
+{
+    game::ServerNetworkManager server;
+    server.SetPort(sf::Socket::AnyPort);
+    //Less than the packets answering a join
+    server.SetMaxQueuedBytes(16);
+    server.Init();
+
+    sf::UdpSocket socket;
+    ASSERT_EQ(socket.bind(sf::Socket::AnyPort), sf::Socket::Done);
+    game::ReliableChannel channel;
+    game::JoinPacket joinPacket;
+    joinPacket.clientId = core::ConvertToBinary<game::ClientId>(1);
+    channel.Send(game::SharedPacket(joinPacket));
+    const auto datagramCount = channel.Update(game::ReliableChannel::Clock::now());
+    for (std::size_t i = 0; i < datagramCount; i++)
+    {
+        socket.send(channel.GetDatagram(i).data(), channel.GetDatagram(i).size(), sf::IpAddress::LocalHost, server.GetPort());
+    }
+    for (int step = 0; step < 100 && server.GetSendQueueStats().overflowDisconnects == 0; step++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        server.ReceivePackets();
+    }
+    EXPECT_EQ(server.GetSendQueueStats().overflowDisconnects, 1u);
+    EXPECT_FALSE(server.IsOpen());
+}
@@ -0,0 +1,263 @@
+#include <network/client.h>
+#include <network/network_client.h>
+#include <network/network_server.h>
+#include <network/server.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "allocation_counter.h"
+
+namespace
+{
+    /**
+     * \brief Loopback link serializing every packet into the same buffer, as the sockets do
+     */
+    class LoopbackLink
+    {
+    public:
+        std::unique_ptr<game::Packet> Transmit(game::Packet& packet)
+        {
+            buffer_.clear();
+            game::GeneratePacket(buffer_, packet);
+            return game::GenerateReceivedPacket(buffer_);
+        }
+    private:
+        sf::Packet buffer_;
+    };
+
+    class LoopbackServer : public game::Server
+    {
+    public:
+        void Init() override { Server::Init(); }
+        void Update([[maybe_unused]] sf::Time dt) override {}
+        void Destroy() override {}
+        void SendReliablePacket(std::unique_ptr<game::Packet> packet) override { sentPackets.push_back(std::move(packet)); }
+        void SendUnreliablePacket(std::unique_ptr<game::Packet> packet) override { sentPackets.push_back(std::move(packet)); }
+        void Receive(std::unique_ptr<game::Packet> packet) { ReceivePacket(std::move(packet)); }
+
+        std::vector<std::unique_ptr<game::Packet>> sentPackets;
+    protected:
+        void SpawnNewPlayer(game::ClientId clientId, game::PlayerNumber playerNumber) override
+        {
+            auto spawnPlayer = std::make_unique<game::SpawnPlayerPacket>();
+            spawnPlayer->clientId = core::ConvertToBinary(clientId);
+            spawnPlayer->playerNumber = playerNumber;
+            const auto pos = game::spawnPositions[playerNumber] * 3.0f;
+            spawnPlayer->pos = core::ConvertToBinary(pos);
+            spawnPlayer->angle = core::ConvertToBinary(game::spawnRotations[playerNumber]);
+            gameManager_.SpawnPlayer(playerNumber, pos, game::spawnRotations[playerNumber]);
+            SendReliablePacket(std::move(spawnPlayer));
+        }
+    };
+
+    class LoopbackClient : public game::Client
+    {
+    public:
+        explicit LoopbackClient(game::ClientId clientId) { clientId_ = clientId; }
+        void Init() override { gameManager_.Init(); }
+        void Update(sf::Time dt) override { gameManager_.Update(dt); }
+        void Destroy() override {}
+        void Draw([[maybe_unused]] sf::RenderTarget& renderTarget) override {}
+        void DrawImGui() override {}
+        void SendReliablePacket(std::unique_ptr<game::Packet> packet) override { sentPackets.push_back(std::move(packet)); }
+        void SendUnreliablePacket(std::unique_ptr<game::Packet> packet) override { sentPackets.push_back(std::move(packet)); }
+
+        void Join()
+        {
+            auto joinPacket = std::make_unique<game::JoinPacket>();
+            joinPacket->clientId = core::ConvertToBinary(clientId_);
+            SendReliablePacket(std::move(joinPacket));
+        }
+        //Skips the start countdown
+        void Start() { gameManager_.StartGame(1); }
+        void SetPlayerInput(game::PlayerInput input)
+        {
+            gameManager_.SetPlayerInput(gameManager_.GetPlayerNumber(), input, gameManager_.GetCurrentFrame());
+        }
+        [[nodiscard]] game::Frame GetLastValidateFrame() const { return gameManager_.GetLastValidateFrame(); }
+
+        std::vector<std::unique_ptr<game::Packet>> sentPackets;
+    };
+
+    class LoopbackMatch
+    {
+    public:
+        LoopbackMatch()
+        {
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::defaultPlayerNmb; playerNumber++)
+            {
+                clients_.push_back(std::make_unique<LoopbackClient>(playerNumber + 1u));
+            }
+            server_.Init();
+            for (auto& client : clients_)
+            {
+                client->Init();
+                client->Join();
+            }
+            Step(0);
+            for (auto& client : clients_)
+            {
+                client->Start();
+            }
+        }
+
+        void Step(game::Frame frame)
+        {
+            for (std::size_t i = 0; i < clients_.size(); i++)
+            {
+                //Turning left and right changes the inputs often enough to rollback
+                clients_[i]->SetPlayerInput((frame / 5u + i) % 2u == 0 ?
+                    game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT);
+                clients_[i]->Update(sf::seconds(game::GameManager::FixedPeriod * 1.01f));
+                for (auto& packet : clients_[i]->sentPackets)
+                {
+                    server_.Receive(link_.Transmit(*packet));
+                }
+                clients_[i]->sentPackets.clear();
+            }
+            for (auto& packet : server_.sentPackets)
+            {
+                for (auto& client : clients_)
+                {
+                    const auto receivedPacket = link_.Transmit(*packet);
+                    client->ReceivePacket(receivedPacket.get());
+                }
+            }
+            server_.sentPackets.clear();
+        }
+
+        [[nodiscard]] const std::vector<std::unique_ptr<LoopbackClient>>& GetClients() const { return clients_; }
+    private:
+        LoopbackServer server_;
+        //The client game manager keeps a reference to its client, so the clients do not move
+        std::vector<std::unique_ptr<LoopbackClient>> clients_;
+        LoopbackLink link_;
+    };
+
+    /**
+     * \brief Match played by the network managers over the loopback interface, with the reliable channels and the batched sockets
+     */
+    class SocketMatch
+    {
+    public:
+        SocketMatch()
+        {
+            using namespace std::chrono_literals;
+            server_.SetPort(sf::Socket::AnyPort);
+            server_.SetStartDelay(0ms);
+            server_.Init();
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::defaultPlayerNmb; playerNumber++)
+            {
+                auto& client = clients_.emplace_back(std::make_unique<game::ClientNetworkManager>());
+                client->Init();
+                client->Join(sf::IpAddress::LocalHost, server_.GetPort());
+            }
+        }
+
+        void Step(game::Frame frame)
+        {
+            for (std::size_t i = 0; i < clients_.size(); i++)
+            {
+                if (IsStarted(*clients_[i]))
+                {
+                    clients_[i]->SetPlayerInput((frame / 5u + i) % 2u == 0 ?
+                        game::PlayerInputEnum::LEFT : game::PlayerInputEnum::RIGHT);
+                }
+                clients_[i]->Update(sf::seconds(game::GameManager::FixedPeriod * 1.01f));
+            }
+            server_.ReceivePackets();
+        }
+
+        [[nodiscard]] bool IsStarted() const
+        {
+            return std::all_of(clients_.begin(), clients_.end(), [](const auto& client) { return IsStarted(*client); });
+        }
+        [[nodiscard]] const std::vector<std::unique_ptr<game::ClientNetworkManager>>& GetClients() const { return clients_; }
+    private:
+        static bool IsStarted(const game::ClientNetworkManager& client)
+        {
+            return client.GetGameManager().GetState() & game::ClientGameManager::STARTED;
+        }
+        game::ServerNetworkManager server_;
+        std::vector<std::unique_ptr<game::ClientNetworkManager>> clients_;
+    };
+}
+
+TEST(PacketAllocation, PacketSlotsAreRecycled)
+{
+    LoopbackLink link;
+    for (int i = 0; i < 2; i++)
+    {
+        auto inputPacket = std::make_unique<game::PlayerInputPacket>();
+        inputPacket->playerNumber = 0;
+        inputPacket->inputCount = 3;
+        const auto receivedPacket = link.Transmit(*inputPacket);
+        ASSERT_NE(receivedPacket, nullptr);
+        EXPECT_EQ(receivedPacket->packetType, game::PacketType::INPUT);
+    }
+
+    const auto allocationsBefore = game::GetAllocationCount();
+    for (int i = 0; i < 100; i++)
+    {
+        auto inputPacket = std::make_unique<game::PlayerInputPacket>();
+        inputPacket->playerNumber = 0;
+        inputPacket->inputCount = 3;
+        const auto receivedPacket = link.Transmit(*inputPacket);
+    }
+    EXPECT_EQ(game::GetAllocationCount() - allocationsBefore, 0u);
+}
+
+TEST(PacketAllocation, SteadyStateFrames)
+{
+    LoopbackMatch match;
+    //Warm until every frame snapshot of the rollback window was saved once
+    constexpr game::Frame warmFrames = game::windowBufferSize + 50;
+    game::Frame frame = 1;
+    for (; frame < warmFrames; frame++)
+    {
+        match.Step(frame);
+    }
+
+    const auto allocationsBefore = game::GetAllocationCount();
+    for (; frame < warmFrames + 200; frame++)
+    {
+        match.Step(frame);
+    }
+    EXPECT_EQ(game::GetAllocationCount() - allocationsBefore, 0u);
+    for (const auto& client : match.GetClients())
+    {
+        EXPECT_GT(client->GetLastValidateFrame(), warmFrames);
+    }
+}
+
+TEST(PacketAllocation, SteadyStateFramesThroughTheSockets)
+{
+    SocketMatch match;
+    game::Frame frame = 0;
+    for (; frame < 500 && !match.IsStarted(); frame++)
+    {
+        match.Step(frame);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(match.IsStarted());
+    const auto warmFrames = frame + game::windowBufferSize + 50;
+    for (; frame < warmFrames; frame++)
+    {
+        match.Step(frame);
+    }
+
+    const auto allocationsBefore = game::GetAllocationCount();
+    for (; frame < warmFrames + 200; frame++)
+    {
+        match.Step(frame);
+    }
+    EXPECT_EQ(game::GetAllocationCount() - allocationsBefore, 0u);
+    for (const auto& client : match.GetClients())
+    {
+        EXPECT_GT(client->GetGameManager().GetLastValidateFrame(), game::Frame(game::windowBufferSize));
+    }
+}
@@ -0,0 +1,214 @@
+#include <network/reliable_channel.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Clock = game::ReliableChannel::Clock;
+
+    /**
+     * \brief Loopback between two channels losing, duplicating and reordering the datagrams
+     */
+    class LossyLoopback
+    {
+    public:
+        LossyLoopback(float lossRate, float duplicateRate, Clock::duration maxDelay) :
+            lossRate_(lossRate), duplicateRate_(duplicateRate), maxDelay_(maxDelay)
+        {
+        }
+
+        void Step(Clock::duration dt)
+        {
+            now_ += dt;
+            SendDatagrams(sides_[0], 1);
+            SendDatagrams(sides_[1], 0);
+            for (auto it = inFlight_.begin(); it != inFlight_.end();)
+            {
+                if (it->arrivalTime > now_)
+                {
+                    ++it;
+                    continue;
+                }
+                sides_[it->destination].ReceiveDatagram(it->bytes.data(), it->bytes.size(), now_);
+                it = inFlight_.erase(it);
+            }
+        }
+
+        [[nodiscard]] game::ReliableChannel& GetSide(std::size_t side) { return sides_[side]; }
+        [[nodiscard]] Clock::time_point GetNow() const { return now_; }
+    private:
+        struct InFlightDatagram
+        {
+            std::vector<std::uint8_t> bytes;
+            Clock::time_point arrivalTime;
+            std::size_t destination = 0;
+        };
+
+        void SendDatagrams(game::ReliableChannel& channel, std::size_t destination)
+        {
+            const auto datagramCount = channel.Update(now_);
+            for (std::size_t i = 0; i < datagramCount; i++)
+            {
+                const auto copyCount = random_(0.0f, 1.0f) < duplicateRate_ ? 2 : 1;
+                for (int copy = 0; copy < copyCount; copy++)
+                {
+                    if (random_(0.0f, 1.0f) < lossRate_)
+                        continue;
+                    const auto delay = std::chrono::duration_cast<Clock::duration>(maxDelay_ * random_(0.0f, 1.0f));
+                    inFlight_.push_back({ channel.GetDatagram(i), now_ + delay, destination });
+                }
+            }
+        }
+
+        struct Random
+        {
+            float operator()(float min, float max) { return std::uniform_real_distribution<float>(min, max)(engine); }
+            std::mt19937 engine{ 42 };
+        };
+
+        game::ReliableChannel sides_[2];
+        std::vector<InFlightDatagram> inFlight_;
+        //The channels take the default time point as never
+        Clock::time_point now_ = Clock::time_point{} + std::chrono::seconds(1);
+        Random random_;
+        float lossRate_;
+        float duplicateRate_;
+        Clock::duration maxDelay_;
+    };
+
+    game::SharedPacket CreateJoinPacket(game::ClientId clientId)
+    {
+        game::JoinPacket joinPacket;
+        joinPacket.clientId = core::ConvertToBinary(clientId);
+        return game::SharedPacket(joinPacket);
+    }
+
+    void PopClientIds(game::ReliableChannel& channel, std::vector<game::ClientId>& clientIds)
+    {
+        sf::Packet packet;
+        while (channel.PopPacket(packet))
+        {
+            const auto receivedPacket = game::GenerateReceivedPacket(packet);
+            ASSERT_NE(receivedPacket, nullptr);
+            ASSERT_EQ(receivedPacket->packetType, game::PacketType::JOIN);
+            clientIds.push_back(core::ConvertFromBinary<game::ClientId>(
+                static_cast<const game::JoinPacket*>(receivedPacket.get())->clientId));
+        }
+    }
+}
+
+TEST(ReliableChannel, DeliversInOrderOverLossyLink)
+{
+    LossyLoopback loopback(0.3f, 0.05f, std::chrono::milliseconds(60));
+    constexpr game::ClientId messageCount = 500;
+    for (game::ClientId i = 0; i < messageCount; i++)
+    {
+        loopback.GetSide(0).Send(CreateJoinPacket(i));
+        loopback.GetSide(1).Send(CreateJoinPacket(messageCount - i));
+    }
+
+    std::vector<game::ClientId> received[2];
+    for (int step = 0; step < 10000 && (received[0].size() < messageCount || received[1].size() < messageCount); step++)
+    {
+        loopback.Step(std::chrono::milliseconds(10));
+        PopClientIds(loopback.GetSide(0), received[0]);
+        PopClientIds(loopback.GetSide(1), received[1]);
+    }
+
+    ASSERT_EQ(received[1].size(), messageCount);
+    ASSERT_EQ(received[0].size(), messageCount);
+    for (game::ClientId i = 0; i < messageCount; i++)
+    {
+        EXPECT_EQ(received[1][i], i);
+        EXPECT_EQ(received[0][i], messageCount - i);
+    }
+    //All acknowledged once the acks of the last messages went through
+    for (int step = 0; step < 1000; step++)
+    {
+        loopback.Step(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(loopback.GetSide(0).GetPendingCount(), 0u);
+    EXPECT_EQ(loopback.GetSide(1).GetPendingCount(), 0u);
+    EXPECT_GT(loopback.GetSide(0).GetResendCount(), 0u);
+}
+
+TEST(ReliableChannel, ResendsUntilTimeout)
+{
+    game::ReliableChannel channel;
+    channel.SetResendDelay(std::chrono::milliseconds(100));
+    channel.SetTimeout(std::chrono::seconds(1));
+    auto now = Clock::time_point{} + std::chrono::seconds(1);
+    channel.Send(CreateJoinPacket(7));
+
+    //Nothing ever comes back, the send itself never waits
+    ASSERT_EQ(channel.Update(now), 1u);
+    now += std::chrono::milliseconds(50);
+    EXPECT_EQ(channel.Update(now), 0u);
+    now += std::chrono::milliseconds(60);
+    EXPECT_EQ(channel.Update(now), 1u);
+    EXPECT_EQ(channel.GetResendCount(), 1u);
+    EXPECT_EQ(channel.GetPendingCount(), 1u);
+    EXPECT_FALSE(channel.IsTimedOut(now));
+    now += std::chrono::seconds(1);
+    EXPECT_TRUE(channel.IsTimedOut(now));
+}
+
+TEST(ReliableChannel, UnreliablePacketsAreNotChannelDatagrams)
+{
+    sf::Packet packet;
+    game::PlayerInputPacket inputPacket;
+    game::GeneratePacket(packet, inputPacket);
+    EXPECT_FALSE(game::ReliableChannel::IsChannelDatagram(
+        static_cast<const std::uint8_t*>(packet.getData()), packet.getDataSize()));
+
+    game::ReliableChannel channel;
+    ASSERT_EQ(channel.Update(Clock::time_point{} + std::chrono::seconds(1)), 1u);
+    const auto& keepAlive = channel.GetDatagram(0);
+    EXPECT_TRUE(game::ReliableChannel::IsChannelDatagram(keepAlive.data(), keepAlive.size()));
+}
+
+TEST(ReliableChannel, QueuedBytesFollowTheAcks)
+{
+    LossyLoopback loopback(0.0f, 0.0f, Clock::duration::zero());
+    auto& sender = loopback.GetSide(0);
+    const auto packetSize = CreateJoinPacket(0).GetSize();
+    constexpr game::ClientId messageCount = game::ReliableChannel::windowSize + 8;
+    for (game::ClientId i = 0; i < messageCount; i++)
+    {
+        sender.Send(CreateJoinPacket(i));
+    }
+    EXPECT_EQ(sender.GetQueuedBytes(), messageCount * packetSize);
+    EXPECT_TRUE(sender.IsWindowFull());
+
+    std::vector<game::ClientId> received;
+    for (int step = 0; step < 10; step++)
+    {
+        loopback.Step(std::chrono::milliseconds(10));
+        PopClientIds(loopback.GetSide(1), received);
+    }
+    EXPECT_EQ(received.size(), messageCount);
+    EXPECT_EQ(sender.GetQueuedBytes(), 0u);
+    EXPECT_FALSE(sender.IsWindowFull());
+}
+
+TEST(ReliableChannel, OverflowedChannelRefusesEveryPacket)
+{
+    game::ReliableChannel channel;
+    const auto packetSize = CreateJoinPacket(0).GetSize();
+    channel.SetMaxQueuedBytes(3 * packetSize);
+    for (game::ClientId i = 0; i < 3; i++)
+    {
+        EXPECT_TRUE(channel.Send(CreateJoinPacket(i)));
+    }
+    EXPECT_FALSE(channel.IsOverflowed());
+    EXPECT_FALSE(channel.Send(CreateJoinPacket(3)));
+    EXPECT_TRUE(channel.IsOverflowed());
+    EXPECT_EQ(channel.GetQueuedBytes(), 3 * packetSize);
+
+    //The stream has a hole, even a packet that fits is refused
+    channel.SetMaxQueuedBytes(100 * packetSize);
+    EXPECT_FALSE(channel.Send(CreateJoinPacket(4)));
+    EXPECT_EQ(channel.GetPendingCount(), 3u);
+}
@@ -0,0 +1,146 @@
+#include <game/game_manager.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "match_fixture.h"
+
+namespace
+{
+    constexpr game::PlayerNumber rollbackPlayerCount = 2;
+
+    /**
+     * \brief Game manager predicting the missing inputs like a client, without the client rendering and packets
+     */
+    class PredictingGameManager : public game::GameManager
+    {
+    public:
+        PredictingGameManager()
+        {
+            game::SpawnMatch(*this, rollbackPlayerCount);
+        }
+        void SimulateFrame(game::Frame frame)
+        {
+            currentFrame_ = frame;
+            rollbackManager_.StartNewFrame(frame);
+            rollbackManager_.SimulateToCurrentFrame();
+        }
+    };
+
+    /**
+     * \brief The second player holds its input of the validated frame, then changes it from changeFrame
+     */
+    game::PlayerInput LateInput(game::Frame frame, game::Frame validatedFrame, game::Frame changeFrame)
+    {
+        if (frame >= changeFrame)
+            return game::PlayerInputEnum::UP | game::PlayerInputEnum::RIGHT;
+        return game::ScriptedInput(std::min(frame, validatedFrame), 1);
+    }
+}
+
+TEST(RollbackManager, PartialRollbackMatchesAFullResimulation)
+{
+    constexpr game::Frame validatedFrame = 10;
+    constexpr game::Frame changeFrame = 20;
+    constexpr game::Frame lastFrame = 30;
+
+    //The second player inputs arrive late, the prediction is right until changeFrame
+    PredictingGameManager predicted;
+    for (game::Frame frame = 1; frame <= lastFrame; frame++)
+    {
+        predicted.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        if (frame <= validatedFrame)
+        {
+            predicted.SetPlayerInput(1, game::ScriptedInput(frame, 1), frame);
+        }
+        predicted.SimulateFrame(frame);
+        if (frame == validatedFrame)
+        {
+            predicted.Validate(validatedFrame);
+        }
+    }
+    const auto framesResimulated = predicted.GetRollbackManager().GetFramesResimulated();
+    for (game::Frame frame = validatedFrame + 1; frame <= lastFrame; frame++)
+    {
+        predicted.SetPlayerInput(1, LateInput(frame, validatedFrame, changeFrame), frame);
+    }
+    predicted.SimulateFrame(lastFrame);
+    //Only the frames from the late input are simulated again, from the snapshot of the frame before
+    EXPECT_EQ(predicted.GetRollbackManager().GetFramesResimulated() - framesResimulated, lastFrame - changeFrame + 1);
+    predicted.Validate(lastFrame);
+
+    //Validating without simulating first simulates everything again from the last validated frame
+    PredictingGameManager resimulated;
+    for (game::Frame frame = 1; frame <= lastFrame; frame++)
+    {
+        resimulated.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        resimulated.SetPlayerInput(1, LateInput(frame, validatedFrame, changeFrame), frame);
+        if (frame == validatedFrame)
+        {
+            resimulated.Validate(validatedFrame);
+        }
+    }
+    resimulated.Validate(lastFrame);
+
+    const auto predictedHash = predicted.GetRollbackManager().GetValidateStateHash();
+    const auto resimulatedHash = resimulated.GetRollbackManager().GetValidateStateHash();
+    EXPECT_EQ(predictedHash.full, resimulatedHash.full);
+    EXPECT_EQ(predictedHash.parts, resimulatedHash.parts);
+}
+
+TEST(RollbackManager, CorrectlyPredictedInputsDoNotRollback)
+{
+    constexpr game::Frame validatedFrame = 10;
+    constexpr game::Frame lastFrame = 20;
+    PredictingGameManager gameManager;
+    for (game::Frame frame = 1; frame <= lastFrame; frame++)
+    {
+        gameManager.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        if (frame <= validatedFrame)
+        {
+            gameManager.SetPlayerInput(1, game::ScriptedInput(frame, 1), frame);
+        }
+        gameManager.SimulateFrame(frame);
+    }
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    const auto framesResimulated = rollbackManager.GetFramesResimulated();
+    const auto rollbacksAvoided = rollbackManager.GetRollbacksAvoided();
+    //The late inputs are the ones the second player was predicted to hold
+    for (game::Frame frame = validatedFrame + 1; frame <= lastFrame + 1; frame++)
+    {
+        gameManager.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        gameManager.SetPlayerInput(1, game::ScriptedInput(validatedFrame, 1), frame);
+    }
+    gameManager.SimulateFrame(lastFrame + 1);
+    EXPECT_EQ(rollbackManager.GetFramesResimulated(), framesResimulated);
+    EXPECT_EQ(rollbackManager.GetRollbacksAvoided(), rollbacksAvoided + 1);
+}
+
+TEST(RollbackManager, MispredictedInputResimulatesFromTheDirtyFrame)
+{
+    constexpr game::Frame validatedFrame = 10;
+    constexpr game::Frame changeFrame = 15;
+    constexpr game::Frame lastFrame = 20;
+    PredictingGameManager gameManager;
+    for (game::Frame frame = 1; frame <= lastFrame; frame++)
+    {
+        gameManager.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        if (frame <= validatedFrame)
+        {
+            gameManager.SetPlayerInput(1, game::ScriptedInput(frame, 1), frame);
+        }
+        gameManager.SimulateFrame(frame);
+    }
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    const auto framesResimulated = rollbackManager.GetFramesResimulated();
+    const auto rollbacksAvoided = rollbackManager.GetRollbacksAvoided();
+    for (game::Frame frame = validatedFrame + 1; frame <= lastFrame + 1; frame++)
+    {
+        gameManager.SetPlayerInput(0, game::ScriptedInput(frame, 0), frame);
+        gameManager.SetPlayerInput(1, LateInput(frame, validatedFrame, changeFrame), frame);
+    }
+    gameManager.SimulateFrame(lastFrame + 1);
+    //Frames changeFrame to lastFrame are simulated again, the new frame is simulated once
+    EXPECT_EQ(rollbackManager.GetFramesResimulated() - framesResimulated, lastFrame - changeFrame + 1);
+    EXPECT_EQ(rollbackManager.GetRollbacksAvoided(), rollbacksAvoided);
+}
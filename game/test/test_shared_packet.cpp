@@ -0,0 +1,67 @@
+#include <network/shared_packet.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(SharedPacket, SameBytesAsPacket)
+{
+    game::WinGamePacket winGamePacket;
+    winGamePacket.winner = 3;
+    sf::Packet packet;
+    game::GeneratePacket(packet, winGamePacket);
+
+    const game::SharedPacket sharedPacket(winGamePacket);
+    ASSERT_EQ(sharedPacket.GetSize(), packet.getDataSize());
+    EXPECT_EQ(std::memcmp(sharedPacket.GetData(), packet.getData(), packet.getDataSize()), 0);
+
+    sf::Packet receivedPacket;
+    receivedPacket.append(sharedPacket.GetData(), sharedPacket.GetSize());
+    const auto received = game::GenerateReceivedPacket(receivedPacket);
+    ASSERT_NE(received, nullptr);
+    ASSERT_EQ(received->packetType, game::PacketType::WIN_GAME);
+    EXPECT_EQ(static_cast<const game::WinGamePacket&>(*received).winner, 3);
+}
+
+TEST(SharedPacket, CopiesShareTheBuffer)
+{
+    game::WinGamePacket winGamePacket;
+    winGamePacket.winner = 1;
+    game::SharedPacket copy;
+    EXPECT_TRUE(copy.IsEmpty());
+    {
+        const game::SharedPacket sharedPacket(winGamePacket);
+        copy = sharedPacket;
+        EXPECT_EQ(copy.GetData(), sharedPacket.GetData());
+    }
+    //The copy keeps the buffer alive
+    ASSERT_FALSE(copy.IsEmpty());
+    EXPECT_EQ(copy.GetData()[1], 1);
+
+    game::SharedPacket moved(std::move(copy));
+    EXPECT_TRUE(copy.IsEmpty());
+    EXPECT_FALSE(moved.IsEmpty());
+}
+
+TEST(SharedPacket, BuffersReleasedByAnotherThreadGoBackToTheirPool)
+{
+    //More buffers than the other tests leave in the pool of this thread, so that it runs out of them
+    constexpr std::size_t packetCount = 1024;
+    game::WinGamePacket winGamePacket;
+    std::vector<game::SharedPacket> sharedPackets;
+    std::set<const std::uint8_t*> buffers;
+    for (std::size_t i = 0; i < packetCount; i++)
+    {
+        buffers.insert(sharedPackets.emplace_back(winGamePacket).GetData());
+    }
+    //Released by the network thread, like the packets of a match worker
+    std::thread releasingThread([&sharedPackets] { sharedPackets.clear(); });
+    releasingThread.join();
+
+    for (std::size_t i = 0; i < packetCount; i++)
+    {
+        EXPECT_EQ(buffers.count(sharedPackets.emplace_back(winGamePacket).GetData()), 1u);
+    }
+}
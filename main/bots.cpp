@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/headless_engine.h"
+#include "engine/system.h"
+#include "network/bot_client.h"
+
+namespace game
+{
+    /**
+     * \brief Ends the run once every bot has finished its match
+     */
+    class BotMonitor : public core::SystemInterface
+    {
+    public:
+        BotMonitor(core::HeadlessEngine& engine, const std::vector<std::unique_ptr<BotClient>>& bots) :
+            engine_(engine), bots_(bots)
+        {
+        }
+        void Init() override {}
+        void Update([[maybe_unused]] sf::Time dt) override
+        {
+            if (std::all_of(bots_.begin(), bots_.end(), [](const auto& bot) { return bot->IsFinished(); }))
+            {
+                engine_.Stop();
+            }
+        }
+        void Destroy() override {}
+    private:
+        core::HeadlessEngine& engine_;
+        const std::vector<std::unique_ptr<BotClient>>& bots_;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    std::string serverAddress = "localhost";
+    unsigned short serverPort = 12345;
+    std::size_t botCount = game::defaultPlayerNmb;
+    game::MatchId matchId = 0;
+    if (argc >= 2)
+    {
+        serverAddress = argv[1];
+    }
+    if (argc >= 3)
+    {
+        std::string portArg = argv[2];
+        serverPort = std::stoi(portArg);
+    }
+    if (argc >= 4)
+    {
+        std::string botCountArg = argv[3];
+        botCount = std::stoul(botCountArg);
+    }
+    if (argc >= 5)
+    {
+        std::string matchArg = argv[4];
+        matchId = static_cast<game::MatchId>(std::stoul(matchArg));
+    }
+    //No window, the bots run at the rate of the simulation
+    core::HeadlessEngine engine(1.0f / game::GameManager::FixedPeriod);
+    const sf::IpAddress serverIpAddress(serverAddress);
+    std::vector<std::unique_ptr<game::BotClient>> bots;
+    for (std::size_t i = 0; i < botCount; i++)
+    {
+        engine.RegisterSystem(bots.emplace_back(std::make_unique<game::BotClient>(serverIpAddress, serverPort, matchId)).get());
+    }
+    game::BotMonitor monitor(engine, bots);
+    engine.RegisterSystem(&monitor);
+    engine.Run();
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include <string>
 
 #include "engine/engine.h"
 #include "engine/system.h"
@@ -14,6 +15,7 @@ namespace game
         {
             windowSize_ = core::windowSize;
             client_.SetWindowSize(windowSize_);
+            client_.LoadResources();
             client_.Init();
         }
 
@@ -57,16 +59,25 @@ namespace game
             client_.Draw(window);
         }
 
+        bool StartDesyncTrace(const std::string& path)
+        {
+            return client_.StartDesyncTrace(path);
+        }
+
     private:
         sf::Vector2u windowSize_;
         ClientNetworkManager client_;
     };
 }
 
-int main()
+int main(int argc, char** argv)
 {
     core::Engine engine;
     game::ClientApp app;
+    if (argc >= 2)
+    {
+        app.StartDesyncTrace(argv[1]);
+    }
     engine.RegisterSystem(&app);
     engine.RegisterDraw(&app);
     engine.RegisterDrawImGui(&app);
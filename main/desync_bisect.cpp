@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "game/game_manager.h"
+#include "game/match_playback.h"
+#include "game/match_replay.h"
+
+namespace
+{
+    template<typename T>
+    void PrintFieldDiff(core::Entity entity, const char* field, const T& value1, const T& value2)
+    {
+        if (value1 != value2)
+        {
+            fmt::print("  entity {} {}: {} != {}\n", entity, field, value1, value2);
+        }
+    }
+
+    void PrintScalarDiff(core::Entity entity, const char* field, game::Scalar value1, game::Scalar value2)
+    {
+        if (value1 != value2)
+        {
+            fmt::print("  entity {} {}: {} != {}\n", entity, field, core::ToFloat(value1), core::ToFloat(value2));
+        }
+    }
+
+    void PrintBoxBodyDiff(core::Entity entity, const game::BoxBody& body1, const game::BoxBody& body2)
+    {
+        PrintScalarDiff(entity, "BoxBody.position.x", body1.position.x, body2.position.x);
+        PrintScalarDiff(entity, "BoxBody.position.y", body1.position.y, body2.position.y);
+        PrintScalarDiff(entity, "BoxBody.velocity.x", body1.velocity.x, body2.velocity.x);
+        PrintScalarDiff(entity, "BoxBody.velocity.y", body1.velocity.y, body2.velocity.y);
+        PrintScalarDiff(entity, "BoxBody.angularVelocity", body1.angularVelocity.value(), body2.angularVelocity.value());
+        PrintScalarDiff(entity, "BoxBody.rotation", body1.rotation.value(), body2.rotation.value());
+        PrintScalarDiff(entity, "BoxBody.extends.x", body1.extends.x, body2.extends.x);
+        PrintScalarDiff(entity, "BoxBody.extends.y", body1.extends.y, body2.extends.y);
+        PrintFieldDiff(entity, "BoxBody.bodyType", static_cast<int>(body1.bodyType), static_cast<int>(body2.bodyType));
+    }
+
+    void PrintPlayerCharacterDiff(core::Entity entity, const game::PlayerCharacter& player1, const game::PlayerCharacter& player2)
+    {
+        PrintFieldDiff(entity, "PlayerCharacter.input", static_cast<int>(player1.input), static_cast<int>(player2.input));
+        PrintFieldDiff(entity, "PlayerCharacter.playerNumber", static_cast<int>(player1.playerNumber), static_cast<int>(player2.playerNumber));
+        PrintFieldDiff(entity, "PlayerCharacter.winCount", player1.winCount, player2.winCount);
+    }
+
+    /**
+     * \brief Prints the fields of the validated states that differ, entity by entity
+     */
+    void PrintStateDiff(const game::RollbackManager& rollback1, const game::RollbackManager& rollback2)
+    {
+        const auto& physics1 = rollback1.GetLastValidatePhysicsManager();
+        const auto& physics2 = rollback2.GetLastValidatePhysicsManager();
+        if (physics1.GetEntities() != physics2.GetEntities())
+        {
+            fmt::print("  the box bodies do not belong to the same entities\n");
+        }
+        for (const auto entity : physics1.GetEntities())
+        {
+            if (std::find(physics2.GetEntities().begin(), physics2.GetEntities().end(), entity) != physics2.GetEntities().end())
+            {
+                PrintBoxBodyDiff(entity, physics1.GetBody(entity), physics2.GetBody(entity));
+            }
+        }
+
+        const auto& players1 = rollback1.GetLastValidatePlayerManager();
+        const auto& players2 = rollback2.GetLastValidatePlayerManager();
+        if (players1.GetEntities() != players2.GetEntities())
+        {
+            fmt::print("  the player characters do not belong to the same entities\n");
+        }
+        for (const auto entity : players1.GetEntities())
+        {
+            if (std::find(players2.GetEntities().begin(), players2.GetEntities().end(), entity) != players2.GetEntities().end())
+            {
+                PrintPlayerCharacterDiff(entity, players1.GetComponent(entity), players2.GetComponent(entity));
+            }
+        }
+    }
+
+    void PrintInputDiff(game::Frame frame, const game::PlayerInput* inputs1, const game::PlayerInput* inputs2, game::PlayerNumber playerCount)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < playerCount; playerNumber++)
+        {
+            if (inputs1[playerNumber] != inputs2[playerNumber])
+            {
+                fmt::print("  frame {} P{} input: {:#04x} != {:#04x}\n", frame, playerNumber + 1,
+                    inputs1[playerNumber], inputs2[playerNumber]);
+            }
+        }
+    }
+
+    void PrintRecordedDeviation(const char* name, const game::MatchReplayReader& trace, game::Frame frame,
+        const game::StateHash& replayHash, bool& reported)
+    {
+        game::StateHash recordedHash;
+        if (reported || !trace.ReadStateHash(frame, recordedHash) || recordedHash.full == replayHash.full)
+            return;
+        fmt::print("The replay of {} deviates from its recording at frame {}, the recording machine was not deterministic\n",
+            name, frame);
+        reported = true;
+    }
+}
+
+/**
+ * \brief Finds the first frame where two desync traces of the same match diverge and prints what differs.
+ * The desync traces are match replays recorded with the state hashes. They are streamed: the divergent frame is binary
+ * searched through the mappings, then both traces are replayed headless up to it, so multi-hour traces never need to fit in memory.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fmt::print("Usage: desync_bisect <trace1> <trace2>\n");
+        return 1;
+    }
+    game::MatchReplayReader trace1;
+    game::MatchReplayReader trace2;
+    if (!trace1.Open(argv[1]) || !trace2.Open(argv[2]))
+    {
+        fmt::print("Could not open the traces\n");
+        return 1;
+    }
+    if (!trace1.HasStateHashes() || !trace2.HasStateHashes())
+    {
+        fmt::print("The traces must be recorded with the state hashes\n");
+        return 1;
+    }
+    if (trace1.GetPlayerCount() != trace2.GetPlayerCount())
+    {
+        fmt::print("The traces do not have the same player count: {} != {}\n", trace1.GetPlayerCount(), trace2.GetPlayerCount());
+        return 1;
+    }
+    const auto playerCount = trace1.GetPlayerCount();
+
+    const auto divergentFrame = game::FindFirstDivergentFrame(trace1, trace2);
+    if (divergentFrame == game::INVALID_FRAME)
+    {
+        fmt::print("The {} and {} recorded frames agree\n", trace1.GetFrameCount(), trace2.GetFrameCount());
+        return 0;
+    }
+    game::StateHash stateHash1;
+    game::StateHash stateHash2;
+    trace1.ReadStateHash(divergentFrame, stateHash1);
+    trace2.ReadStateHash(divergentFrame, stateHash2);
+    fmt::print("First divergent hash at frame {}: {:016x} != {:016x}\n", divergentFrame, stateHash1.full, stateHash2.full);
+    static constexpr std::array<const char*, game::StateHash::PART_COUNT> partNames{ "BoxBody", "PlayerCharacter" };
+    for (std::size_t part = 0; part < game::StateHash::PART_COUNT; part++)
+    {
+        if (stateHash1.parts[part] != stateHash2.parts[part])
+        {
+            fmt::print("  {} diverged\n", partNames[part]);
+        }
+    }
+
+    if (trace1.GetFirstFrame() != 1 || trace2.GetFirstFrame() != 1)
+    {
+        fmt::print("The traces do not start at the first frame of the match, they cannot be replayed\n");
+        return 0;
+    }
+    //Replays both traces frame by frame to find the exact frame the states diverge, the recorded hashes only exist
+    //for the frames ending a validation
+    game::MatchPlayback playback1(trace1);
+    game::MatchPlayback playback2(trace2);
+    bool reported1 = false;
+    bool reported2 = false;
+    for (game::Frame frame = 1; frame <= divergentFrame; frame++)
+    {
+        PrintInputDiff(frame, trace1.GetInputs(frame), trace2.GetInputs(frame), playerCount);
+        if (!playback1.Step() || !playback2.Step())
+        {
+            fmt::print("The traces are truncated at frame {}\n", frame);
+            return 1;
+        }
+        const auto replayHash1 = playback1.GetRollbackManager().GetValidateStateHash();
+        const auto replayHash2 = playback2.GetRollbackManager().GetValidateStateHash();
+        PrintRecordedDeviation(argv[1], trace1, frame, replayHash1, reported1);
+        PrintRecordedDeviation(argv[2], trace2, frame, replayHash2, reported2);
+        if (replayHash1.full != replayHash2.full)
+        {
+            fmt::print("The replayed states diverge at frame {}:\n", frame);
+            PrintStateDiff(playback1.GetRollbackManager(), playback2.GetRollbackManager());
+            return 0;
+        }
+    }
+    fmt::print("The replayed states agree up to frame {}, the recorded states diverged without a difference in the inputs\n",
+        divergentFrame);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <string>
+
+#include "network/match_host.h"
+
+int main(int argc, char** argv)
+{
+    unsigned short port = 0;
+    std::size_t workerCount = 0;
+    int playerCount = 0;
+    if (argc >= 2)
+    {
+        std::string portArg = argv[1];
+        port = std::stoi(portArg);
+    }
+    if (argc >= 3)
+    {
+        std::string workerArg = argv[2];
+        workerCount = std::stoul(workerArg);
+    }
+    if (argc >= 4)
+    {
+        std::string playerCountArg = argv[3];
+        playerCount = std::stoi(playerCountArg);
+    }
+    game::MatchHost host(workerCount);
+    if (port != 0)
+    {
+        host.SetPort(port);
+    }
+    if (playerCount > 0 && playerCount <= static_cast<int>(game::maxPlayerNmb))
+    {
+        host.SetPlayerCount(static_cast<game::PlayerNumber>(playerCount));
+    }
+    if (argc >= 5)
+    {
+        host.SetReplayDirectory(argv[4]);
+    }
+    host.Init();
+    host.Run();
+    host.Destroy();
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "game/game_manager.h"
+#include "game/match_playback.h"
+#include "game/match_replay.h"
+
+/**
+ * \brief Plays a match replay recorded by the server headless and as fast as possible, one validation per frame
+ * like the server, and reports the frames per second and the final state hash.
+ * Given an expected hash, it fails if the replayed match ends in another state, so the replays form a regression corpus.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fmt::print("Usage: replay <replay> [expected state hash]\n");
+        return 1;
+    }
+    game::MatchReplayReader replay;
+    if (!replay.Open(argv[1]))
+    {
+        fmt::print("Could not open the replay {}\n", argv[1]);
+        return 1;
+    }
+    const auto playerCount = replay.GetPlayerCount();
+    if (replay.GetFrameCount() == 0 || replay.GetFirstFrame() != 1)
+    {
+        fmt::print("The replay does not start at the first frame of the match\n");
+        return 1;
+    }
+
+    game::MatchPlayback playback(replay);
+    const auto start = std::chrono::steady_clock::now();
+    playback.Play();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto frameCount = replay.GetFrameCount();
+    const auto framesPerSecond = static_cast<double>(frameCount) / seconds;
+    fmt::print("{} players, {} frames ({:.1f} min of match) in {:.3f} s\n", playerCount, frameCount,
+        static_cast<double>(frameCount) * game::GameManager::FixedPeriod / 60.0, seconds);
+    fmt::print("{:.0f} frames/s, {:.1f}x real time\n", framesPerSecond, framesPerSecond * game::GameManager::FixedPeriod);
+    if (playback.GetWinner() != game::INVALID_PLAYER)
+    {
+        fmt::print("P{} won at frame {}\n", playback.GetWinner() + 1, playback.GetWinFrame());
+    }
+    const auto stateHash = playback.GetRollbackManager().GetValidateStateHash();
+    fmt::print("Final state hash: {:016x}\n", stateHash.full);
+
+    if (argc >= 3)
+    {
+        const auto expectedHash = std::stoull(argv[2], nullptr, 16);
+        if (expectedHash != stateHash.full)
+        {
+            fmt::print("The replay ends in another state than {:016x}\n", expectedHash);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,26 +1,38 @@
 #include <string>
 
 #include "network/network_server.h"
+#include "network/server_tick_scheduler.h"
 
 int main(int argc, char** argv)
 {
     unsigned short port = 0;
-    if (argc == 2)
+    int playerCount = 0;
+    if (argc >= 2)
     {
         std::string portArg = argv[1];
         port = std::stoi(portArg);
     }
+    if (argc >= 3)
+    {
+        std::string playerCountArg = argv[2];
+        playerCount = std::stoi(playerCountArg);
+    }
     game::ServerNetworkManager server;
+    //"hashes" also records the state hashes, making the replay a desync trace for desync_bisect
+    if (argc >= 4)
+    {
+        const bool stateHashes = argc >= 5 && std::string(argv[4]) == "hashes";
+        server.StartMatchReplay(argv[3], stateHashes ? game::MatchReplayWriter::STATE_HASHES : 0);
+    }
     if (port != 0)
     {
-        server.SetTcpPort(port);
+        server.SetPort(port);
     }
-    server.Init();
-    sf::Clock clock;
-    while (server.IsOpen())
+    if (playerCount > 0 && playerCount <= static_cast<int>(game::maxPlayerNmb))
     {
-        const auto dt = clock.restart();
-        server.Update(dt);
+        server.SetPlayerCount(static_cast<game::PlayerNumber>(playerCount));
     }
+    game::ServerTickScheduler scheduler;
+    scheduler.Run(server);
     return 0;
 }